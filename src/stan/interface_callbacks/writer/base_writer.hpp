@@ -86,6 +86,31 @@ namespace stan {
          */
         virtual void operator()(const std::vector<double>& state) = 0;
 
+        /**
+         * Writes rows of values, as if each row were written as a
+         * set of values.
+         *
+         * The default implementation copies each row into a
+         * std::vector and writes it.  Writers that can take a block
+         * of rows at once should override it.  A derived writer that
+         * overrides other overloads of operator() hides this one; it
+         * should add <code>using base_writer::operator();</code> to
+         * keep it callable on the derived type.
+         *
+         * @param[in] values A double array of n_rows rows of n_cols
+         *   values each, stored in row major order
+         * @param[in] n_rows Rows
+         * @param[in] n_cols Columns
+         */
+        virtual void operator()(const double* values,
+                                int n_rows, int n_cols) {
+          std::vector<double> state(n_cols);
+          for (int i = 0; i < n_rows; ++i) {
+            state.assign(values + i * n_cols, values + (i + 1) * n_cols);
+            (*this)(state);
+          }
+        }
+
         /**
          * Writes blank input.
          */
@@ -0,0 +1,197 @@
+#ifndef STAN_INTERFACE_CALLBACKS_WRITER_BINARY_WRITER_HPP
+#define STAN_INTERFACE_CALLBACKS_WRITER_BINARY_WRITER_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/io/stan_binary_format.hpp>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace interface_callbacks {
+    namespace writer {
+
+      /**
+       * binary_writer writes to an std::ostream in the binary format
+       * described in stan/io/stan_binary_format.hpp, which is read
+       * back by stan::io::stan_binary_reader.
+       *
+       * Messages, key value pairs and names are written as records
+       * in the order they are received, so the file holds everything
+       * stream_writer would write.  Rows of values are buffered and
+       * written as blocks of up to chunk_rows rows, stored column by
+       * column.  A block is written when it is full, before any other
+       * record, when the length of the rows changes, on flush and on
+       * destruction.
+       *
+       * The output stream must be opened in binary mode.
+       */
+      class binary_writer : public base_writer {
+      public:
+        /**
+         * Constructor.  Writes the file header.
+         *
+         * @param output std::ostream to write to
+         * @param chunk_rows largest number of rows in a block
+         * @throw std::invalid_argument if chunk_rows is not positive
+         */
+        explicit binary_writer(std::ostream& output, int chunk_rows = 1024)
+          : output__(output), chunk_rows__(chunk_rows),
+            n_rows__(0), n_cols__(0) {
+          if (chunk_rows < 1)
+            throw std::invalid_argument("binary_writer: chunk_rows must "
+                                        "be positive");
+          namespace format = stan::io::stan_binary;
+          format::write_bytes(output__, format::MAGIC,
+                              sizeof(format::MAGIC));
+          format::write_uint(output__, format::VERSION);
+        }
+
+        ~binary_writer() {
+          try {
+            flush();
+          } catch (...) { }
+        }
+
+        void operator()(const std::string& key, double value) {
+          namespace format = stan::io::stan_binary;
+          begin_record_(format::KEY_DOUBLE);
+          format::write_string(output__, key);
+          format::write_doubles(output__, &value, 1);
+        }
+
+        void operator()(const std::string& key, int value) {
+          namespace format = stan::io::stan_binary;
+          begin_record_(format::KEY_INT);
+          format::write_string(output__, key);
+          format::write_int(output__, value);
+        }
+
+        void operator()(const std::string& key, const std::string& value) {
+          namespace format = stan::io::stan_binary;
+          begin_record_(format::KEY_STRING);
+          format::write_string(output__, key);
+          format::write_string(output__, value);
+        }
+
+        void operator()(const std::string& key,
+                        const double* values,
+                        int n_values) {
+          if (n_values == 0) return;
+
+          namespace format = stan::io::stan_binary;
+          begin_record_(format::KEY_VECTOR);
+          format::write_string(output__, key);
+          format::write_uint(output__, n_values);
+          format::write_doubles(output__, values, n_values);
+        }
+
+        void operator()(const std::string& key,
+                        const double* values,
+                        int n_rows, int n_cols) {
+          if (n_rows == 0 || n_cols == 0) return;
+
+          namespace format = stan::io::stan_binary;
+          begin_record_(format::KEY_MATRIX);
+          format::write_string(output__, key);
+          format::write_uint(output__, n_rows);
+          format::write_uint(output__, n_cols);
+          format::write_doubles(output__, values, n_rows * n_cols);
+        }
+
+        void operator()(const std::vector<std::string>& names) {
+          if (names.empty()) return;
+
+          namespace format = stan::io::stan_binary;
+          begin_record_(format::NAMES);
+          format::write_uint(output__, names.size());
+          for (size_t n = 0; n < names.size(); ++n)
+            format::write_string(output__, names[n]);
+        }
+
+        void operator()(const std::vector<double>& state) {
+          if (state.empty()) return;
+
+          add_row_(&state[0], state.size());
+        }
+
+        void operator()(const double* values, int n_rows, int n_cols) {
+          if (n_cols == 0) return;
+
+          for (int i = 0; i < n_rows; ++i)
+            add_row_(values + i * n_cols, n_cols);
+        }
+
+        void operator()() {
+          (*this)(std::string());
+        }
+
+        void operator()(const std::string& message) {
+          namespace format = stan::io::stan_binary;
+          begin_record_(format::MESSAGE);
+          format::write_string(output__, message);
+        }
+
+        /**
+         * Writes the buffered rows and flushes the stream.
+         */
+        void flush() {
+          write_block_();
+          output__.flush();
+        }
+
+      private:
+        std::ostream& output__;
+        int chunk_rows__;
+
+        // Buffered rows, column major with chunk_rows__ rows
+        std::vector<double> block__;
+        int n_rows__;
+        int n_cols__;
+
+        void add_row_(const double* values, int n_cols) {
+          if (n_rows__ > 0 && n_cols != n_cols__)
+            write_block_();
+          if (n_rows__ == 0) {
+            n_cols__ = n_cols;
+            if (block__.size() < static_cast<size_t>(n_cols)
+                * chunk_rows__)
+              block__.resize(static_cast<size_t>(n_cols) * chunk_rows__);
+          }
+
+          for (int col = 0; col < n_cols; ++col)
+            block__[col * chunk_rows__ + n_rows__] = values[col];
+
+          if (++n_rows__ == chunk_rows__)
+            write_block_();
+        }
+
+        void begin_record_(stan::io::stan_binary::record_tag tag) {
+          write_block_();
+          unsigned char byte = tag;
+          stan::io::stan_binary::write_bytes(output__, &byte, 1);
+        }
+
+        void write_block_() {
+          if (n_rows__ == 0) return;
+
+          namespace format = stan::io::stan_binary;
+          int n_rows = n_rows__;
+          n_rows__ = 0;
+
+          unsigned char byte = format::DRAWS;
+          format::write_bytes(output__, &byte, 1);
+          format::write_uint(output__, n_rows);
+          format::write_uint(output__, n_cols__);
+          for (int col = 0; col < n_cols__; ++col)
+            format::write_doubles(output__, &block__[col * chunk_rows__],
+                                  n_rows);
+        }
+      };
+
+    }
+  }
+}
+
+#endif
@@ -28,6 +28,7 @@ namespace stan {
                         int n_rows, int n_cols) {}
         void operator()(const std::vector<std::string>& names) {}
         void operator()(const std::vector<double>& state) {}
+        void operator()(const double* values, int n_rows, int n_cols) {}
         void operator()() {}
         void operator()(const std::string& message) {}
       };
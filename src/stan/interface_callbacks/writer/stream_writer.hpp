@@ -2,6 +2,8 @@
 #define STAN_INTERFACE_CALLBACKS_WRITER_STREAM_WRITER_HPP
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <cstdio>
+#include <locale>
 #include <ostream>
 #include <vector>
 #include <string>
@@ -12,6 +14,13 @@ namespace stan {
 
       /**
        * stream_writer writes to an std::ostream.
+       *
+       * Rows of values are formatted into a buffer that is reused
+       * from row to row and handed to the stream with a single write.
+       * The text is the same as the stream's operator<< writes, using
+       * the stream's precision.  Rows end in a newline without
+       * flushing the stream; it is flushed every flush_rows rows, if
+       * flush_rows is positive, and by flush.
        */
       class stream_writer : public base_writer {
       public:
@@ -21,10 +30,14 @@ namespace stan {
          * @param output std::ostream to write to
          * @param key_value_prefix String to write before lines
          *   treated as comments.
+         * @param flush_rows Number of rows of values between flushes
+         *   of the stream, or 0 to leave flushing to the stream.
          */
         stream_writer(std::ostream& output,
-                      const std::string& key_value_prefix = ""):
-          output__(output), key_value_prefix__(key_value_prefix) {}
+                      const std::string& key_value_prefix = "",
+                      int flush_rows = 0):
+          output__(output), key_value_prefix__(key_value_prefix),
+          flush_rows__(flush_rows), n_rows__(0) {}
 
         void operator()(const std::string& key, double value) {
           output__ << key_value_prefix__ << key << " = " << value << std::endl;
@@ -81,13 +94,14 @@ namespace stan {
         void operator()(const std::vector<double>& state) {
           if (state.empty()) return;
 
-          std::vector<double>::const_iterator last = state.end();
-          --last;
+          write_row_(&state[0], state.size());
+        }
 
-          for (std::vector<double>::const_iterator it = state.begin();
-               it != last; ++it)
-            output__ << *it << ",";
-          output__ << state.back() << std::endl;
+        void operator()(const double* values, int n_rows, int n_cols) {
+          if (n_cols == 0) return;
+
+          for (int i = 0; i < n_rows; ++i)
+            write_row_(values + i * n_cols, n_cols);
         }
 
         void operator()() {
@@ -98,9 +112,64 @@ namespace stan {
           output__ << key_value_prefix__ << message << std::endl;
         }
 
+        /**
+         * Flushes the stream.
+         */
+        void flush() {
+          n_rows__ = 0;
+          output__.flush();
+        }
+
       private:
         std::ostream& output__;
         std::string key_value_prefix__;
+        int flush_rows__;
+        int n_rows__;
+        std::string row__;
+
+        void write_row_(const double* values, int n_values) {
+          if (default_format_()) {
+            row__.clear();
+            for (int n = 0; n < n_values; ++n) {
+              if (n > 0)
+                row__ += ',';
+              append_(values[n]);
+            }
+            row__ += '\n';
+            output__.write(row__.data(), row__.size());
+          } else {
+            for (int n = 0; n < n_values - 1; ++n)
+              output__ << values[n] << ",";
+            output__ << values[n_values - 1] << '\n';
+          }
+
+          if (flush_rows__ > 0 && ++n_rows__ == flush_rows__) {
+            n_rows__ = 0;
+            output__.flush();
+          }
+        }
+
+        /**
+         * Returns true if the stream formats doubles the way
+         * append_ does: no format flags, width or locale that would
+         * change the text from printf's %g.
+         */
+        bool default_format_() const {
+          return (output__.flags()
+                  & (std::ios_base::floatfield | std::ios_base::showpos
+                     | std::ios_base::showpoint | std::ios_base::uppercase))
+                   == 0
+            && output__.width() == 0
+            && output__.precision() <= 40
+            && output__.getloc() == std::locale::classic();
+        }
+
+        void append_(double x) {
+          char buffer[64];
+          int n = std::sprintf(buffer, "%.*g",
+                               static_cast<int>(output__.precision()), x);
+          row__.append(buffer, n);
+        }
       };
 
     }
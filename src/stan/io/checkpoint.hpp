@@ -0,0 +1,237 @@
+#ifndef STAN_IO_CHECKPOINT_HPP
+#define STAN_IO_CHECKPOINT_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <boost/cstdint.hpp>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace stan {
+  namespace io {
+
+    // Leading bytes of every checkpoint
+    static const char CHECKPOINT_MAGIC[8]
+      = { 's', 't', 'a', 'n', 'c', 'k', 'p', 't' };
+
+    // Incremented whenever the layout of a checkpoint changes
+    static const boost::uint32_t CHECKPOINT_VERSION = 4;
+
+    /**
+     * Writes sampler state to a binary stream.
+     *
+     * Values are written with their in-memory representation, so a
+     * checkpoint can only be read back on a platform with the same
+     * byte order and floating point format.  Every object that saves
+     * its state starts a named section so that a checkpoint read into
+     * the wrong kind of sampler fails instead of restoring garbage.
+     */
+    class checkpoint_writer {
+    public:
+      /**
+       * Construct a writer and write the checkpoint header.
+       *
+       * @param o binary output stream
+       */
+      explicit checkpoint_writer(std::ostream& o)
+        : o_(o) {
+        o_.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        write(CHECKPOINT_VERSION);
+      }
+
+      void begin_section(const std::string& name) {
+        write(name);
+      }
+
+      void write(bool x) {
+        char c = x ? 1 : 0;
+        write_bytes_(&c, 1);
+      }
+
+      void write(boost::uint32_t x) {
+        write_bytes_(&x, sizeof(x));
+      }
+
+      void write(int x) {
+        write(static_cast<boost::uint32_t>(x));
+      }
+
+      void write(double x) {
+        write_bytes_(&x, sizeof(x));
+      }
+
+      void write(const std::string& x) {
+        write(static_cast<boost::uint32_t>(x.size()));
+        if (!x.empty())
+          write_bytes_(x.data(), x.size());
+      }
+
+      void write(const Eigen::VectorXd& x) {
+        write(static_cast<boost::uint32_t>(x.size()));
+        if (x.size() > 0)
+          write_bytes_(x.data(), x.size() * sizeof(double));
+      }
+
+      void write(const Eigen::MatrixXd& x) {
+        write(static_cast<boost::uint32_t>(x.rows()));
+        write(static_cast<boost::uint32_t>(x.cols()));
+        if (x.size() > 0)
+          write_bytes_(x.data(), x.size() * sizeof(double));
+      }
+
+      /**
+       * Write the state of a random number generator through its
+       * stream insertion operator.
+       *
+       * @tparam RNG Random number generator class
+       * @param rng random number generator
+       */
+      template <class RNG>
+      void write_rng(const RNG& rng) {
+        std::stringstream ss;
+        ss << rng;
+        write(ss.str());
+      }
+
+    private:
+      std::ostream& o_;
+
+      void write_bytes_(const void* x, size_t n) {
+        o_.write(static_cast<const char*>(x), n);
+        if (!o_)
+          throw std::runtime_error("Failed to write checkpoint");
+      }
+    };
+
+    /**
+     * Reads sampler state written by checkpoint_writer.
+     *
+     * Vectors and matrices are read into existing objects and must
+     * have the size those objects already have, so that a checkpoint
+     * from a different model is rejected.
+     */
+    class checkpoint_reader {
+    public:
+      /**
+       * Construct a reader and validate the checkpoint header.
+       *
+       * @param i binary input stream
+       * @throw std::runtime_error if the stream does not start with
+       * a checkpoint of the current version
+       */
+      explicit checkpoint_reader(std::istream& i)
+        : i_(i) {
+        char magic[sizeof(CHECKPOINT_MAGIC)];
+        read_bytes_(magic, sizeof(magic));
+        if (std::string(magic, sizeof(magic))
+            != std::string(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)))
+          throw std::runtime_error("Stream does not contain a checkpoint");
+
+        boost::uint32_t version = read_uint_();
+        if (version != CHECKPOINT_VERSION) {
+          std::stringstream msg;
+          msg << "Checkpoint version " << version
+              << " is not supported, expected " << CHECKPOINT_VERSION;
+          throw std::runtime_error(msg.str());
+        }
+      }
+
+      /**
+       * Read the name of the next section.
+       *
+       * @param name expected name
+       * @throw std::runtime_error if the next section has another name
+       */
+      void begin_section(const std::string& name) {
+        std::string found;
+        read(found);
+        if (found != name)
+          throw std::runtime_error("Checkpoint holds " + found
+                                   + " state where " + name
+                                   + " state was expected");
+      }
+
+      void read(bool& x) {
+        char c;
+        read_bytes_(&c, 1);
+        x = c != 0;
+      }
+
+      void read(unsigned int& x) {
+        x = read_uint_();
+      }
+
+      void read(int& x) {
+        x = static_cast<int>(read_uint_());
+      }
+
+      void read(double& x) {
+        read_bytes_(&x, sizeof(x));
+      }
+
+      void read(std::string& x) {
+        boost::uint32_t n = read_uint_();
+        x.resize(n);
+        if (n > 0)
+          read_bytes_(&x[0], n);
+      }
+
+      void read(Eigen::VectorXd& x) {
+        boost::uint32_t n = read_uint_();
+        if (static_cast<int>(n) != x.size())
+          throw std::runtime_error("Checkpoint does not match the "
+                                   "dimension of the sampler");
+        if (n > 0)
+          read_bytes_(x.data(), n * sizeof(double));
+      }
+
+      void read(Eigen::MatrixXd& x) {
+        boost::uint32_t rows = read_uint_();
+        boost::uint32_t cols = read_uint_();
+        if (static_cast<int>(rows) != x.rows()
+            || static_cast<int>(cols) != x.cols())
+          throw std::runtime_error("Checkpoint does not match the "
+                                   "dimension of the sampler");
+        if (x.size() > 0)
+          read_bytes_(x.data(), x.size() * sizeof(double));
+      }
+
+      /**
+       * Restore the state of a random number generator through its
+       * stream extraction operator.
+       *
+       * @tparam RNG Random number generator class
+       * @param[out] rng random number generator
+       */
+      template <class RNG>
+      void read_rng(RNG& rng) {
+        std::string state;
+        read(state);
+        std::stringstream ss(state);
+        ss >> rng;
+        if (ss.fail())
+          throw std::runtime_error("Failed to restore the random number "
+                                   "generator from checkpoint");
+      }
+
+    private:
+      std::istream& i_;
+
+      boost::uint32_t read_uint_() {
+        boost::uint32_t x;
+        read_bytes_(&x, sizeof(x));
+        return x;
+      }
+
+      void read_bytes_(void* x, size_t n) {
+        i_.read(static_cast<char*>(x), n);
+        if (static_cast<size_t>(i_.gcount()) != n)
+          throw std::runtime_error("Checkpoint is truncated");
+      }
+    };
+
+  }  // io
+}  // stan
+#endif
@@ -0,0 +1,165 @@
+#ifndef STAN_IO_STAN_BINARY_FORMAT_HPP
+#define STAN_IO_STAN_BINARY_FORMAT_HPP
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace stan {
+  namespace io {
+
+    /**
+     * Layout of the binary output written by binary_writer and read
+     * by stan_binary_reader.
+     *
+     * A file starts with MAGIC and the format version VERSION,
+     * followed by records in the order the writer received them.
+     * Every record starts with a one byte tag.  Integers are
+     * little-endian 32 bit, doubles are little-endian IEEE 754 and
+     * strings are a length followed by their bytes.
+     *
+     * <pre>
+     * MESSAGE       string message
+     * KEY_DOUBLE    string key, double value
+     * KEY_INT       string key, int value
+     * KEY_STRING    string key, string value
+     * KEY_VECTOR    string key, int n, n doubles
+     * KEY_MATRIX    string key, int rows, int cols, rows * cols doubles
+     * NAMES         int n, n strings
+     * DRAWS         int rows, int cols, then each column as rows doubles
+     * </pre>
+     *
+     * Draws are stored in blocks of consecutive rows with the values
+     * of each column contiguous, so a block can be read straight into
+     * a column major matrix.
+     */
+    namespace stan_binary {
+
+      BOOST_STATIC_ASSERT(std::numeric_limits<double>::is_iec559);
+      BOOST_STATIC_ASSERT(sizeof(double) == 8);
+
+      // Leading bytes of every file
+      static const char MAGIC[8]
+        = { 's', 't', 'a', 'n', 'd', 'r', 'w', 's' };
+
+      // Incremented whenever the layout of the file changes
+      static const boost::uint32_t VERSION = 1;
+
+      enum record_tag {
+        MESSAGE = 1,
+        KEY_DOUBLE = 2,
+        KEY_INT = 3,
+        KEY_STRING = 4,
+        KEY_VECTOR = 5,
+        KEY_MATRIX = 6,
+        NAMES = 7,
+        DRAWS = 8
+      };
+
+      inline bool little_endian_host() {
+        const boost::uint32_t one = 1;
+        return *reinterpret_cast<const unsigned char*>(&one) == 1;
+      }
+
+      inline void write_bytes(std::ostream& o, const void* x, size_t n) {
+        o.write(static_cast<const char*>(x), n);
+        if (!o)
+          throw std::runtime_error("Failed to write binary output");
+      }
+
+      inline void read_bytes(std::istream& i, void* x, size_t n) {
+        i.read(static_cast<char*>(x), n);
+        if (static_cast<size_t>(i.gcount()) != n)
+          throw std::runtime_error("Binary output ends in the middle "
+                                   "of a record");
+      }
+
+      inline void write_uint(std::ostream& o, boost::uint32_t x) {
+        unsigned char bytes[4];
+        for (int n = 0; n < 4; ++n)
+          bytes[n] = static_cast<unsigned char>((x >> (8 * n)) & 0xff);
+        write_bytes(o, bytes, 4);
+      }
+
+      inline boost::uint32_t read_uint(std::istream& i) {
+        unsigned char bytes[4];
+        read_bytes(i, bytes, 4);
+        boost::uint32_t x = 0;
+        for (int n = 3; n >= 0; --n)
+          x = (x << 8) | bytes[n];
+        return x;
+      }
+
+      inline void write_int(std::ostream& o, int x) {
+        write_uint(o, static_cast<boost::uint32_t>(x));
+      }
+
+      inline int read_int(std::istream& i) {
+        boost::uint32_t x = read_uint(i);
+        if (x <= static_cast<boost::uint32_t>
+            (std::numeric_limits<int>::max()))
+          return static_cast<int>(x);
+        return -static_cast<int>(~x) - 1;
+      }
+
+      inline void write_string(std::ostream& o, const std::string& x) {
+        write_uint(o, x.size());
+        if (!x.empty())
+          write_bytes(o, x.data(), x.size());
+      }
+
+      inline std::string read_string(std::istream& i) {
+        boost::uint32_t n = read_uint(i);
+        std::string x(n, ' ');
+        if (n > 0)
+          read_bytes(i, &x[0], n);
+        return x;
+      }
+
+      /**
+       * Writes an array of doubles.  On a little-endian host the
+       * array is written with a single call.
+       */
+      inline void write_doubles(std::ostream& o, const double* x, size_t n) {
+        if (little_endian_host()) {
+          if (n > 0)
+            write_bytes(o, x, n * sizeof(double));
+          return;
+        }
+        for (size_t k = 0; k < n; ++k) {
+          unsigned char bytes[sizeof(double)];
+          std::memcpy(bytes, &x[k], sizeof(double));
+          for (size_t b = 0; b < sizeof(double) / 2; ++b)
+            std::swap(bytes[b], bytes[sizeof(double) - 1 - b]);
+          write_bytes(o, bytes, sizeof(double));
+        }
+      }
+
+      /**
+       * Reads an array of doubles into memory the caller owns.  On a
+       * little-endian host the bytes are read straight into it.
+       */
+      inline void read_doubles(std::istream& i, double* x, size_t n) {
+        if (n > 0)
+          read_bytes(i, x, n * sizeof(double));
+        if (little_endian_host())
+          return;
+        for (size_t k = 0; k < n; ++k) {
+          unsigned char* bytes = reinterpret_cast<unsigned char*>(&x[k]);
+          for (size_t b = 0; b < sizeof(double) / 2; ++b)
+            std::swap(bytes[b], bytes[sizeof(double) - 1 - b]);
+        }
+      }
+
+    }
+
+  }
+}
+
+#endif
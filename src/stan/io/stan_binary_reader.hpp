@@ -0,0 +1,247 @@
+#ifndef STAN_IO_STAN_BINARY_READER_HPP
+#define STAN_IO_STAN_BINARY_READER_HPP
+
+#include <stan/io/stan_binary_format.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <boost/lexical_cast.hpp>
+#include <Eigen/Dense>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace io {
+
+    /**
+     * Reads output written by
+     * stan::interface_callbacks::writer::binary_writer into the same
+     * stan_csv structure as stan_csv_reader, so it can be loaded into
+     * stan::mcmc::chains.
+     *
+     * Records other than names and draws are turned back into the
+     * comment lines stream_writer would have written and parsed by
+     * stan_csv_reader, so the metadata, adaptation and timing are
+     * read exactly as they are from a csv file.  The draws are never
+     * formatted: the reader first walks the file to find the blocks
+     * of draws, then sizes the sample matrix once and reads every
+     * block's columns straight into it.
+     */
+    class stan_binary_reader {
+    public:
+      stan_binary_reader() {}
+      ~stan_binary_reader() {}
+
+      /**
+       * Parses the file.
+       *
+       * @param[in] in seekable input stream to parse, opened in
+       *   binary mode
+       * @param[out] out output stream to send messages
+       * @throw std::invalid_argument if the stream does not hold
+       *   binary output with a header
+       * @throw std::runtime_error if the stream ends in the middle of
+       *   a record
+       */
+      static stan_csv parse(std::istream& in, std::ostream* out) {
+        namespace format = stan::io::stan_binary;
+        stan_csv data;
+
+        char magic[sizeof(format::MAGIC)];
+        in.read(magic, sizeof(magic));
+        if (in.gcount() != static_cast<std::streamsize>(sizeof(magic))
+            || std::string(magic, sizeof(magic))
+               != std::string(format::MAGIC, sizeof(format::MAGIC)))
+          throw std::invalid_argument("Input is not Stan binary output");
+        boost::uint32_t version = format::read_uint(in);
+        if (version != format::VERSION) {
+          std::stringstream msg;
+          msg << "Stan binary output version " << version
+              << " is not supported, expected " << format::VERSION;
+          throw std::invalid_argument(msg.str());
+        }
+
+        std::stringstream metadata;
+        std::stringstream adaptation;
+        std::stringstream trailer;
+        std::string names;
+        bool has_header = false;
+
+        std::vector<std::streampos> block_pos;
+        std::vector<int> block_rows;
+        int rows = 0;
+        int cols = -1;
+        bool samples_ok = true;
+
+        for (int tag = in.get(); tag != std::istream::traits_type::eof();
+             tag = in.get()) {
+          if (tag == format::NAMES) {
+            if (has_header)
+              throw std::invalid_argument("Stan binary output has more "
+                                          "than one header");
+            boost::uint32_t n = format::read_uint(in);
+            for (boost::uint32_t k = 0; k < n; ++k) {
+              if (k > 0)
+                names += ",";
+              names += format::read_string(in);
+            }
+            has_header = true;
+          } else if (tag == format::DRAWS) {
+            int block = format::read_uint(in);
+            int current_cols = format::read_uint(in);
+            std::streampos pos = in.tellg();
+            if (pos == std::streampos(-1))
+              throw std::invalid_argument("Stan binary output must be "
+                                          "read from a seekable stream");
+            if (cols == -1) {
+              cols = current_cols;
+            } else if (cols != current_cols && samples_ok) {
+              if (out)
+                *out << "Error: expected " << cols << " columns, but found "
+                     << current_cols << " instead for row " << rows + 1
+                     << std::endl;
+              samples_ok = false;
+            }
+            block_pos.push_back(pos);
+            block_rows.push_back(block);
+            rows += block;
+            in.seekg(static_cast<std::streamoff>(block) * current_cols
+                     * sizeof(double), std::ios_base::cur);
+          } else {
+            std::stringstream& text
+              = !has_header ? metadata
+                : block_pos.empty() ? adaptation : trailer;
+            write_comment_(in, tag, text);
+          }
+        }
+        in.clear();
+
+        if (!stan_csv_reader::read_metadata(metadata, data.metadata, out)) {
+          if (out)
+            *out << "Warning: non-fatal error reading metadata" << std::endl;
+        }
+
+        std::stringstream header(names);
+        if (!has_header
+            || !stan_csv_reader::read_header(header, data.header, out)) {
+          if (out)
+            *out << "Error: error reading header" << std::endl;
+          throw std::invalid_argument
+            ("Error with header of input file in parse");
+        }
+
+        if (!stan_csv_reader::read_adaptation(adaptation, data.adaptation,
+                                              out)) {
+          if (out)
+            *out << "Warning: non-fatal error reading adapation data"
+                 << std::endl;
+        }
+
+        data.timing.warmup = 0;
+        data.timing.sampling = 0;
+        read_timing_(trailer, data.timing);
+
+        if (!samples_ok || block_pos.empty()) {
+          if (out)
+            *out << "Warning: non-fatal error reading samples" << std::endl;
+          return data;
+        }
+
+        data.samples.resize(rows, cols);
+        int row = 0;
+        for (size_t b = 0; b < block_pos.size(); ++b) {
+          in.seekg(block_pos[b]);
+          for (int col = 0; col < cols; ++col)
+            format::read_doubles(in, &data.samples(row, col), block_rows[b]);
+          row += block_rows[b];
+        }
+
+        return data;
+      }
+
+    private:
+      /**
+       * Reads a record other than names or draws and writes it as the
+       * lines stream_writer writes for it with a "# " prefix.
+       */
+      static void write_comment_(std::istream& in, int tag,
+                                 std::ostream& text) {
+        namespace format = stan::io::stan_binary;
+        const std::string prefix("# ");
+
+        if (tag == format::MESSAGE) {
+          text << prefix << format::read_string(in) << std::endl;
+        } else if (tag == format::KEY_DOUBLE) {
+          std::string key = format::read_string(in);
+          double value;
+          format::read_doubles(in, &value, 1);
+          text << prefix << key << " = " << value << std::endl;
+        } else if (tag == format::KEY_INT) {
+          std::string key = format::read_string(in);
+          text << prefix << key << " = " << format::read_int(in)
+               << std::endl;
+        } else if (tag == format::KEY_STRING) {
+          std::string key = format::read_string(in);
+          text << prefix << key << " = " << format::read_string(in)
+               << std::endl;
+        } else if (tag == format::KEY_VECTOR) {
+          std::string key = format::read_string(in);
+          std::vector<double> values(format::read_uint(in));
+          if (values.empty())
+            return;
+          format::read_doubles(in, &values[0], values.size());
+          text << prefix << key << ": " << values[0];
+          for (size_t n = 1; n < values.size(); ++n)
+            text << "," << values[n];
+          text << std::endl;
+        } else if (tag == format::KEY_MATRIX) {
+          std::string key = format::read_string(in);
+          int n_rows = format::read_uint(in);
+          int n_cols = format::read_uint(in);
+          std::vector<double> values(n_rows * n_cols);
+          if (values.empty())
+            return;
+          format::read_doubles(in, &values[0], values.size());
+          text << prefix << key << std::endl;
+          for (int i = 0; i < n_rows; ++i) {
+            text << prefix << values[i * n_cols];
+            for (int j = 1; j < n_cols; ++j)
+              text << "," << values[i * n_cols + j];
+            text << std::endl;
+          }
+        } else {
+          std::stringstream msg;
+          msg << "Stan binary output has a record with unknown tag " << tag;
+          throw std::invalid_argument(msg.str());
+        }
+      }
+
+      /**
+       * Adds up the elapsed times written by mcmc_writer::write_timing
+       * the same way stan_csv_reader::read_samples does.
+       */
+      static void read_timing_(std::istream& in, stan_csv_timing& timing) {
+        std::string line;
+        while (std::getline(in, line)) {
+          if (line.find("(Warm-up)") != std::string::npos) {
+            int left = 17;
+            int right = line.find(" seconds");
+            timing.warmup
+              += boost::lexical_cast<double>(line.substr(left, right - left));
+          } else if (line.find("(Sampling)") != std::string::npos) {
+            int left = 17;
+            int right = line.find(" seconds");
+            timing.sampling
+              += boost::lexical_cast<double>(line.substr(left, right - left));
+          }
+        }
+      }
+    };
+
+  }  // io
+
+}  // stan
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef STAN_MCMC_BASE_ADAPTATION_HPP
 #define STAN_MCMC_BASE_ADAPTATION_HPP
 
+#include <stan/io/checkpoint.hpp>
+
 namespace stan {
 
   namespace mcmc {
@@ -8,6 +10,10 @@ namespace stan {
     class base_adaptation {
     public:
       virtual void restart() {}
+
+      virtual void save_state(io::checkpoint_writer& checkpoint) {}
+
+      virtual void load_state(io::checkpoint_reader& checkpoint) {}
     };
 
   }  // mcmc
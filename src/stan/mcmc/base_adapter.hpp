@@ -1,6 +1,8 @@
 #ifndef STAN_MCMC_BASE_ADAPTER_HPP
 #define STAN_MCMC_BASE_ADAPTER_HPP
 
+#include <stan/io/checkpoint.hpp>
+
 namespace stan {
   namespace mcmc {
 
@@ -21,6 +23,44 @@ namespace stan {
         return adapt_flag_;
       }
 
+      /**
+       * Returns true once an adaptive warmup schedule has run its
+       * course.  Adapters without such a schedule never finish on
+       * their own.
+       */
+      virtual bool adaptation_complete() {
+        return false;
+      }
+
+      /**
+       * Returns the largest number of warmup iterations an adaptive
+       * warmup schedule may run, or zero if the length of warmup is
+       * fixed.
+       */
+      virtual unsigned int max_num_warmup() {
+        return 0;
+      }
+
+      /**
+       * Writes the state of the adaptation to a checkpoint.
+       *
+       * @param checkpoint checkpoint writer
+       */
+      virtual void save_adaptation_state(io::checkpoint_writer& checkpoint) {
+        checkpoint.begin_section("adapter");
+        checkpoint.write(adapt_flag_);
+      }
+
+      /**
+       * Restores the state written by save_adaptation_state.
+       *
+       * @param checkpoint checkpoint reader
+       */
+      virtual void load_adaptation_state(io::checkpoint_reader& checkpoint) {
+        checkpoint.begin_section("adapter");
+        checkpoint.read(adapt_flag_);
+      }
+
     protected:
       bool adapt_flag_;
     };
@@ -2,6 +2,7 @@
 #define STAN_MCMC_BASE_MCMC_HPP
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/io/checkpoint.hpp>
 #include <stan/mcmc/sample.hpp>
 #include <ostream>
 #include <string>
@@ -33,6 +34,21 @@ namespace stan {
                                    std::vector<std::string>& names) {}
 
       virtual void get_sampler_diagnostics(std::vector<double>& values) {}
+
+      /**
+       * Writes everything the sampler needs to continue a run
+       * exactly where it left off.
+       *
+       * @param checkpoint checkpoint writer
+       */
+      virtual void save_state(io::checkpoint_writer& checkpoint) {}
+
+      /**
+       * Restores the state written by save_state.
+       *
+       * @param checkpoint checkpoint reader
+       */
+      virtual void load_state(io::checkpoint_reader& checkpoint) {}
     };
 
   }  // mcmc
@@ -0,0 +1,322 @@
+#ifndef STAN_MCMC_BLOCK_ADAPTATION_HPP
+#define STAN_MCMC_BLOCK_ADAPTATION_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/mcmc/windowed_adaptation.hpp>
+#include <stan/mcmc/welford_checkpoint.hpp>
+#include <stan/math/prim/mat/fun/welford_covar_estimator.hpp>
+#include <stan/math/prim/mat/fun/welford_var_estimator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace stan {
+
+  namespace mcmc {
+
+    /**
+     * Windowed adaptation of a block diagonal inverse metric, with
+     * one covariance estimator per block so that memory and work
+     * grow with the size of the blocks rather than with the full
+     * dimension.  Blocks of a single parameter share one variance
+     * estimator, so the default partition, with every parameter in
+     * its own block, adapts like a diagonal metric.
+     *
+     * The blocks are either specified with set_blocks or detected
+     * from the draws of the first adaptation window: parameters
+     * whose correlation exceeds a threshold are merged into a block,
+     * strongest correlations first, as long as the block stays
+     * within a maximum size.  Detection needs a full covariance
+     * estimate over that window only.
+     */
+    class block_adaptation: public windowed_adaptation {
+    public:
+      explicit block_adaptation(int n)
+        : windowed_adaptation("block covariance"), num_params_(n),
+          diag_estimator_(0), detect_(false), threshold_(0),
+          max_block_size_(0), detector_(0) {
+        std::vector<std::vector<int> > blocks(n, std::vector<int>(1));
+        for (int i = 0; i < n; ++i)
+          blocks[i][0] = i;
+        set_blocks(blocks);
+      }
+
+      /**
+       * Sets the parameter groups of the blocks.
+       *
+       * @param blocks parameter indices of each block; every
+       * parameter must belong to exactly one block
+       * @throw std::invalid_argument if the blocks do not partition
+       * the parameters
+       */
+      void set_blocks(const std::vector<std::vector<int> >& blocks) {
+        std::vector<bool> seen(num_params_, false);
+        int count = 0;
+        for (size_t b = 0; b < blocks.size(); ++b) {
+          if (blocks[b].empty())
+            throw std::invalid_argument("The blocks of the metric must "
+                                        "partition the parameters");
+          for (size_t i = 0; i < blocks[b].size(); ++i) {
+            int idx = blocks[b][i];
+            if (idx < 0 || idx >= num_params_ || seen[idx])
+              throw std::invalid_argument("The blocks of the metric must "
+                                          "partition the parameters");
+            seen[idx] = true;
+            ++count;
+          }
+        }
+        if (count != num_params_)
+          throw std::invalid_argument("The blocks of the metric must "
+                                      "partition the parameters");
+
+        blocks_ = blocks;
+        diag_blocks_.clear();
+        dense_blocks_.clear();
+        estimators_.clear();
+        q_dense_.clear();
+        for (size_t b = 0; b < blocks_.size(); ++b) {
+          if (blocks_[b].size() == 1) {
+            diag_blocks_.push_back(b);
+          } else {
+            dense_blocks_.push_back(b);
+            estimators_.push_back(
+              stan::math::welford_covar_estimator(blocks_[b].size()));
+            q_dense_.push_back(Eigen::VectorXd(blocks_[b].size()));
+          }
+        }
+        diag_estimator_
+          = stan::math::welford_var_estimator(diag_blocks_.size());
+        q_diag_.resize(diag_blocks_.size());
+      }
+
+      const std::vector<std::vector<int> >& get_blocks() {
+        return blocks_;
+      }
+
+      /**
+       * Detects the blocks from the draws of the next adaptation
+       * window, replacing any blocks set before.
+       *
+       * @param threshold smallest absolute correlation that joins
+       * two parameters into a block, in (0, 1)
+       * @param max_block_size largest size of a detected block
+       */
+      void set_block_detection(double threshold, int max_block_size) {
+        detect_ = true;
+        threshold_ = threshold;
+        max_block_size_ = max_block_size;
+        detector_ = stan::math::welford_covar_estimator(num_params_);
+      }
+
+      /**
+       * Adds a draw and at the end of an adaptation window returns
+       * the blocks with their regularized covariance estimates.
+       *
+       * @param[out] blocks parameter groups of the blocks
+       * @param[out] covar covariance estimate of each block
+       * @param[in] q draw
+       * @return true at the end of an adaptation window
+       */
+      bool learn_metric(std::vector<std::vector<int> >& blocks,
+                        std::vector<Eigen::MatrixXd>& covar,
+                        const Eigen::VectorXd& q) {
+        if (adaptation_window()) {
+          if (detect_) {
+            detector_.add_sample(q);
+          } else {
+            if (!diag_blocks_.empty()) {
+              for (size_t k = 0; k < diag_blocks_.size(); ++k)
+                q_diag_(k) = q(blocks_[diag_blocks_[k]][0]);
+              diag_estimator_.add_sample(q_diag_);
+            }
+            for (size_t k = 0; k < dense_blocks_.size(); ++k) {
+              gather_(k, q);
+              estimators_[k].add_sample(q_dense_[k]);
+            }
+          }
+        }
+
+        if (end_adaptation_window()) {
+          compute_next_window();
+
+          double n;
+          covar.resize(blocks_.size());
+          if (detect_) {
+            Eigen::MatrixXd full_covar
+              = Eigen::MatrixXd::Zero(num_params_, num_params_);
+            detector_.sample_covariance(full_covar);
+            n = static_cast<double>(detector_.num_samples());
+            detect_blocks_(full_covar);
+            covar.resize(blocks_.size());
+            for (size_t b = 0; b < blocks_.size(); ++b)
+              covar[b] = submatrix_(b, full_covar);
+          } else {
+            n = static_cast<double>(diag_estimator_.num_samples());
+            if (!estimators_.empty())
+              n = static_cast<double>(estimators_[0].num_samples());
+
+            Eigen::VectorXd var = Eigen::VectorXd::Zero(diag_blocks_.size());
+            diag_estimator_.sample_variance(var);
+            diag_estimator_.restart();
+            for (size_t k = 0; k < diag_blocks_.size(); ++k)
+              covar[diag_blocks_[k]].setConstant(1, 1, var(k));
+
+            for (size_t k = 0; k < dense_blocks_.size(); ++k) {
+              int b = dense_blocks_[k];
+              covar[b].setZero(blocks_[b].size(), blocks_[b].size());
+              estimators_[k].sample_covariance(covar[b]);
+              estimators_[k].restart();
+            }
+          }
+
+          for (size_t b = 0; b < covar.size(); ++b)
+            covar[b] = (n / (n + 5.0)) * covar[b]
+              + 1e-3 * (5.0 / (n + 5.0))
+              * Eigen::MatrixXd::Identity(covar[b].rows(), covar[b].cols());
+          blocks = blocks_;
+
+          ++adapt_window_counter_;
+          return true;
+        }
+
+        ++adapt_window_counter_;
+        return false;
+      }
+
+      void save_state(io::checkpoint_writer& checkpoint) {
+        windowed_adaptation::save_state(checkpoint);
+        checkpoint.write(static_cast<int>(blocks_.size()));
+        for (size_t b = 0; b < blocks_.size(); ++b) {
+          checkpoint.write(static_cast<int>(blocks_[b].size()));
+          for (size_t i = 0; i < blocks_[b].size(); ++i)
+            checkpoint.write(blocks_[b][i]);
+        }
+        write_estimator(checkpoint, diag_estimator_);
+        for (size_t k = 0; k < estimators_.size(); ++k)
+          write_estimator(checkpoint, estimators_[k]);
+        checkpoint.write(detect_);
+        checkpoint.write(threshold_);
+        checkpoint.write(max_block_size_);
+        if (detect_)
+          write_estimator(checkpoint, detector_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        windowed_adaptation::load_state(checkpoint);
+        int num_blocks;
+        checkpoint.read(num_blocks);
+        std::vector<std::vector<int> > blocks(num_blocks);
+        for (int b = 0; b < num_blocks; ++b) {
+          int size;
+          checkpoint.read(size);
+          blocks[b].resize(size);
+          for (int i = 0; i < size; ++i)
+            checkpoint.read(blocks[b][i]);
+        }
+        set_blocks(blocks);
+        read_estimator(checkpoint, diag_estimator_);
+        for (size_t k = 0; k < estimators_.size(); ++k)
+          read_estimator(checkpoint, estimators_[k]);
+        checkpoint.read(detect_);
+        checkpoint.read(threshold_);
+        checkpoint.read(max_block_size_);
+        detector_ = stan::math::welford_covar_estimator(detect_
+                                                        ? num_params_ : 0);
+        if (detect_)
+          read_estimator(checkpoint, detector_);
+      }
+
+    protected:
+      int num_params_;
+      std::vector<std::vector<int> > blocks_;
+
+      // Blocks of one parameter share a variance estimator; larger
+      // blocks each have a covariance estimator and a buffer for
+      // their part of the draw
+      std::vector<int> diag_blocks_;
+      stan::math::welford_var_estimator diag_estimator_;
+      Eigen::VectorXd q_diag_;
+      std::vector<int> dense_blocks_;
+      std::vector<stan::math::welford_covar_estimator> estimators_;
+      std::vector<Eigen::VectorXd> q_dense_;
+
+      bool detect_;
+      double threshold_;
+      int max_block_size_;
+      // Full covariance estimator, sized only while detecting
+      stan::math::welford_covar_estimator detector_;
+
+      void gather_(size_t k, const Eigen::VectorXd& q) {
+        const std::vector<int>& block = blocks_[dense_blocks_[k]];
+        for (size_t i = 0; i < block.size(); ++i)
+          q_dense_[k](i) = q(block[i]);
+      }
+
+      Eigen::MatrixXd submatrix_(size_t b, const Eigen::MatrixXd& m) {
+        int size = blocks_[b].size();
+        Eigen::MatrixXd m_b(size, size);
+        for (int i = 0; i < size; ++i)
+          for (int j = 0; j < size; ++j)
+            m_b(i, j) = m(blocks_[b][i], blocks_[b][j]);
+        return m_b;
+      }
+
+      static int find_(std::vector<int>& parent, int i) {
+        while (parent[i] != i)
+          i = parent[i] = parent[parent[i]];
+        return i;
+      }
+
+      // Merges parameters in order of decreasing absolute correlation
+      // while the merged block stays within the maximum size, then
+      // switches to estimating the detected blocks.
+      void detect_blocks_(const Eigen::MatrixXd& covar) {
+        int n = num_params_;
+        std::vector<std::pair<double, std::pair<int, int> > > pairs;
+        for (int j = 0; j < n; ++j)
+          for (int i = j + 1; i < n; ++i) {
+            double scale = std::sqrt(covar(i, i) * covar(j, j));
+            if (!(scale > 0))
+              continue;
+            double corr = std::fabs(covar(i, j)) / scale;
+            if (corr > threshold_)
+              pairs.push_back(std::make_pair(-corr, std::make_pair(i, j)));
+          }
+        std::sort(pairs.begin(), pairs.end());
+
+        std::vector<int> parent(n);
+        std::vector<int> size(n, 1);
+        for (int i = 0; i < n; ++i)
+          parent[i] = i;
+        for (size_t k = 0; k < pairs.size(); ++k) {
+          int a = find_(parent, pairs[k].second.first);
+          int b = find_(parent, pairs[k].second.second);
+          if (a == b || size[a] + size[b] > max_block_size_)
+            continue;
+          parent[b] = a;
+          size[a] += size[b];
+        }
+
+        std::vector<int> block_of_root(n, -1);
+        std::vector<std::vector<int> > blocks;
+        for (int i = 0; i < n; ++i) {
+          int root = find_(parent, i);
+          if (block_of_root[root] < 0) {
+            block_of_root[root] = blocks.size();
+            blocks.push_back(std::vector<int>());
+          }
+          blocks[block_of_root[root]].push_back(i);
+        }
+
+        set_blocks(blocks);
+        detect_ = false;
+        detector_ = stan::math::welford_covar_estimator(0);
+      }
+    };
+
+  }  // mcmc
+
+}  // stan
+#endif
@@ -0,0 +1,244 @@
+#ifndef STAN_MCMC_CONVERGENCE_MONITOR_HPP
+#define STAN_MCMC_CONVERGENCE_MONITOR_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace stan {
+  namespace mcmc {
+
+    /**
+     * Tracks the draws of several chains of the same model while they
+     * sample and decides when every parameter has reached a target
+     * effective sample size and split potential scale reduction.
+     *
+     * The draws are not stored.  Each chain keeps the mean and the sum
+     * of squared deviations of consecutive batches of draws, with
+     * between <code>max_batches / 2</code> and
+     * <code>max_batches</code> full batches: when the last slot fills,
+     * neighbouring batches are merged and the batch size doubles.  The
+     * memory used does not grow with the number of draws, adding a
+     * draw never allocates, and a check costs one pass over the
+     * batches.
+     *
+     * The split R hat is computed from the two halves of each chain's
+     * full batches as in <code>mcmc::chains</code>.  The effective
+     * sample size is the batch means estimate, the number of draws
+     * times the within-chain variance over the variance of the batch
+     * means scaled by the batch size, averaged over chains.  Draws in
+     * the batch that is still filling are left out of both.
+     */
+    class convergence_monitor {
+    public:
+      enum { max_batches = 64 };
+
+      /**
+       * @param num_chains number of chains
+       * @param num_params number of parameters of each draw
+       * @param min_ess target effective sample size of every parameter
+       * @param max_rhat target split R hat of every parameter
+       * @throw std::invalid_argument if there are no chains or no
+       * parameters, or if a target is not positive
+       */
+      convergence_monitor(int num_chains, int num_params,
+                          double min_ess, double max_rhat)
+        : chains_(num_chains > 0 ? num_chains : 0,
+                  chain_batches(num_params > 0 ? num_params : 0)),
+          min_ess_(min_ess), max_rhat_(max_rhat),
+          ess_(0), rhat_(0) {
+        if (num_chains < 1 || num_params < 1)
+          throw std::invalid_argument("convergence_monitor: the number of "
+                                      "chains and parameters must be "
+                                      "positive");
+        if (!(min_ess > 0) || !(max_rhat > 0))
+          throw std::invalid_argument("convergence_monitor: the targets must "
+                                      "be positive");
+      }
+
+      int num_chains() const {
+        return chains_.size();
+      }
+
+      /**
+       * Return the smallest number of draws recorded for a chain.
+       */
+      int num_draws() const {
+        int n = chains_[0].num_draws;
+        for (size_t chain = 1; chain < chains_.size(); ++chain)
+          n = chains_[chain].num_draws < n ? chains_[chain].num_draws : n;
+        return n;
+      }
+
+      /**
+       * Record a draw of the specified chain.
+       *
+       * @param chain index of the chain
+       * @param q unconstrained parameters of the draw
+       */
+      void add(int chain, const Eigen::VectorXd& q) {
+        chain_batches& c = chains_[chain];
+        ++c.num_draws;
+
+        // Welford update of the batch that is filling
+        ++c.count;
+        c.delta = q - c.mean;
+        c.mean += c.delta / c.count;
+        c.m2 += c.delta.cwiseProduct(q - c.mean);
+        if (c.count < c.batch_size)
+          return;
+
+        c.batch_mean.col(c.num_batches) = c.mean;
+        c.batch_m2.col(c.num_batches) = c.m2;
+        ++c.num_batches;
+        c.count = 0;
+        c.mean.setZero();
+        c.m2.setZero();
+
+        if (c.num_batches < max_batches)
+          return;
+
+        // Merge neighbouring batches of equal size
+        for (int j = 0; j < max_batches / 2; ++j) {
+          c.delta = c.batch_mean.col(2 * j + 1) - c.batch_mean.col(2 * j);
+          c.batch_m2.col(j) = c.batch_m2.col(2 * j)
+            + c.batch_m2.col(2 * j + 1)
+            + 0.5 * c.batch_size * c.delta.cwiseAbs2();
+          c.batch_mean.col(j) = c.batch_mean.col(2 * j) + 0.5 * c.delta;
+        }
+        c.num_batches = max_batches / 2;
+        c.batch_size *= 2;
+      }
+
+      /**
+       * Recompute the diagnostics and return true if every parameter
+       * meets both targets.  Nothing is computed until the chains
+       * hold the same number of full batches and enough draws to
+       * possibly reach the target effective sample size.
+       */
+      bool converged() {
+        ess_ = 0;
+        rhat_ = 0;
+
+        const int M = num_chains();
+        const int num_batches = chains_[0].num_batches;
+        const int batch_size = chains_[0].batch_size;
+        for (int chain = 1; chain < M; ++chain)
+          if (chains_[chain].num_batches != num_batches
+              || chains_[chain].batch_size != batch_size)
+            return false;
+
+        // Each half needs two batches for its variance
+        const int half = num_batches / 2;
+        const int n = num_batches * batch_size;
+        if (half < 2 || static_cast<double>(n) * M < min_ess_)
+          return false;
+        const int n_half = half * batch_size;
+
+        for (int i = 0; i < chains_[0].mean.size(); ++i) {
+          Eigen::VectorXd split_mean(2 * M);
+          Eigen::VectorXd split_var(2 * M);
+          double var_within = 0;
+          double var_batch_means = 0;
+
+          for (int chain = 0; chain < M; ++chain) {
+            const chain_batches& c = chains_[chain];
+            Eigen::VectorXd means = c.batch_mean.row(i).head(num_batches);
+            Eigen::VectorXd m2 = c.batch_m2.row(i).head(num_batches);
+
+            double mean = means.mean();
+            double sq_dev = (means.array() - mean).square().sum();
+            var_within += (m2.sum() + batch_size * sq_dev) / (n - 1);
+            var_batch_means += batch_size * sq_dev / (num_batches - 1);
+
+            // An odd batch in the middle is left out of the halves
+            for (int h = 0; h < 2; ++h) {
+              int first = h == 0 ? 0 : num_batches - half;
+              double half_mean = means.segment(first, half).mean();
+              double half_sq_dev = (means.segment(first, half).array()
+                                    - half_mean).square().sum();
+              split_mean(2 * chain + h) = half_mean;
+              split_var(2 * chain + h)
+                = (m2.segment(first, half).sum() + batch_size * half_sq_dev)
+                / (n_half - 1);
+            }
+          }
+
+          double ess = n * M * var_within / var_batch_means;
+
+          double split_mean_mean = split_mean.mean();
+          double var_between = n_half
+            * (split_mean.array() - split_mean_mean).square().sum()
+            / (2 * M - 1);
+          // rewrote [(n-1)*W/n + B/n]/W as (n-1+ B/W)/n
+          double rhat = std::sqrt((var_between / split_var.mean()
+                                   + n_half - 1) / n_half);
+
+          // A diagnostic that is not a number, such as for a constant
+          // parameter, sticks so the run is never reported converged
+          if (i == 0 || ess < ess_ || boost::math::isnan(ess))
+            ess_ = ess;
+          if (i == 0 || rhat > rhat_ || boost::math::isnan(rhat))
+            rhat_ = rhat;
+        }
+
+        return ess_ >= min_ess_ && rhat_ <= max_rhat_;
+      }
+
+      /**
+       * Return the smallest effective sample size over the parameters
+       * at the last check, zero if none was computed.
+       */
+      double min_ess() const {
+        return ess_;
+      }
+
+      /**
+       * Return the largest split R hat over the parameters at the last
+       * check, zero if none was computed.
+       */
+      double max_rhat() const {
+        return rhat_;
+      }
+
+    private:
+      // Running batch statistics of one chain, one row per parameter
+      struct chain_batches {
+        Eigen::MatrixXd batch_mean;
+        Eigen::MatrixXd batch_m2;
+        int num_batches;
+        int batch_size;
+
+        // Batch that is filling
+        Eigen::VectorXd mean;
+        Eigen::VectorXd m2;
+        int count;
+
+        int num_draws;
+        Eigen::VectorXd delta;
+
+        explicit chain_batches(int num_params)
+          : batch_mean(num_params, static_cast<int>(max_batches)),
+            batch_m2(num_params, static_cast<int>(max_batches)),
+            num_batches(0), batch_size(1),
+            mean(Eigen::VectorXd::Zero(num_params)),
+            m2(Eigen::VectorXd::Zero(num_params)),
+            count(0), num_draws(0),
+            delta(num_params) { }
+      };
+
+      std::vector<chain_batches> chains_;
+
+      double min_ess_;
+      double max_rhat_;
+
+      // Diagnostics at the last check
+      double ess_;
+      double rhat_;
+    };
+
+  }  // mcmc
+}  // stan
+#endif
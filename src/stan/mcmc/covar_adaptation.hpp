@@ -3,7 +3,10 @@
 
 #include <stan/math/prim/mat/fun/Eigen.hpp>
 #include <stan/mcmc/windowed_adaptation.hpp>
+#include <stan/mcmc/welford_checkpoint.hpp>
+#include <stan/mcmc/covar_adaptation_pool.hpp>
 #include <stan/math/prim/mat/fun/welford_covar_estimator.hpp>
+#include <stdexcept>
 #include <vector>
 
 namespace stan {
@@ -13,9 +16,30 @@ namespace stan {
     class covar_adaptation: public windowed_adaptation {
     public:
       explicit covar_adaptation(int n)
-        : windowed_adaptation("covariance"), estimator_(n) {}
+        : windowed_adaptation("covariance"), estimator_(n),
+          pool_(0), pool_generation_(0), waiting_(false) {}
+
+      /**
+       * Estimates the covariance from the draws of every chain that
+       * joins the specified pool instead of from this chain alone.
+       * Chains sharing a pool must use the same window parameters and
+       * be advanced in lockstep, one transition per chain in turn.
+       * When resuming, set the pool before loading the state of this
+       * adaptation, and load the pool itself once.
+       *
+       * @param pool pool to join; must outlive this adaptation
+       */
+      void set_pool(covar_adaptation_pool* pool) {
+        pool_ = pool;
+        pool_->join();
+        pool_generation_ = pool_->generation();
+        waiting_ = false;
+      }
 
       bool learn_covariance(Eigen::MatrixXd& covar, const Eigen::VectorXd& q) {
+        if (pool_)
+          return learn_pooled_covariance_(covar, q);
+
         if (adaptation_window())
           estimator_.add_sample(q);
 
@@ -39,8 +63,75 @@ namespace stan {
         return false;
       }
 
+      /**
+       * Copies the pooled covariance into covar if it was published
+       * after this chain closed its last window.  Such a chain
+       * otherwise picks the estimate up only at its next call to
+       * learn_covariance, which never comes once adaptation is
+       * disengaged.
+       *
+       * @return true if covar was updated
+       */
+      bool pick_up_pooled_covariance(Eigen::MatrixXd& covar) {
+        return pool_ && pick_up_pooled_(covar);
+      }
+
+      void save_state(io::checkpoint_writer& checkpoint) {
+        windowed_adaptation::save_state(checkpoint);
+        write_estimator(checkpoint, estimator_);
+        checkpoint.write(pool_generation_);
+        checkpoint.write(waiting_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        windowed_adaptation::load_state(checkpoint);
+        read_estimator(checkpoint, estimator_);
+        checkpoint.read(pool_generation_);
+        checkpoint.read(waiting_);
+      }
+
     protected:
       stan::math::welford_covar_estimator estimator_;
+
+      covar_adaptation_pool* pool_;
+      unsigned int pool_generation_;
+      // True between the end of a window and the pooled update
+      bool waiting_;
+
+      // The last chain to finish a window computes the pooled
+      // covariance; chains that finished before it pick it up at
+      // their next call, so no draw is added to a window that has
+      // not been closed by every chain.
+      bool learn_pooled_covariance_(Eigen::MatrixXd& covar,
+                                    const Eigen::VectorXd& q) {
+        bool update = pick_up_pooled_(covar);
+
+        if (adaptation_window()) {
+          if (waiting_)
+            throw std::logic_error("Chains sharing an adaptation pool "
+                                   "must be advanced in lockstep");
+          pool_->add_sample(q);
+        }
+
+        if (end_adaptation_window()) {
+          compute_next_window();
+          waiting_ = true;
+          pool_->end_window();
+          update = pick_up_pooled_(covar) || update;
+        }
+
+        ++adapt_window_counter_;
+        return update;
+      }
+
+      bool pick_up_pooled_(Eigen::MatrixXd& covar) {
+        if (!waiting_ || pool_->generation() == pool_generation_)
+          return false;
+        covar = pool_->covariance();
+        pool_generation_ = pool_->generation();
+        waiting_ = false;
+        return true;
+      }
     };
 
   }  // mcmc
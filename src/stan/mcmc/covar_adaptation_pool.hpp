@@ -0,0 +1,102 @@
+#ifndef STAN_MCMC_COVAR_ADAPTATION_POOL_HPP
+#define STAN_MCMC_COVAR_ADAPTATION_POOL_HPP
+
+#include <stan/io/checkpoint.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/mcmc/welford_checkpoint.hpp>
+#include <stan/math/prim/mat/fun/welford_covar_estimator.hpp>
+
+namespace stan {
+
+  namespace mcmc {
+
+    /**
+     * Covariance estimator shared by the covar_adaptation of several
+     * chains that warm up together.
+     *
+     * Every chain adds its draws to one Welford estimator.  When the
+     * last chain of the pool reaches the end of an adaptation window
+     * the pooled covariance is computed, regularized as in
+     * covar_adaptation, and published under a new generation number
+     * for every chain to pick up.
+     */
+    class covar_adaptation_pool {
+    public:
+      explicit covar_adaptation_pool(int n)
+        : estimator_(n), covar_(Eigen::MatrixXd::Identity(n, n)),
+          num_chains_(0), num_arrived_(0), generation_(0) {}
+
+      void join() {
+        ++num_chains_;
+      }
+
+      int num_chains() const {
+        return num_chains_;
+      }
+
+      unsigned int generation() const {
+        return generation_;
+      }
+
+      const Eigen::MatrixXd& covariance() const {
+        return covar_;
+      }
+
+      void add_sample(const Eigen::VectorXd& q) {
+        estimator_.add_sample(q);
+      }
+
+      /**
+       * Records that a chain reached the end of the current window.
+       * The last chain to arrive computes the pooled covariance.
+       */
+      void end_window() {
+        if (++num_arrived_ < num_chains_)
+          return;
+
+        estimator_.sample_covariance(covar_);
+
+        double n = static_cast<double>(estimator_.num_samples());
+        covar_ = (n / (n + 5.0)) * covar_
+          + 1e-3 * (5.0 / (n + 5.0))
+          * Eigen::MatrixXd::Identity(covar_.rows(), covar_.cols());
+
+        estimator_.restart();
+        num_arrived_ = 0;
+        ++generation_;
+      }
+
+      /**
+       * Saves the pooled draws and the published estimate.  The
+       * chains are not saved; they join again when their adaptations
+       * are given the restored pool.
+       */
+      void save_state(io::checkpoint_writer& checkpoint) {
+        checkpoint.begin_section("covar_adaptation_pool");
+        write_estimator(checkpoint, estimator_);
+        checkpoint.write(covar_);
+        checkpoint.write(num_arrived_);
+        checkpoint.write(generation_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        checkpoint.begin_section("covar_adaptation_pool");
+        read_estimator(checkpoint, estimator_);
+        checkpoint.read(covar_);
+        checkpoint.read(num_arrived_);
+        checkpoint.read(generation_);
+      }
+
+    protected:
+      stan::math::welford_covar_estimator estimator_;
+      Eigen::MatrixXd covar_;
+
+      int num_chains_;
+      int num_arrived_;
+      unsigned int generation_;
+    };
+
+  }  // mcmc
+
+}  // stan
+#endif
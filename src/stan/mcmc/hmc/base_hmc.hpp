@@ -31,7 +31,8 @@ namespace stan {
           rand_uniform_(rand_int_),
           nom_epsilon_(0.1),
           epsilon_(nom_epsilon_),
-          epsilon_jitter_(0.0) {}
+          epsilon_jitter_(0.0),
+          z_current_(false) {}
 
       void
       write_sampler_state(interface_callbacks::writer::base_writer& writer) {
@@ -50,8 +51,27 @@ namespace stan {
         z_.get_params(values);
       }
 
+      void save_state(io::checkpoint_writer& checkpoint) {
+        checkpoint.begin_section("hmc");
+        checkpoint.write(nom_epsilon_);
+        checkpoint.write(epsilon_);
+        checkpoint.write(epsilon_jitter_);
+        checkpoint.write(z_current_);
+        z_.save_state(checkpoint);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        checkpoint.begin_section("hmc");
+        checkpoint.read(nom_epsilon_);
+        checkpoint.read(epsilon_);
+        checkpoint.read(epsilon_jitter_);
+        checkpoint.read(z_current_);
+        z_.load_state(checkpoint);
+      }
+
       void seed(const Eigen::VectorXd& q) {
         z_.q = q;
+        z_current_ = false;
       }
 
       void
@@ -63,14 +83,14 @@ namespace stan {
       void
       init_stepsize(interface_callbacks::writer::base_writer& info_writer,
                     interface_callbacks::writer::base_writer& error_writer) {
+        this->z_current_ = false;
         ps_point z_init(this->z_);
 
         // Skip initialization for extreme step sizes
         if (this->nom_epsilon_ == 0 || this->nom_epsilon_ > 1e7)
           return;
 
-        this->hamiltonian_.sample_p(this->z_, this->rand_int_);
-        this->hamiltonian_.init(this->z_, info_writer, error_writer);
+        init_and_sample_p_(info_writer, error_writer);
 
         // Guaranteed to be finite if randomly initialized
         double H0 = this->hamiltonian_.H(this->z_);
@@ -90,8 +110,7 @@ namespace stan {
         while (1) {
           this->z_.ps_point::operator=(z_init);
 
-          this->hamiltonian_.sample_p(this->z_, this->rand_int_);
-          this->hamiltonian_.init(this->z_, info_writer, error_writer);
+          init_and_sample_p_(info_writer, error_writer);
 
           double H0 = this->hamiltonian_.H(this->z_);
 
@@ -127,7 +146,15 @@ namespace stan {
         this->z_.ps_point::operator=(z_init);
       }
 
+      /**
+       * Returns the current point.  The point may be modified through
+       * the returned reference, so its potential and gradient are
+       * recomputed at the start of the next transition.
+       *
+       * @return current point
+       */
       typename Hamiltonian<Model, BaseRNG>::PointType& z() {
+        z_current_ = false;
         return z_;
       }
 
@@ -161,6 +188,68 @@ namespace stan {
       }
 
     protected:
+      /**
+       * Seeds the current point with the specified position, draws a
+       * new momentum and initializes the Hamiltonian at the point.
+       *
+       * When the position is the one the previous transition ended
+       * on, the potential and gradient stored with the point are
+       * still valid and are reused instead of being recomputed.
+       *
+       * @param q position at which the transition starts
+       * @param info_writer writer for informational messages
+       * @param error_writer writer for error messages
+       */
+      void
+      begin_transition_(const Eigen::VectorXd& q,
+                        interface_callbacks::writer::base_writer& info_writer,
+                        interface_callbacks::writer::base_writer& error_writer) {
+        bool reuse = z_current_
+          && this->hamiltonian_.reuses_point_state()
+          && q.size() == z_.q.size()
+          && q == z_.q;
+        z_current_ = false;
+
+        if (reuse) {
+          this->hamiltonian_.sample_p(this->z_, this->rand_int_);
+          return;
+        }
+
+        z_.q = q;
+        init_and_sample_p_(info_writer, error_writer);
+      }
+
+      /**
+       * Draws a new momentum and initializes the Hamiltonian at the
+       * current position, in the order the Hamiltonian asks for
+       * with samples_p_after_init.
+       *
+       * @param info_writer writer for informational messages
+       * @param error_writer writer for error messages
+       */
+      void
+      init_and_sample_p_(interface_callbacks::writer::base_writer&
+                         info_writer,
+                         interface_callbacks::writer::base_writer&
+                         error_writer) {
+        if (this->hamiltonian_.samples_p_after_init()) {
+          this->hamiltonian_.init(this->z_, info_writer, error_writer);
+          this->hamiltonian_.sample_p(this->z_, this->rand_int_);
+        } else {
+          this->hamiltonian_.sample_p(this->z_, this->rand_int_);
+          this->hamiltonian_.init(this->z_, info_writer, error_writer);
+        }
+      }
+
+      /**
+       * Marks the potential and gradient of the current point as
+       * valid for the next transition.  Called once the transition
+       * has settled on the point it returns.
+       */
+      void end_transition_() {
+        z_current_ = true;
+      }
+
       typename Hamiltonian<Model, BaseRNG>::PointType z_;
       Integrator<Hamiltonian<Model, BaseRNG> > integrator_;
       Hamiltonian<Model, BaseRNG> hamiltonian_;
@@ -173,6 +262,9 @@ namespace stan {
       double nom_epsilon_;
       double epsilon_;
       double epsilon_jitter_;
+
+      // True while z_ holds the potential and gradient at z_.q
+      bool z_current_;
     };
 
   }  // mcmc
@@ -56,6 +56,28 @@ namespace stan {
         interface_callbacks::writer::base_writer& info_writer,
         interface_callbacks::writer::base_writer& error_writer) = 0;
 
+      // In-place versions of the gradients above, which resize out only
+      // if it does not already match z so that the integrators and
+      // samplers can reuse their buffers.  Metrics with closed form
+      // gradients override these with allocation free kernels.
+      virtual void dtau_dq_into(
+        Point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out = dtau_dq(z, info_writer, error_writer);
+      }
+
+      virtual void dtau_dp_into(Point& z, Eigen::VectorXd& out) {
+        out = dtau_dp(z);
+      }
+
+      virtual void dphi_dq_into(
+        Point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out = dphi_dq(z, info_writer, error_writer);
+      }
+
       virtual void sample_p(Point& z, BaseRNG& rng) = 0;
 
       void init(Point& z,
@@ -107,6 +129,21 @@ namespace stan {
         update_potential_gradient(z, info_writer, error_writer);
       }
 
+      // Whether the potential and gradient stored in a ps_point are
+      // everything init computes, so that a point restored through
+      // ps_point::operator= can start a new trajectory without init.
+      bool reuses_point_state() {
+        return true;
+      }
+
+      // Whether the momentum must be drawn after init, because its
+      // distribution depends on the metric at the position.  The
+      // other metrics draw it before init, which keeps their draws
+      // as they have always been.
+      bool samples_p_after_init() {
+        return false;
+      }
+
     protected:
       const Model& model_;
 
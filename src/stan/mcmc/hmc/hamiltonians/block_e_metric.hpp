@@ -0,0 +1,132 @@
+#ifndef STAN_MCMC_HMC_HAMILTONIANS_BLOCK_E_METRIC_HPP
+#define STAN_MCMC_HMC_HAMILTONIANS_BLOCK_E_METRIC_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat/meta/index_type.hpp>
+#include <stan/mcmc/hmc/hamiltonians/base_hamiltonian.hpp>
+#include <stan/mcmc/hmc/hamiltonians/block_e_point.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <boost/random/normal_distribution.hpp>
+
+namespace stan {
+  namespace mcmc {
+
+    // Euclidean manifold with block diagonal metric
+    template <class Model, class BaseRNG>
+    class block_e_metric
+      : public base_hamiltonian<Model, block_e_point, BaseRNG> {
+    public:
+      explicit block_e_metric(const Model& model)
+        : base_hamiltonian<Model, block_e_point, BaseRNG>(model) {}
+
+      double T(block_e_point& z) {
+        block_products_(z);
+        return 0.5 * p_blocks_.dot(p_sharp_blocks_);
+      }
+
+      double tau(block_e_point& z) {
+        return T(z);
+      }
+
+      double phi(block_e_point& z) {
+        return this->V(z);
+      }
+
+      double dG_dt(block_e_point& z,
+                   interface_callbacks::writer::base_writer& info_writer,
+                   interface_callbacks::writer::base_writer& error_writer) {
+        return 2 * T(z) - z.q.dot(z.g);
+      }
+
+      Eigen::VectorXd dtau_dq(
+        block_e_point& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        return Eigen::VectorXd::Zero(this->model_.num_params_r());
+      }
+
+      Eigen::VectorXd dtau_dp(block_e_point& z) {
+        Eigen::VectorXd p_sharp(z.p.size());
+        dtau_dp_into(z, p_sharp);
+        return p_sharp;
+      }
+
+      void dtau_dq_into(
+        block_e_point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out.setZero(z.q.size());
+      }
+
+      void dtau_dp_into(block_e_point& z, Eigen::VectorXd& out) {
+        block_products_(z);
+        scatter_(z, p_sharp_blocks_, out);
+      }
+
+      void dphi_dq_into(
+        block_e_point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out = z.g;
+      }
+
+      Eigen::VectorXd dphi_dq(
+        block_e_point& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        return z.g;
+      }
+
+      void sample_p(block_e_point& z, BaseRNG& rng) {
+        typedef typename stan::math::index_type<Eigen::VectorXd>::type idx_t;
+        boost::variate_generator<BaseRNG&, boost::normal_distribution<> >
+          rand_block_gaus(rng, boost::normal_distribution<>());
+
+        p_blocks_.resize(z.p.size());
+        for (idx_t i = 0; i < p_blocks_.size(); ++i)
+          p_blocks_(i) = rand_block_gaus();
+
+        // With mInv_b = L_b L_b^T, p_b = L_b^-T u_b has covariance
+        // mInv_b^-1
+        for (int b = 0; b < z.num_blocks(); ++b) {
+          Eigen::VectorXd::SegmentReturnType
+            u_b = p_blocks_.segment(z.block_start(b), z.block_size(b));
+          z.mInv_L_block(b).transpose().triangularView<Eigen::Upper>()
+            .solveInPlace(u_b);
+        }
+        scatter_(z, p_blocks_, z.p);
+      }
+
+    private:
+      // Momentum and its product with the inverse metric, both in
+      // block order
+      Eigen::VectorXd p_blocks_;
+      Eigen::VectorXd p_sharp_blocks_;
+
+      // Reorders the momentum so that every block is contiguous and
+      // multiplies each block by its inverse metric
+      void block_products_(block_e_point& z) {
+        p_blocks_.resize(z.p.size());
+        p_sharp_blocks_.resize(z.p.size());
+        for (int i = 0; i < z.p.size(); ++i)
+          p_blocks_(i) = z.p(z.order()(i));
+        for (int b = 0; b < z.num_blocks(); ++b)
+          p_sharp_blocks_.segment(z.block_start(b), z.block_size(b))
+            .noalias()
+            = z.mInv_block(b).selfadjointView<Eigen::Lower>()
+              * p_blocks_.segment(z.block_start(b), z.block_size(b));
+      }
+
+      // Inverse of the reordering, from block order back to the
+      // parameter order
+      void scatter_(block_e_point& z, const Eigen::VectorXd& x_blocks,
+                    Eigen::VectorXd& x) {
+        x.resize(x_blocks.size());
+        for (int i = 0; i < x.size(); ++i)
+          x(z.order()(i)) = x_blocks(i);
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
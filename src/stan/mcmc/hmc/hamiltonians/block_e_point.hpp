@@ -0,0 +1,201 @@
+#ifndef STAN_MCMC_HMC_HAMILTONIANS_BLOCK_E_POINT_HPP
+#define STAN_MCMC_HMC_HAMILTONIANS_BLOCK_E_POINT_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <Eigen/Cholesky>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * Point in a phase space with a base Euclidean manifold whose
+     * inverse metric is block diagonal.
+     *
+     * Each block is a group of parameters, not necessarily adjacent,
+     * with its own dense inverse metric and cached Cholesky factor.
+     * The parameters are stored block by block in order() so that
+     * the Hamiltonian can work on contiguous segments, and every
+     * operation costs the sum of the squared block sizes.  By
+     * default every parameter is its own block with unit metric.
+     */
+    class block_e_point: public ps_point {
+    public:
+      explicit block_e_point(int n)
+        : ps_point(n) {
+        std::vector<std::vector<int> > blocks(n, std::vector<int>(1));
+        std::vector<Eigen::MatrixXd> mInv(n, Eigen::MatrixXd::Ones(1, 1));
+        for (int i = 0; i < n; ++i)
+          blocks[i][0] = i;
+        set_metric(blocks, mInv);
+      }
+
+      int num_blocks() const {
+        return mInv_.size();
+      }
+
+      /**
+       * Returns the parameter indices of every block, in block order.
+       */
+      const Eigen::VectorXi& order() const {
+        return order_;
+      }
+
+      /**
+       * Returns the position in order() at which each block starts.
+       */
+      int block_start(int b) const {
+        return block_start_[b];
+      }
+
+      int block_size(int b) const {
+        return mInv_[b].rows();
+      }
+
+      const Eigen::MatrixXd& mInv_block(int b) const {
+        return mInv_[b];
+      }
+
+      const Eigen::MatrixXd& mInv_L_block(int b) const {
+        return mInv_L_[b];
+      }
+
+      /**
+       * Returns the diagonal of the full inverse metric in parameter
+       * order.
+       */
+      Eigen::VectorXd mInv_full_diag() const {
+        Eigen::VectorXd diag(q.size());
+        for (int b = 0; b < num_blocks(); ++b)
+          for (int i = 0; i < block_size(b); ++i)
+            diag(order_(block_start_[b] + i)) = mInv_[b](i, i);
+        return diag;
+      }
+
+      /**
+       * Returns the parameter groups of the blocks.
+       */
+      std::vector<std::vector<int> > blocks() const {
+        std::vector<std::vector<int> > groups(num_blocks());
+        for (int b = 0; b < num_blocks(); ++b)
+          for (int i = 0; i < block_size(b); ++i)
+            groups[b].push_back(order_(block_start_[b] + i));
+        return groups;
+      }
+
+      /**
+       * Sets the blocks and their inverse metrics and factors them.
+       *
+       * @param blocks parameter indices of each block; every
+       * parameter must belong to exactly one block
+       * @param mInv inverse metric of each block
+       * @throw std::invalid_argument if the blocks do not partition
+       * the parameters or a block metric is not symmetric positive
+       * definite or does not match the size of its block
+       */
+      void set_metric(const std::vector<std::vector<int> >& blocks,
+                      const std::vector<Eigen::MatrixXd>& mInv) {
+        int n = q.size();
+        if (blocks.size() != mInv.size())
+          throw std::invalid_argument("Each block of the metric needs one "
+                                      "inverse metric");
+
+        std::vector<bool> seen(n, false);
+        Eigen::VectorXi order(n);
+        std::vector<int> block_start(blocks.size());
+        std::vector<Eigen::MatrixXd> mInv_L(blocks.size());
+        int pos = 0;
+        for (size_t b = 0; b < blocks.size(); ++b) {
+          block_start[b] = pos;
+          for (size_t i = 0; i < blocks[b].size(); ++i) {
+            int idx = blocks[b][i];
+            if (idx < 0 || idx >= n || seen[idx])
+              throw std::invalid_argument("The blocks of the metric must "
+                                          "partition the parameters");
+            seen[idx] = true;
+            order(pos++) = idx;
+          }
+
+          int size = blocks[b].size();
+          if (mInv[b].rows() != size || mInv[b].cols() != size)
+            throw std::invalid_argument("A block of the metric does not "
+                                        "match the size of its group");
+          Eigen::LLT<Eigen::MatrixXd> llt(mInv[b]);
+          if (size == 0 || llt.info() != Eigen::Success)
+            throw std::invalid_argument("Each block of the metric must be "
+                                        "symmetric positive definite");
+          mInv_L[b] = llt.matrixL();
+        }
+        if (pos != n)
+          throw std::invalid_argument("The blocks of the metric must "
+                                      "partition the parameters");
+
+        order_ = order;
+        block_start_ = block_start;
+        mInv_ = mInv;
+        mInv_L_ = mInv_L;
+      }
+
+      void
+      write_metric(stan::interface_callbacks::writer::base_writer& writer) {
+        writer("Blocks of inverse mass matrix:");
+        std::stringstream mInv_ss;
+        for (int b = 0; b < num_blocks(); ++b) {
+          mInv_ss.str("");
+          mInv_ss << "Parameters " << order_(block_start_[b]);
+          for (int i = 1; i < block_size(b); ++i)
+            mInv_ss << ", " << order_(block_start_[b] + i);
+          writer(mInv_ss.str());
+
+          for (int i = 0; i < mInv_[b].rows(); ++i) {
+            mInv_ss.str("");
+            mInv_ss << mInv_[b](i, 0);
+            for (int j = 1; j < mInv_[b].cols(); ++j)
+              mInv_ss << ", " << mInv_[b](i, j);
+            writer(mInv_ss.str());
+          }
+        }
+      }
+
+      void save_state(stan::io::checkpoint_writer& checkpoint) {
+        ps_point::save_state(checkpoint);
+        checkpoint.write(num_blocks());
+        for (int b = 0; b < num_blocks(); ++b) {
+          checkpoint.write(block_size(b));
+          for (int i = 0; i < block_size(b); ++i)
+            checkpoint.write(order_(block_start_[b] + i));
+          checkpoint.write(mInv_[b]);
+        }
+      }
+
+      void load_state(stan::io::checkpoint_reader& checkpoint) {
+        ps_point::load_state(checkpoint);
+        int num_blocks;
+        checkpoint.read(num_blocks);
+        std::vector<std::vector<int> > blocks(num_blocks);
+        std::vector<Eigen::MatrixXd> mInv(num_blocks);
+        for (int b = 0; b < num_blocks; ++b) {
+          int size;
+          checkpoint.read(size);
+          blocks[b].resize(size);
+          for (int i = 0; i < size; ++i)
+            checkpoint.read(blocks[b][i]);
+          mInv[b].resize(size, size);
+          checkpoint.read(mInv[b]);
+        }
+        set_metric(blocks, mInv);
+      }
+
+    protected:
+      Eigen::VectorXi order_;
+      std::vector<int> block_start_;
+      std::vector<Eigen::MatrixXd> mInv_;
+      std::vector<Eigen::MatrixXd> mInv_L_;
+    };
+
+  }  // mcmc
+}  // stan
+
+#endif
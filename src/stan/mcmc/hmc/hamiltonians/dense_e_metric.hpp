@@ -21,7 +21,8 @@ namespace stan {
         : base_hamiltonian<Model, dense_e_point, BaseRNG>(model) {}
 
       double T(dense_e_point& z) {
-        return 0.5 * z.p.transpose() * z.mInv * z.p;
+        dtau_dp_into(z, p_sharp_);
+        return 0.5 * z.p.dot(p_sharp_);
       }
 
       double tau(dense_e_point& z) {
@@ -46,7 +47,26 @@ namespace stan {
       }
 
       Eigen::VectorXd dtau_dp(dense_e_point& z) {
-        return z.mInv * z.p;
+        return z.mInv().selfadjointView<Eigen::Lower>() * z.p;
+      }
+
+      void dtau_dq_into(
+        dense_e_point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out.setZero(z.q.size());
+      }
+
+      void dtau_dp_into(dense_e_point& z, Eigen::VectorXd& out) {
+        out.resize(z.p.size());
+        out.noalias() = z.mInv().selfadjointView<Eigen::Lower>() * z.p;
+      }
+
+      void dphi_dq_into(
+        dense_e_point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out = z.g;
       }
 
       Eigen::VectorXd dphi_dq(
@@ -61,13 +81,17 @@ namespace stan {
         boost::variate_generator<BaseRNG&, boost::normal_distribution<> >
           rand_dense_gaus(rng, boost::normal_distribution<>());
 
-        Eigen::VectorXd u(z.p.size());
-
-        for (idx_t i = 0; i < u.size(); ++i)
-          u(i) = rand_dense_gaus();
+        for (idx_t i = 0; i < z.p.size(); ++i)
+          z.p(i) = rand_dense_gaus();
 
-        z.p = z.mInv.llt().matrixL().solve(u);
+        // With mInv = L L^T, p = L^-T u has covariance mInv^-1
+        z.mInv_L().transpose().triangularView<Eigen::Upper>()
+          .solveInPlace(z.p);
       }
+
+    private:
+      // Workspace for the kinetic energy
+      Eigen::VectorXd p_sharp_;
     };
 
   }  // mcmc
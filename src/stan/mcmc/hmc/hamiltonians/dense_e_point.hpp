@@ -3,39 +3,84 @@
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
 #include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <Eigen/Cholesky>
 
 namespace stan {
   namespace mcmc {
     /**
      * Point in a phase space with a base
-     * Euclidean manifold with dense metric
+     * Euclidean manifold with dense metric.
+     *
+     * The lower Cholesky factor of the inverse metric is cached so
+     * that momenta can be drawn without refactoring the metric every
+     * transition.  The inverse metric is only changed through
+     * set_mInv, which refactors it, so the two cannot drift apart.
      */
     class dense_e_point: public ps_point {
     public:
       explicit dense_e_point(int n)
-        : ps_point(n), mInv(n, n) {
-        mInv.setIdentity();
+        : ps_point(n), mInv_(n, n), mInv_L_(n, n) {
+        mInv_.setIdentity();
+        mInv_L_.setIdentity();
       }
 
-      Eigen::MatrixXd mInv;
-
       dense_e_point(const dense_e_point& z)
-        : ps_point(z), mInv(z.mInv.rows(), z.mInv.cols()) {
-        fast_matrix_copy_<double>(mInv, z.mInv);
+        : ps_point(z), mInv_(z.mInv_.rows(), z.mInv_.cols()),
+          mInv_L_(z.mInv_L_.rows(), z.mInv_L_.cols()) {
+        fast_matrix_copy_<double>(mInv_, z.mInv_);
+        fast_matrix_copy_<double>(mInv_L_, z.mInv_L_);
+      }
+
+      const Eigen::MatrixXd& mInv() const {
+        return mInv_;
+      }
+
+      /**
+       * Returns the lower Cholesky factor of the inverse metric.
+       */
+      const Eigen::MatrixXd& mInv_L() const {
+        return mInv_L_;
+      }
+
+      /**
+       * Sets the inverse metric and recomputes its cached Cholesky
+       * factor, which happens only at the end of an adaptation
+       * window.
+       *
+       * @param mInv symmetric positive definite inverse metric
+       */
+      void set_mInv(const Eigen::MatrixXd& mInv) {
+        mInv_ = mInv;
+        mInv_L_ = mInv_.llt().matrixL();
       }
 
       void
       write_metric(stan::interface_callbacks::writer::base_writer& writer) {
         writer("Elements of inverse mass matrix:");
         std::stringstream mInv_ss;
-        for (int i = 0; i < mInv.rows(); ++i) {
+        for (int i = 0; i < mInv_.rows(); ++i) {
           mInv_ss.str("");
-          mInv_ss << mInv(i, 0);
-          for (int j = 1; j < mInv.cols(); ++j)
-            mInv_ss << ", " << mInv(i, j);
+          mInv_ss << mInv_(i, 0);
+          for (int j = 1; j < mInv_.cols(); ++j)
+            mInv_ss << ", " << mInv_(i, j);
           writer(mInv_ss.str());
         }
       }
+
+      void save_state(stan::io::checkpoint_writer& checkpoint) {
+        ps_point::save_state(checkpoint);
+        checkpoint.write(mInv_);
+      }
+
+      void load_state(stan::io::checkpoint_reader& checkpoint) {
+        ps_point::load_state(checkpoint);
+        checkpoint.read(mInv_);
+        mInv_L_ = mInv_.llt().matrixL();
+      }
+
+    private:
+      Eigen::MatrixXd mInv_;
+      Eigen::MatrixXd mInv_L_;
     };
 
   }  // mcmc
@@ -52,6 +52,24 @@ namespace stan {
         return z.g;
       }
 
+      void dtau_dq_into(
+        diag_e_point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out.setZero(z.q.size());
+      }
+
+      void dtau_dp_into(diag_e_point& z, Eigen::VectorXd& out) {
+        out = z.mInv.cwiseProduct(z.p);
+      }
+
+      void dphi_dq_into(
+        diag_e_point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out = z.g;
+      }
+
       void sample_p(diag_e_point& z, BaseRNG& rng) {
         boost::variate_generator<BaseRNG&, boost::normal_distribution<> >
           rand_diag_gaus(rng, boost::normal_distribution<>());
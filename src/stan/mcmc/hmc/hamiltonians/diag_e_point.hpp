@@ -32,6 +32,16 @@ namespace stan {
           mInv_ss << ", " << mInv(i);
         writer(mInv_ss.str());
       }
+
+      void save_state(stan::io::checkpoint_writer& checkpoint) {
+        ps_point::save_state(checkpoint);
+        checkpoint.write(mInv);
+      }
+
+      void load_state(stan::io::checkpoint_reader& checkpoint) {
+        ps_point::load_state(checkpoint);
+        checkpoint.read(mInv);
+      }
     };
 
   }  // mcmc
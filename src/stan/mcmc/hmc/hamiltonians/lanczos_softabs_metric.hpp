@@ -0,0 +1,325 @@
+#ifndef STAN_MCMC_HMC_HAMILTONIANS_LANCZOS_SOFTABS_METRIC_HPP
+#define STAN_MCMC_HMC_HAMILTONIANS_LANCZOS_SOFTABS_METRIC_HPP
+
+#include <stan/mcmc/hmc/hamiltonians/base_hamiltonian.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lanczos_softabs_point.hpp>
+#include <stan/model/util.hpp>
+
+#include <boost/random/variate_generator.hpp>
+#include <boost/random/normal_distribution.hpp>
+
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
+
+namespace stan {
+  namespace mcmc {
+
+    /**
+     * Riemannian manifold with a matrix-free SoftAbs metric.
+     *
+     * The Hessian is never formed.  A Lanczos iteration with full
+     * reorthogonalization, driven by Hessian-vector products,
+     * spans a subspace of at most max_rank directions the first time
+     * the metric is computed, and that subspace is then kept.  At
+     * every position the Hessian is projected onto it, the SoftAbs
+     * transform is applied to the eigenpairs of the projection, and
+     * every other direction gets the transform of a zero eigenvalue.
+     *
+     * Because the subspace does not move with the position the
+     * metric is a smooth function of the position alone, and the log
+     * determinant and the gradients are exact for it: the implicit
+     * integrator is volume preserving and reversible for any
+     * max_rank.  The trace terms reduce to one third-order sweep per
+     * Ritz vector, so the cost grows with max_rank rather than with
+     * the dimension.  Clearing the subspace of the point rebuilds it
+     * at the next position, which is only valid between transitions
+     * during warmup.
+     */
+    template <class Model, class BaseRNG>
+    class lanczos_softabs_metric
+      : public base_hamiltonian<Model, lanczos_softabs_point, BaseRNG> {
+    public:
+      explicit lanczos_softabs_metric(const Model& model)
+        : base_hamiltonian<Model, lanczos_softabs_point, BaseRNG>(model) {}
+
+      double T(lanczos_softabs_point& z) {
+        return this->tau(z) + 0.5 * z.log_det_metric;
+      }
+
+      double tau(lanczos_softabs_point& z) {
+        Eigen::VectorXd c = z.basis.transpose() * z.p;
+        Eigen::VectorXd p_perp = z.p - z.basis * c;
+        return 0.5 * (c.dot(z.softabs_lambda_inv.cwiseProduct(c))
+                      + p_perp.squaredNorm() / z.softabs_zero);
+      }
+
+      double phi(lanczos_softabs_point& z) {
+        return this->V(z) + 0.5 * z.log_det_metric;
+      }
+
+      double dG_dt(lanczos_softabs_point& z,
+                   interface_callbacks::writer::base_writer& info_writer,
+                   interface_callbacks::writer::base_writer& error_writer) {
+        return 2 * T(z)
+               - z.q.dot(dtau_dq(z, info_writer, error_writer)
+               + dphi_dq(z, info_writer, error_writer));
+      }
+
+      Eigen::VectorXd dtau_dq(
+        lanczos_softabs_point& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        Eigen::VectorXd c = z.basis.transpose() * z.p;
+        Eigen::VectorXd a = z.softabs_lambda_inv.cwiseProduct(c);
+
+        // The trace term is tr(C H') with C = basis (J o a a^T)
+        // basis^T, which is diagonalized so that each eigenvector
+        // needs one sweep; the complement of the subspace does not
+        // depend on the position and does not contribute.
+        Eigen::MatrixXd C = z.pseudo_j.cwiseProduct(a * a.transpose());
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> C_deco(C);
+
+        Eigen::VectorXd b = Eigen::VectorXd::Zero(z.q.size());
+        Eigen::VectorXd h(z.q.size());
+        for (int i = 0; i < C.rows(); ++i) {
+          double mu = C_deco.eigenvalues()(i);
+          if (mu == 0)
+            continue;
+          Eigen::VectorXd w = z.basis * C_deco.eigenvectors().col(i);
+          stan::model::grad_hessian_bilinear_form(this->model_, z.q,
+                                                  w, w, h);
+          b += mu * h;
+        }
+
+        return 0.5 * b;
+      }
+
+      Eigen::VectorXd dtau_dp(lanczos_softabs_point& z) {
+        Eigen::VectorXd c = z.basis.transpose() * z.p;
+        return   z.basis * z.softabs_lambda_inv.cwiseProduct(c)
+               + (z.p - z.basis * c) / z.softabs_zero;
+      }
+
+      Eigen::VectorXd dphi_dq(
+        lanczos_softabs_point& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        // Directions outside of the subspace keep the transform of a
+        // zero eigenvalue and do not contribute
+        Eigen::VectorXd a = Eigen::VectorXd::Zero(z.q.size());
+        Eigen::VectorXd h(z.q.size());
+        for (int i = 0; i < z.rank(); ++i) {
+          double weight = z.pseudo_j(i, i) * z.softabs_lambda_inv(i);
+          if (weight == 0)
+            continue;
+          Eigen::VectorXd v = z.basis.col(i);
+          stan::model::grad_hessian_bilinear_form(this->model_, z.q,
+                                                  v, v, h);
+          a += weight * h;
+        }
+        return - 0.5 * a + z.g;
+      }
+
+      void sample_p(lanczos_softabs_point& z, BaseRNG& rng) {
+        boost::variate_generator<BaseRNG&, boost::normal_distribution<> >
+          rand_unit_gaus(rng, boost::normal_distribution<>());
+
+        Eigen::VectorXd u(z.p.size());
+        for (int n = 0; n < u.size(); ++n)
+          u(n) = rand_unit_gaus();
+
+        Eigen::VectorXd c = z.basis.transpose() * u;
+        z.p =   z.basis * z.softabs_lambda.cwiseSqrt().cwiseProduct(c)
+              + std::sqrt(z.softabs_zero) * (u - z.basis * c);
+      }
+
+      void init(
+        lanczos_softabs_point& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        update_metric(z, info_writer, error_writer);
+      }
+
+      // The metric lives outside of ps_point and is not restored
+      // along with a rejected proposal, so every trajectory has to
+      // start from init.
+      bool reuses_point_state() {
+        return false;
+      }
+
+      // The momentum is drawn from the metric at the position, which
+      // init computes; before it the metric is that of the last point
+      // of the previous trajectory, which may have diverged.
+      bool samples_p_after_init() {
+        return true;
+      }
+
+      void update_metric(
+        lanczos_softabs_point& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        stan::model::gradient(this->model_, z.q, z.V, z.g);
+        z.V = -z.V;
+        z.g = -z.g;
+
+        if (z.subspace.cols() == 0)
+          build_subspace_(z);
+
+        // Projection of the Hessian of the potential onto the subspace
+        int rank = z.subspace.cols();
+        Eigen::MatrixXd projection(rank, rank);
+        Eigen::VectorXd w(z.q.size());
+        double f;
+        for (int i = 0; i < rank; ++i) {
+          stan::model::hessian_times_vector(this->model_, z.q,
+                                            z.subspace.col(i), f, w);
+          projection.col(i) = - z.subspace.transpose() * w;
+        }
+        projection = 0.5 * (projection + projection.transpose()).eval();
+
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd>
+          projection_deco(projection);
+        z.basis = z.subspace * projection_deco.eigenvectors();
+        z.lambda = projection_deco.eigenvalues();
+
+        // SoftAbs transformation of the Ritz values
+        z.softabs_zero = softabs(z.alpha, 0);
+        z.softabs_lambda.resize(rank);
+        z.softabs_lambda_inv.resize(rank);
+        for (int i = 0; i < rank; ++i) {
+          z.softabs_lambda(i) = softabs(z.alpha, z.lambda(i));
+          z.softabs_lambda_inv(i) = 1.0 / z.softabs_lambda(i);
+        }
+
+        // Compute the log determinant of the metric
+        int n = z.q.size();
+        z.log_det_metric = (n - rank) * std::log(z.softabs_zero);
+        for (int i = 0; i < rank; ++i)
+          z.log_det_metric += std::log(z.softabs_lambda(i));
+
+        // Compute the pseudo-Jacobian of the SoftAbs transform
+        z.pseudo_j.resize(rank, rank);
+        for (int i = 0; i < rank; ++i)
+          for (int j = 0; j <= i; ++j)
+            z.pseudo_j(i, j) = z.pseudo_j(j, i)
+              = pseudo_jacobian(z.alpha, z.lambda(i), z.softabs_lambda(i),
+                                z.lambda(j), z.softabs_lambda(j));
+      }
+
+      // The pseudo-Jacobian is computed along with the metric
+      void update_gradients(
+        lanczos_softabs_point& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {}
+
+      // Threshold below which a power series
+      // approximation of the softabs function is used
+      static double lower_softabs_thresh;
+
+      // Threshold above which an asymptotic
+      // approximation of the softabs function is used
+      static double upper_softabs_thresh;
+
+      // Threshold below which an exact derivative is
+      // used in the Jacobian calculation instead of
+      // finite differencing
+      static double jacobian_thresh;
+
+      // Relative size of the next Lanczos coefficient below
+      // which the Krylov subspace is taken to be invariant
+      static double lanczos_thresh;
+
+    private:
+      /**
+       * Spans the subspace of the point with a Lanczos iteration on
+       * the Hessian of the potential at the position, started from a
+       * fixed vector and stopped after max_rank steps or once the
+       * Krylov subspace is invariant.
+       */
+      void build_subspace_(lanczos_softabs_point& z) {
+        int n = z.q.size();
+        int max_rank = std::max(1, std::min(z.max_rank, n));
+
+        Eigen::MatrixXd Q(n, max_rank);
+
+        // Unequal entries keep the start vector from being orthogonal
+        // to the eigenvectors of symmetric models
+        Q.col(0) = Eigen::VectorXd::LinSpaced(n, 1, 2);
+        Q.col(0).normalize();
+
+        int rank = 0;
+        double scale = 0;
+        Eigen::VectorXd w(n);
+        double f;
+        while (rank < max_rank) {
+          stan::model::hessian_times_vector(this->model_, z.q, Q.col(rank),
+                                            f, w);
+          w = -w;
+          scale = std::max(scale, std::fabs(Q.col(rank).dot(w)));
+          ++rank;
+
+          // Full reorthogonalization, applied twice to keep the basis
+          // orthonormal in floating point
+          for (int k = 0; k < 2; ++k)
+            w -= Q.leftCols(rank) * (Q.leftCols(rank).transpose() * w);
+
+          double beta = w.norm();
+          if (rank == max_rank || !(beta > lanczos_thresh * scale))
+            break;
+          scale = std::max(scale, beta);
+          Q.col(rank) = w / beta;
+        }
+
+        z.subspace = Q.leftCols(rank);
+      }
+
+      static double softabs(double alpha, double lambda) {
+        double alpha_lambda = alpha * lambda;
+
+        // Thresholds defined such that the approximation
+        // error is on the same order of double precision
+        if (std::fabs(alpha_lambda) < lower_softabs_thresh)
+          return (1.0 + (1.0 / 3.0) * alpha_lambda * alpha_lambda) / alpha;
+        else if (std::fabs(alpha_lambda) > upper_softabs_thresh)
+          return std::fabs(lambda);
+        else
+          return lambda / std::tanh(alpha_lambda);
+      }
+
+      static double pseudo_jacobian(double alpha,
+                                    double lambda_i, double softabs_i,
+                                    double lambda_j, double softabs_j) {
+        double delta = lambda_i - lambda_j;
+        if (std::fabs(delta) >= jacobian_thresh)
+          return (softabs_i - softabs_j) / delta;
+
+        double alpha_lambda = alpha * lambda_i;
+        if (std::fabs(alpha_lambda) < lower_softabs_thresh) {
+          return   (2.0 / 3.0) * alpha_lambda
+                 * (1.0 - (2.0 / 15.0) * alpha_lambda * alpha_lambda);
+        } else if (std::fabs(alpha_lambda) > upper_softabs_thresh) {
+          return lambda_i > 0 ? 1 : -1;
+        } else {
+          double sdx = std::sinh(alpha_lambda) / lambda_i;
+          return (softabs_i - alpha / (sdx * sdx)) / lambda_i;
+        }
+      }
+    };
+
+    template <class Model, class BaseRNG>
+    double
+    lanczos_softabs_metric<Model, BaseRNG>::lower_softabs_thresh = 1e-4;
+
+    template <class Model, class BaseRNG>
+    double
+    lanczos_softabs_metric<Model, BaseRNG>::upper_softabs_thresh = 18;
+
+    template <class Model, class BaseRNG>
+    double lanczos_softabs_metric<Model, BaseRNG>::jacobian_thresh = 1e-10;
+
+    template <class Model, class BaseRNG>
+    double lanczos_softabs_metric<Model, BaseRNG>::lanczos_thresh = 1e-10;
+  }  // mcmc
+}  // stan
+#endif
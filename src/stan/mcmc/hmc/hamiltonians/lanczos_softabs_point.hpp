@@ -0,0 +1,125 @@
+#ifndef STAN_MCMC_HMC_HAMILTONIANS_LANCZOS_SOFTABS_POINT_HPP
+#define STAN_MCMC_HMC_HAMILTONIANS_LANCZOS_SOFTABS_POINT_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * Point in a phase space with a base
+     * Riemannian manifold with a truncated SoftAbs metric.
+     *
+     * Instead of the full eigendecomposition of the Hessian the
+     * point keeps the eigenpairs of its projection onto a fixed
+     * subspace of at most max_rank directions, spanned by a Lanczos
+     * iteration at the first position.  Directions outside of the
+     * subspace are treated as having a zero eigenvalue, so the
+     * metric is
+     *
+     *   basis diag(softabs_lambda) basis^T
+     *     + softabs_zero (I - basis basis^T).
+     */
+    class lanczos_softabs_point: public ps_point {
+    public:
+      explicit lanczos_softabs_point(int n):
+        ps_point(n),
+        alpha(1.0),
+        max_rank(n < 20 ? n : 20),
+        subspace(n, 0),
+        basis(n, 0),
+        lambda(0),
+        softabs_lambda(0),
+        softabs_lambda_inv(0),
+        softabs_zero(1.0),
+        log_det_metric(0),
+        pseudo_j(0, 0) {}
+
+      // SoftAbs regularization parameter
+      double alpha;
+
+      // Largest number of Lanczos steps
+      int max_rank;
+
+      // Orthonormal basis of the subspace, spanned at the first
+      // position the metric is computed at when empty
+      Eigen::MatrixXd subspace;
+
+      // Ritz vectors and values of the Hessian within the subspace
+      Eigen::MatrixXd basis;
+      Eigen::VectorXd lambda;
+
+      // SoftAbs transformed Ritz values, and the transform of a zero
+      // eigenvalue used outside of the Krylov subspace
+      Eigen::VectorXd softabs_lambda;
+      Eigen::VectorXd softabs_lambda_inv;
+      double softabs_zero;
+
+      // Log determinant of metric
+      double log_det_metric;
+
+      // Psuedo-Jacobian of the Ritz values
+      Eigen::MatrixXd pseudo_j;
+
+      int rank() const {
+        return basis.cols();
+      }
+
+      /**
+       * Discards the subspace so that the next metric computation
+       * spans a new one at its position.
+       */
+      void clear_subspace() {
+        subspace.resize(q.size(), 0);
+      }
+
+      virtual void
+      write_metric(stan::interface_callbacks::writer::base_writer& writer) {
+        writer("No free parameters for SoftAbs metric");
+      }
+
+      void save_state(stan::io::checkpoint_writer& checkpoint) {
+        ps_point::save_state(checkpoint);
+        checkpoint.write(alpha);
+        checkpoint.write(max_rank);
+        checkpoint.write(static_cast<int>(subspace.cols()));
+        checkpoint.write(rank());
+        checkpoint.write(subspace);
+        checkpoint.write(basis);
+        checkpoint.write(lambda);
+        checkpoint.write(softabs_lambda);
+        checkpoint.write(softabs_lambda_inv);
+        checkpoint.write(softabs_zero);
+        checkpoint.write(log_det_metric);
+        checkpoint.write(pseudo_j);
+      }
+
+      void load_state(stan::io::checkpoint_reader& checkpoint) {
+        ps_point::load_state(checkpoint);
+        checkpoint.read(alpha);
+        checkpoint.read(max_rank);
+        int m;
+        checkpoint.read(m);
+        int k;
+        checkpoint.read(k);
+        subspace.resize(q.size(), m);
+        basis.resize(q.size(), k);
+        lambda.resize(k);
+        softabs_lambda.resize(k);
+        softabs_lambda_inv.resize(k);
+        pseudo_j.resize(k, k);
+        checkpoint.read(subspace);
+        checkpoint.read(basis);
+        checkpoint.read(lambda);
+        checkpoint.read(softabs_lambda);
+        checkpoint.read(softabs_lambda_inv);
+        checkpoint.read(softabs_zero);
+        checkpoint.read(log_det_metric);
+        checkpoint.read(pseudo_j);
+      }
+    };
+
+  }  // mcmc
+}  // stan
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_E_METRIC_HPP
+#define STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_E_METRIC_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat/meta/index_type.hpp>
+#include <stan/mcmc/hmc/hamiltonians/base_hamiltonian.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_point.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <boost/random/normal_distribution.hpp>
+
+namespace stan {
+  namespace mcmc {
+
+    // Euclidean manifold with a diagonal plus low-rank metric
+    template <class Model, class BaseRNG>
+    class lowrank_e_metric
+      : public base_hamiltonian<Model, lowrank_e_point, BaseRNG> {
+    public:
+      explicit lowrank_e_metric(const Model& model)
+        : base_hamiltonian<Model, lowrank_e_point, BaseRNG>(model) {}
+
+      double T(lowrank_e_point& z) {
+        p_low_.noalias() = z.mInv_factor().transpose() * z.p;
+        return 0.5 * (z.p.dot(z.mInv_diag().cwiseProduct(z.p))
+                      + p_low_.squaredNorm());
+      }
+
+      double tau(lowrank_e_point& z) {
+        return T(z);
+      }
+
+      double phi(lowrank_e_point& z) {
+        return this->V(z);
+      }
+
+      double dG_dt(lowrank_e_point& z,
+                   interface_callbacks::writer::base_writer& info_writer,
+                   interface_callbacks::writer::base_writer& error_writer) {
+        return 2 * T(z) - z.q.dot(z.g);
+      }
+
+      Eigen::VectorXd dtau_dq(
+        lowrank_e_point& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        return Eigen::VectorXd::Zero(this->model_.num_params_r());
+      }
+
+      Eigen::VectorXd dtau_dp(lowrank_e_point& z) {
+        return z.mInv_diag().cwiseProduct(z.p)
+          + z.mInv_factor() * (z.mInv_factor().transpose() * z.p);
+      }
+
+      void dtau_dq_into(
+        lowrank_e_point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out.setZero(z.q.size());
+      }
+
+      void dtau_dp_into(lowrank_e_point& z, Eigen::VectorXd& out) {
+        out = z.mInv_diag().cwiseProduct(z.p);
+        p_low_.noalias() = z.mInv_factor().transpose() * z.p;
+        out.noalias() += z.mInv_factor() * p_low_;
+      }
+
+      void dphi_dq_into(
+        lowrank_e_point& z, Eigen::VectorXd& out,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        out = z.g;
+      }
+
+      Eigen::VectorXd dphi_dq(
+        lowrank_e_point& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        return z.g;
+      }
+
+      void sample_p(lowrank_e_point& z, BaseRNG& rng) {
+        typedef typename stan::math::index_type<Eigen::VectorXd>::type idx_t;
+        boost::variate_generator<BaseRNG&, boost::normal_distribution<> >
+          rand_lowrank_gaus(rng, boost::normal_distribution<>());
+
+        for (idx_t i = 0; i < z.p.size(); ++i)
+          z.p(i) = rand_lowrank_gaus();
+
+        if (z.rank() > 0) {
+          p_low_.noalias() = z.sample_basis().transpose() * z.p;
+          p_low_.array() *= z.sample_scale().array();
+          z.p.noalias() += z.sample_basis() * p_low_;
+        }
+        z.p.array() *= z.inv_sqrt_diag().array();
+      }
+
+    private:
+      // Workspace for the projection of the momentum onto the factor
+      Eigen::VectorXd p_low_;
+    };
+
+  }  // mcmc
+}  // stan
+#endif
@@ -0,0 +1,164 @@
+#ifndef STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_E_POINT_HPP
+#define STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_E_POINT_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <Eigen/Eigenvalues>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * Point in a phase space with a base Euclidean manifold whose
+     * inverse metric is a diagonal matrix plus a low-rank update,
+     * diag(mInv_diag) + mInv_factor * mInv_factor^T.
+     *
+     * The metric is set through set_metric, which also precomputes
+     * the basis used to draw momenta, so that every operation of the
+     * Hamiltonian costs O(D k) for D parameters and rank k.
+     */
+    class lowrank_e_point: public ps_point {
+    public:
+      explicit lowrank_e_point(int n)
+        : ps_point(n), mInv_diag_(Eigen::VectorXd::Ones(n)),
+          mInv_factor_(n, 0), inv_sqrt_diag_(Eigen::VectorXd::Ones(n)),
+          sample_basis_(n, 0), sample_scale_(0) {}
+
+      const Eigen::VectorXd& mInv_diag() const {
+        return mInv_diag_;
+      }
+
+      const Eigen::MatrixXd& mInv_factor() const {
+        return mInv_factor_;
+      }
+
+      int rank() const {
+        return mInv_factor_.cols();
+      }
+
+      /**
+       * Sets the inverse metric and refactors it.
+       *
+       * @param diag positive diagonal part, one element per parameter
+       * @param factor low-rank factor with one row per parameter
+       * @throw std::invalid_argument if the sizes do not match the
+       * point or the diagonal is not positive
+       */
+      void set_metric(const Eigen::VectorXd& diag,
+                      const Eigen::MatrixXd& factor) {
+        if (diag.size() != q.size() || factor.rows() != q.size())
+          throw std::invalid_argument("The low-rank metric does not match "
+                                      "the number of parameters");
+        for (int i = 0; i < diag.size(); ++i)
+          if (!(diag(i) > 0))
+            throw std::invalid_argument("The diagonal of the low-rank metric "
+                                        "must be positive");
+        mInv_diag_ = diag;
+        mInv_factor_ = factor;
+        factor_();
+      }
+
+      /**
+       * Returns the diagonal of the full inverse metric.
+       */
+      Eigen::VectorXd mInv_full_diag() const {
+        return mInv_diag_ + mInv_factor_.rowwise().squaredNorm();
+      }
+
+      // Momenta are drawn as diag(inv_sqrt_diag) (u + B diag(s) B^T u)
+      // for u standard normal, which has covariance equal to the
+      // metric.
+      const Eigen::VectorXd& inv_sqrt_diag() const {
+        return inv_sqrt_diag_;
+      }
+
+      const Eigen::MatrixXd& sample_basis() const {
+        return sample_basis_;
+      }
+
+      const Eigen::VectorXd& sample_scale() const {
+        return sample_scale_;
+      }
+
+      void
+      write_metric(stan::interface_callbacks::writer::base_writer& writer) {
+        writer("Diagonal elements of inverse mass matrix:");
+        std::stringstream mInv_ss;
+        mInv_ss << mInv_diag_(0);
+        for (int i = 1; i < mInv_diag_.size(); ++i)
+          mInv_ss << ", " << mInv_diag_(i);
+        writer(mInv_ss.str());
+
+        writer("Low-rank factor of inverse mass matrix:");
+        for (int j = 0; j < mInv_factor_.cols(); ++j) {
+          mInv_ss.str("");
+          mInv_ss << mInv_factor_(0, j);
+          for (int i = 1; i < mInv_factor_.rows(); ++i)
+            mInv_ss << ", " << mInv_factor_(i, j);
+          writer(mInv_ss.str());
+        }
+      }
+
+      void save_state(stan::io::checkpoint_writer& checkpoint) {
+        ps_point::save_state(checkpoint);
+        checkpoint.write(mInv_diag_);
+        checkpoint.write(rank());
+        checkpoint.write(mInv_factor_);
+      }
+
+      void load_state(stan::io::checkpoint_reader& checkpoint) {
+        ps_point::load_state(checkpoint);
+        checkpoint.read(mInv_diag_);
+        int k;
+        checkpoint.read(k);
+        mInv_factor_.resize(q.size(), k);
+        checkpoint.read(mInv_factor_);
+        factor_();
+      }
+
+    protected:
+      Eigen::VectorXd mInv_diag_;
+      Eigen::MatrixXd mInv_factor_;
+
+      Eigen::VectorXd inv_sqrt_diag_;
+      Eigen::MatrixXd sample_basis_;
+      Eigen::VectorXd sample_scale_;
+
+      // With V = diag(mInv_diag)^(-1/2) mInv_factor the inverse metric
+      // is diag^(1/2) (I + V V^T) diag^(1/2).  The eigendecomposition
+      // of the k x k matrix V^T V gives an orthonormal basis B of the
+      // span of V and the inverse square root of I + V V^T as
+      // I + B diag(1 / sqrt(1 + sigma^2) - 1) B^T.
+      void factor_() {
+        inv_sqrt_diag_ = mInv_diag_.array().rsqrt();
+
+        int k = mInv_factor_.cols();
+        sample_basis_.resize(q.size(), k);
+        sample_scale_.resize(k);
+        if (k == 0)
+          return;
+
+        Eigen::MatrixXd V = inv_sqrt_diag_.asDiagonal() * mInv_factor_;
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd>
+          solver(V.transpose() * V);
+
+        for (int j = 0; j < k; ++j) {
+          double sigma2 = solver.eigenvalues()(j);
+          if (sigma2 > 1e-12) {
+            sample_basis_.col(j) = V * solver.eigenvectors().col(j)
+              / std::sqrt(sigma2);
+            sample_scale_(j) = 1.0 / std::sqrt(1.0 + sigma2) - 1.0;
+          } else {
+            sample_basis_.col(j).setZero();
+            sample_scale_(j) = 0;
+          }
+        }
+      }
+    };
+
+  }  // mcmc
+}  // stan
+
+#endif
@@ -2,8 +2,10 @@
 #define STAN_MCMC_HMC_HAMILTONIANS_PS_POINT_HPP
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/io/checkpoint.hpp>
 #include <stan/math/prim/mat/fun/Eigen.hpp>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -42,6 +44,21 @@ namespace stan {
         return *this;
       }
 
+      /**
+       * Exchanges the position, momentum, potential and gradient with
+       * another point by swapping the vectors' storage, without
+       * copying any element.  As with operator=, the state of derived
+       * points is left untouched.
+       *
+       * @param z point to swap with
+       */
+      void swap(ps_point& z) {
+        q.swap(z.q);
+        p.swap(z.p);
+        std::swap(V, z.V);
+        g.swap(z.g);
+      }
+
       Eigen::VectorXd q;
       Eigen::VectorXd p;
 
@@ -75,6 +92,30 @@ namespace stan {
       virtual void
       write_metric(stan::interface_callbacks::writer::base_writer& writer) {}
 
+      /**
+       * Writes the point to a checkpoint
+       *
+       * @param checkpoint checkpoint writer
+       */
+      virtual void save_state(stan::io::checkpoint_writer& checkpoint) {
+        checkpoint.write(q);
+        checkpoint.write(p);
+        checkpoint.write(V);
+        checkpoint.write(g);
+      }
+
+      /**
+       * Restores the point from a checkpoint
+       *
+       * @param checkpoint checkpoint reader
+       */
+      virtual void load_state(stan::io::checkpoint_reader& checkpoint) {
+        checkpoint.read(q);
+        checkpoint.read(p);
+        checkpoint.read(V);
+        checkpoint.read(g);
+      }
+
     protected:
       template <typename T>
       static inline void
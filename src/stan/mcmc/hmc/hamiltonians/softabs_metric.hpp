@@ -116,6 +116,13 @@ namespace stan {
         update_metric_gradient(z, info_writer, error_writer);
       }
 
+      // The metric and its gradient live outside of ps_point and are
+      // not restored along with a rejected proposal, so every
+      // trajectory has to start from init.
+      bool reuses_point_state() {
+        return false;
+      }
+
       void update_metric(
         softabs_point& z,
         interface_callbacks::writer::base_writer& info_writer,
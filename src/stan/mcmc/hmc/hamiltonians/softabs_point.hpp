@@ -44,6 +44,29 @@ namespace stan {
       write_metric(stan::interface_callbacks::writer::base_writer& writer) {
         writer("No free parameters for SoftAbs metric");
       }
+
+      void save_state(stan::io::checkpoint_writer& checkpoint) {
+        ps_point::save_state(checkpoint);
+        checkpoint.write(alpha);
+        checkpoint.write(hessian);
+        checkpoint.write(log_det_metric);
+        checkpoint.write(softabs_lambda);
+        checkpoint.write(softabs_lambda_inv);
+        checkpoint.write(pseudo_j);
+      }
+
+      // The eigendecomposition is recomputed from the restored Hessian,
+      // which reproduces it exactly
+      void load_state(stan::io::checkpoint_reader& checkpoint) {
+        ps_point::load_state(checkpoint);
+        checkpoint.read(alpha);
+        checkpoint.read(hessian);
+        eigen_deco.compute(hessian);
+        checkpoint.read(log_det_metric);
+        checkpoint.read(softabs_lambda);
+        checkpoint.read(softabs_lambda_inv);
+        checkpoint.read(pseudo_j);
+      }
     };
 
   }  // mcmc
@@ -0,0 +1,81 @@
+#ifndef STAN_MCMC_HMC_INTEGRATORS_BASE_SPLITTING_HPP
+#define STAN_MCMC_HMC_INTEGRATORS_BASE_SPLITTING_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/mcmc/hmc/integrators/base_integrator.hpp>
+#include <vector>
+
+namespace stan {
+  namespace mcmc {
+
+    /**
+     * Explicit palindromic splitting integrator for separable
+     * Hamiltonians.  A step of size epsilon alternates momentum
+     * kicks and position drifts,
+     *
+     *   kick(b_0 epsilon) drift(a_0 epsilon) kick(b_1 epsilon) ...
+     *   drift(a_{s-1} epsilon) kick(b_s epsilon),
+     *
+     * and costs one gradient per drift.  The leapfrog is the one
+     * stage case with a = {1} and b = {1/2, 1/2}; derived classes set
+     * the coefficients of schemes with more stages.
+     */
+    template <class Hamiltonian>
+    class base_splitting : public base_integrator<Hamiltonian> {
+    public:
+      base_splitting()
+        : base_integrator<Hamiltonian>() {}
+
+      void evolve(typename Hamiltonian::PointType& z,
+                  Hamiltonian& hamiltonian,
+                  const double epsilon,
+                  interface_callbacks::writer::base_writer& info_writer,
+                  interface_callbacks::writer::base_writer& error_writer) {
+        for (size_t n = 0; n < drift_.size(); ++n) {
+          update_p(z, hamiltonian, kick_[n] * epsilon,
+                   info_writer, error_writer);
+          update_q(z, hamiltonian, drift_[n] * epsilon,
+                   info_writer, error_writer);
+        }
+        update_p(z, hamiltonian, kick_.back() * epsilon,
+                 info_writer, error_writer);
+      }
+
+      /**
+       * Returns the number of gradient evaluations in a step.
+       */
+      int num_stages() const {
+        return drift_.size();
+      }
+
+    protected:
+      // Coefficients of the kicks, one more than of the drifts
+      std::vector<double> kick_;
+      std::vector<double> drift_;
+
+      // Reused across stages so that a step does not allocate
+      Eigen::VectorXd dphi_dq_;
+      Eigen::VectorXd dtau_dp_;
+
+      void update_p(typename Hamiltonian::PointType& z,
+                    Hamiltonian& hamiltonian, double epsilon,
+                    interface_callbacks::writer::base_writer& info_writer,
+                    interface_callbacks::writer::base_writer& error_writer) {
+        hamiltonian.dphi_dq_into(z, dphi_dq_, info_writer, error_writer);
+        z.p -= epsilon * dphi_dq_;
+      }
+
+      void update_q(typename Hamiltonian::PointType& z,
+                    Hamiltonian& hamiltonian, double epsilon,
+                    interface_callbacks::writer::base_writer& info_writer,
+                    interface_callbacks::writer::base_writer& error_writer) {
+        hamiltonian.dtau_dp_into(z, dtau_dp_);
+        z.q += epsilon * dtau_dp_;
+        hamiltonian.update_potential_gradient(z, info_writer, error_writer);
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
@@ -18,14 +18,16 @@ namespace stan {
         Hamiltonian& hamiltonian, double epsilon,
         interface_callbacks::writer::base_writer& info_writer,
         interface_callbacks::writer::base_writer& error_writer) {
-        z.p -= epsilon * hamiltonian.dphi_dq(z, info_writer, error_writer);
+        hamiltonian.dphi_dq_into(z, dphi_dq_, info_writer, error_writer);
+        z.p -= epsilon * dphi_dq_;
       }
 
       void update_q(typename Hamiltonian::PointType& z,
                     Hamiltonian& hamiltonian, double epsilon,
                     interface_callbacks::writer::base_writer& info_writer,
                     interface_callbacks::writer::base_writer& error_writer) {
-        z.q += epsilon * hamiltonian.dtau_dp(z);
+        hamiltonian.dtau_dp_into(z, dtau_dp_);
+        z.q += epsilon * dtau_dp_;
         hamiltonian.update_potential_gradient(z, info_writer, error_writer);
       }
 
@@ -34,8 +36,14 @@ namespace stan {
         Hamiltonian& hamiltonian, double epsilon,
         interface_callbacks::writer::base_writer& info_writer,
         interface_callbacks::writer::base_writer& error_writer) {
-        z.p -= epsilon * hamiltonian.dphi_dq(z, info_writer, error_writer);
+        hamiltonian.dphi_dq_into(z, dphi_dq_, info_writer, error_writer);
+        z.p -= epsilon * dphi_dq_;
       }
+
+    private:
+      // Reused across steps so that a step does not allocate
+      Eigen::VectorXd dphi_dq_;
+      Eigen::VectorXd dtau_dp_;
     };
 
   }  // mcmc
@@ -0,0 +1,40 @@
+#ifndef STAN_MCMC_HMC_INTEGRATORS_EXPL_THREE_STAGE_HPP
+#define STAN_MCMC_HMC_INTEGRATORS_EXPL_THREE_STAGE_HPP
+
+#include <stan/mcmc/hmc/integrators/base_splitting.hpp>
+
+namespace stan {
+  namespace mcmc {
+
+    /**
+     * Three stage splitting integrator of Blanes, Casas and
+     * Sanz-Serna (2014), with the coefficients chosen to minimize
+     * the expected energy error for Gaussian targets,
+     *
+     *   kick(b epsilon) drift(a epsilon) kick((1/2 - b) epsilon)
+     *   drift((1 - 2 a) epsilon) kick((1/2 - b) epsilon)
+     *   drift(a epsilon) kick(b epsilon).
+     *
+     * A step costs three gradients and is stable up to about 4.6
+     * over the largest frequency of the target.
+     */
+    template <class Hamiltonian>
+    class expl_three_stage : public base_splitting<Hamiltonian> {
+    public:
+      expl_three_stage()
+        : base_splitting<Hamiltonian>() {
+        double a = 0.29619504261126;
+        double b = 0.11888010966548;
+        this->kick_.push_back(b);
+        this->kick_.push_back(0.5 - b);
+        this->kick_.push_back(0.5 - b);
+        this->kick_.push_back(b);
+        this->drift_.push_back(a);
+        this->drift_.push_back(1 - 2 * a);
+        this->drift_.push_back(a);
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
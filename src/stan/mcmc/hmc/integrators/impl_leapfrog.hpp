@@ -31,16 +31,17 @@ namespace stan {
                     interface_callbacks::writer::base_writer& info_writer,
                     interface_callbacks::writer::base_writer& error_writer) {
         // hat{T} = dT/dp * d/dq
-        Eigen::VectorXd q_init = z.q + 0.5 * epsilon * hamiltonian.dtau_dp(z);
-        Eigen::VectorXd delta_q(z.q.size());
+        hamiltonian.dtau_dp_into(z, dz_);
+        q_init_ = z.q + 0.5 * epsilon * dz_;
 
         for (int n = 0; n < this->max_num_fixed_point_; ++n) {
-          delta_q = z.q;
-          z.q.noalias() = q_init + 0.5 * epsilon * hamiltonian.dtau_dp(z);
+          delta_ = z.q;
+          hamiltonian.dtau_dp_into(z, dz_);
+          z.q = q_init_ + 0.5 * epsilon * dz_;
           hamiltonian.update_metric(z, info_writer, error_writer);
 
-          delta_q -= z.q;
-          if (delta_q.cwiseAbs().maxCoeff() < this->fixed_point_threshold_)
+          delta_ -= z.q;
+          if (delta_.cwiseAbs().maxCoeff() < this->fixed_point_threshold_)
             break;
         }
         hamiltonian.update_gradients(z, info_writer, error_writer);
@@ -62,7 +63,8 @@ namespace stan {
                    double epsilon,
                    interface_callbacks::writer::base_writer& info_writer,
                    interface_callbacks::writer::base_writer& error_writer) {
-        z.p -= epsilon * hamiltonian.dphi_dq(z, info_writer, error_writer);
+        hamiltonian.dphi_dq_into(z, dz_, info_writer, error_writer);
+        z.p -= epsilon * dz_;
       }
 
       // hat{tau} = dtau/dq * d/dp
@@ -72,16 +74,14 @@ namespace stan {
                    int num_fixed_point,
                    interface_callbacks::writer::base_writer& info_writer,
                    interface_callbacks::writer::base_writer& error_writer) {
-        Eigen::VectorXd p_init = z.p;
-        Eigen::VectorXd delta_p(z.p.size());
+        p_init_ = z.p;
 
         for (int n = 0; n < num_fixed_point; ++n) {
-          delta_p = z.p;
-          z.p.noalias() = p_init
-                          - epsilon
-                          * hamiltonian.dtau_dq(z, info_writer, error_writer);
-          delta_p -= z.p;
-          if (delta_p.cwiseAbs().maxCoeff() < this->fixed_point_threshold_)
+          delta_ = z.p;
+          hamiltonian.dtau_dq_into(z, dz_, info_writer, error_writer);
+          z.p = p_init_ - epsilon * dz_;
+          delta_ -= z.p;
+          if (delta_.cwiseAbs().maxCoeff() < this->fixed_point_threshold_)
             break;
         }
       }
@@ -105,6 +105,13 @@ namespace stan {
     private:
       int max_num_fixed_point_;
       double fixed_point_threshold_;
+
+      // Reused across steps so that the fixed point iterations do not
+      // allocate beyond what the metric itself needs
+      Eigen::VectorXd q_init_;
+      Eigen::VectorXd p_init_;
+      Eigen::VectorXd delta_;
+      Eigen::VectorXd dz_;
     };
 
   }  // mcmc
@@ -12,12 +12,14 @@ namespace stan {
      * with a Gaussian-Euclidean disintegration and adaptive
      * dense metric and adaptive step size
      */
-    template <class Model, class BaseRNG>
-    class adapt_dense_e_nuts : public dense_e_nuts<Model, BaseRNG>,
-                               public stepsize_covar_adapter {
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class adapt_dense_e_nuts
+      : public dense_e_nuts<Model, BaseRNG, Integrator>,
+        public stepsize_covar_adapter {
     public:
         adapt_dense_e_nuts(const Model& model, BaseRNG& rng)
-          : dense_e_nuts<Model, BaseRNG>(model, rng),
+          : dense_e_nuts<Model, BaseRNG, Integrator>(model, rng),
           stepsize_covar_adapter(model.num_params_r()) {}
 
       ~adapt_dense_e_nuts() {}
@@ -26,18 +28,21 @@ namespace stan {
       transition(sample& init_sample,
                  interface_callbacks::writer::base_writer& info_writer,
                  interface_callbacks::writer::base_writer& error_writer) {
-        sample s = dense_e_nuts<Model, BaseRNG>::transition(init_sample,
-                                                            info_writer,
-                                                            error_writer);
+        sample s
+          = dense_e_nuts<Model, BaseRNG, Integrator>::transition(
+              init_sample, info_writer, error_writer);
 
         if (this->adapt_flag_) {
           this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
                                                     s.accept_stat());
 
-          bool update = this->covar_adaptation_.learn_covariance(this->z_.mInv,
+          bool update = this->covar_adaptation_.learn_covariance(this->covar_,
                                                                  this->z_.q);
 
           if (update) {
+            this->z_.set_mInv(this->covar_);
+            this->update_schedule(this->covar_, info_writer);
+
             this->init_stepsize(info_writer, error_writer);
 
             this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
@@ -49,6 +54,8 @@ namespace stan {
 
       void disengage_adaptation() {
         base_adapter::disengage_adaptation();
+        if (this->covar_adaptation_.pick_up_pooled_covariance(this->covar_))
+          this->z_.set_mInv(this->covar_);
         this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
       }
     };
@@ -12,12 +12,14 @@ namespace stan {
      * with a Gaussian-Euclidean disintegration and adaptive
      * diagonal metric and adaptive step size
      */
-    template <class Model, class BaseRNG>
-    class adapt_diag_e_nuts: public diag_e_nuts<Model, BaseRNG>,
-                             public stepsize_var_adapter {
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class adapt_diag_e_nuts
+      : public diag_e_nuts<Model, BaseRNG, Integrator>,
+        public stepsize_var_adapter {
     public:
         adapt_diag_e_nuts(const Model& model, BaseRNG& rng)
-          : diag_e_nuts<Model, BaseRNG>(model, rng),
+          : diag_e_nuts<Model, BaseRNG, Integrator>(model, rng),
           stepsize_var_adapter(model.num_params_r()) {}
 
       ~adapt_diag_e_nuts() {}
@@ -26,9 +28,9 @@ namespace stan {
       transition(sample& init_sample,
                  interface_callbacks::writer::base_writer& info_writer,
                  interface_callbacks::writer::base_writer& error_writer) {
-        sample s = diag_e_nuts<Model, BaseRNG>::transition(init_sample,
-                                                           info_writer,
-                                                           error_writer);
+        sample s
+          = diag_e_nuts<Model, BaseRNG, Integrator>::transition(
+              init_sample, info_writer, error_writer);
 
         if (this->adapt_flag_) {
           this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
@@ -38,6 +40,8 @@ namespace stan {
                                                              this->z_.q);
 
           if (update) {
+            this->update_schedule(this->z_.mInv, info_writer);
+
             this->init_stepsize(info_writer, error_writer);
 
             this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
@@ -49,6 +53,7 @@ namespace stan {
 
       void disengage_adaptation() {
         base_adapter::disengage_adaptation();
+        this->var_adaptation_.pick_up_pooled_variance(this->z_.mInv);
         this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
       }
     };
@@ -0,0 +1,54 @@
+#ifndef STAN_MCMC_HMC_NUTS_ADAPT_LANCZOS_SOFTABS_NUTS_HPP
+#define STAN_MCMC_HMC_NUTS_ADAPT_LANCZOS_SOFTABS_NUTS_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/hmc/nuts/lanczos_softabs_nuts.hpp>
+#include <stan/mcmc/stepsize_adapter.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * The No-U-Turn sampler (NUTS) with multinomial sampling
+     * with a Gaussian-Riemannian disintegration and matrix-free
+     * SoftAbs metric and adaptive step size
+     */
+    template <class Model, class BaseRNG>
+    class adapt_lanczos_softabs_nuts
+      : public lanczos_softabs_nuts<Model, BaseRNG>,
+        public stepsize_adapter {
+    public:
+      adapt_lanczos_softabs_nuts(const Model& model, BaseRNG& rng)
+        : lanczos_softabs_nuts<Model, BaseRNG>(model, rng) {}
+
+      ~adapt_lanczos_softabs_nuts() {}
+
+      sample transition(
+        sample& init_sample,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        // The subspace of the metric follows the chain while adapting
+        // and is kept once adaptation is disengaged
+        if (this->adapt_flag_)
+          this->z_.clear_subspace();
+
+        sample s
+          = lanczos_softabs_nuts<Model, BaseRNG>::transition(init_sample,
+                                                             info_writer,
+                                                             error_writer);
+
+        if (this->adapt_flag_)
+          this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
+                                                    s.accept_stat());
+
+        return s;
+      }
+
+      void disengage_adaptation() {
+        base_adapter::disengage_adaptation();
+        this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
@@ -23,7 +23,12 @@ namespace stan {
       base_nuts(const Model& model, BaseRNG& rng)
         : base_hmc<Model, Hamiltonian, Integrator, BaseRNG>(model, rng),
           depth_(0), max_depth_(5), max_deltaH_(1000),
-          n_leapfrog_(0), divergent_(0), energy_(0) {
+          n_leapfrog_(0), divergent_(0), energy_(0),
+          z_plus_(model.num_params_r()), z_minus_(model.num_params_r()),
+          z_sample_(model.num_params_r()), z_propose_(model.num_params_r()),
+          p_sharp_plus_(model.num_params_r()),
+          p_sharp_minus_(model.num_params_r()),
+          rho_(model.num_params_r()), rho_subtree_(model.num_params_r()) {
       }
 
       ~base_nuts() {}
@@ -47,20 +52,19 @@ namespace stan {
         // Initialize the algorithm
         this->sample_stepsize();
 
-        this->seed(init_sample.cont_params());
+        this->begin_transition_(init_sample.cont_params(),
+                                info_writer, error_writer);
 
-        this->hamiltonian_.sample_p(this->z_, this->rand_int_);
-        this->hamiltonian_.init(this->z_, info_writer, error_writer);
+        resize_workspace_(this->max_depth_, this->z_.q.size());
 
-        ps_point z_plus(this->z_);
-        ps_point z_minus(z_plus);
+        z_plus_ = this->z_;
+        z_minus_ = z_plus_;
 
-        ps_point z_sample(z_plus);
-        ps_point z_propose(z_plus);
+        z_sample_ = z_plus_;
 
-        Eigen::VectorXd p_sharp_plus = this->hamiltonian_.dtau_dp(this->z_);
-        Eigen::VectorXd p_sharp_minus = this->hamiltonian_.dtau_dp(this->z_);
-        Eigen::VectorXd rho = this->z_.p;
+        this->hamiltonian_.dtau_dp_into(this->z_, p_sharp_plus_);
+        p_sharp_minus_ = p_sharp_plus_;
+        rho_ = this->z_.p;
         double sum_weight = 1;
 
         double H0 = this->hamiltonian_.H(this->z_);
@@ -72,31 +76,33 @@ namespace stan {
         this->divergent_ = 0;
 
         while (this->depth_ < this->max_depth_) {
-          // Build a new subtree in a random direction
-          Eigen::VectorXd rho_subtree(rho.size());
-          rho_subtree.setZero();
+          // Build a new subtree in a random direction.  Subtrees are
+          // built one at a time: extending both directions speculatively
+          // would put two gradient evaluations in flight at once, and
+          // the autodiff stack is a single global arena.
+          rho_subtree_.setZero();
 
           bool valid_subtree = false;
           double sum_weight_subtree = 0;
 
           if (this->rand_uniform_() > 0.5) {
-            this->z_.ps_point::operator=(z_plus);
+            this->z_.ps_point::operator=(z_plus_);
             valid_subtree
-              = build_tree(this->depth_, rho_subtree, z_propose,
+              = build_tree(this->depth_, rho_subtree_, z_propose_,
                            H0, 1, n_leapfrog,
                            sum_weight_subtree, sum_metro_prob,
                            info_writer, error_writer);
-            z_plus.ps_point::operator=(this->z_);
-            p_sharp_plus = this->hamiltonian_.dtau_dp(this->z_);
+            this->hamiltonian_.dtau_dp_into(this->z_, p_sharp_plus_);
+            z_plus_.swap(this->z_);
           } else {
-            this->z_.ps_point::operator=(z_minus);
+            this->z_.ps_point::operator=(z_minus_);
             valid_subtree
-              = build_tree(this->depth_, rho_subtree, z_propose,
+              = build_tree(this->depth_, rho_subtree_, z_propose_,
                            H0, -1, n_leapfrog,
                            sum_weight_subtree, sum_metro_prob,
                            info_writer, error_writer);
-            z_minus.ps_point::operator=(this->z_);
-            p_sharp_minus = this->hamiltonian_.dtau_dp(this->z_);
+            this->hamiltonian_.dtau_dp_into(this->z_, p_sharp_minus_);
+            z_minus_.swap(this->z_);
           }
 
           sum_weight += sum_weight_subtree;
@@ -107,11 +113,11 @@ namespace stan {
 
           double accept_prob = sum_weight_subtree / sum_weight;
           if (this->rand_uniform_() < accept_prob)
-            z_sample = z_propose;
+            z_sample_.swap(z_propose_);
 
           // Break when NUTS criterion is not longer satisfied
-          rho += rho_subtree;
-          if (!compute_criterion(p_sharp_minus, p_sharp_plus, rho))
+          rho_ += rho_subtree_;
+          if (!compute_criterion(p_sharp_minus_, p_sharp_plus_, rho_))
             break;
         }
 
@@ -122,11 +128,36 @@ namespace stan {
         double accept_prob
           = sum_metro_prob / static_cast<double>(n_leapfrog + 1);
 
-        this->z_.ps_point::operator=(z_sample);
+        this->z_.swap(z_sample_);
         this->energy_ = this->hamiltonian_.H(this->z_);
+        this->end_transition_();
         return sample(this->z_.q, -this->z_.V, accept_prob);
       }
 
+      void save_state(io::checkpoint_writer& checkpoint) {
+        base_hmc<Model, Hamiltonian, Integrator, BaseRNG>
+          ::save_state(checkpoint);
+        checkpoint.begin_section("nuts");
+        checkpoint.write(this->depth_);
+        checkpoint.write(this->max_depth_);
+        checkpoint.write(this->max_deltaH_);
+        checkpoint.write(this->n_leapfrog_);
+        checkpoint.write(this->divergent_);
+        checkpoint.write(this->energy_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        base_hmc<Model, Hamiltonian, Integrator, BaseRNG>
+          ::load_state(checkpoint);
+        checkpoint.begin_section("nuts");
+        checkpoint.read(this->depth_);
+        checkpoint.read(this->max_depth_);
+        checkpoint.read(this->max_deltaH_);
+        checkpoint.read(this->n_leapfrog_);
+        checkpoint.read(this->divergent_);
+        checkpoint.read(this->energy_);
+      }
+
       void get_sampler_param_names(std::vector<std::string>& names) {
         names.push_back("stepsize__");
         names.push_back("treedepth__");
@@ -179,9 +210,13 @@ namespace stan {
             return !this->divergent_;
         }
         // General recursion
-        Eigen::VectorXd p_sharp_left = this->hamiltonian_.dtau_dp(this->z_);
+        resize_workspace_(depth, rho.size());
+        subtree_workspace& ws = workspace_[depth];
+
+        Eigen::VectorXd& p_sharp_left = ws.p_sharp_left;
+        this->hamiltonian_.dtau_dp_into(this->z_, p_sharp_left);
 
-        Eigen::VectorXd rho_subtree(rho.size());
+        Eigen::VectorXd& rho_subtree = ws.rho_subtree;
         rho_subtree.setZero();
 
         // Build the left subtree
@@ -196,8 +231,9 @@ namespace stan {
         sum_weight += sum_weight_left;
         if (!valid_left) return false;
 
-        // Build the right subtree
-        ps_point z_propose_right(this->z_);
+        // Build the right subtree, whose first leaf
+        // always overwrites its proposal
+        ps_point& z_propose_right = ws.z_propose_right;
         double sum_weight_right = 0;
 
         bool valid_right
@@ -212,10 +248,11 @@ namespace stan {
         // Multinomial sample from right subtree
         double accept_prob = sum_weight_right / sum_weight;
         if (this->rand_uniform_() < accept_prob)
-          z_propose = z_propose_right;
+          z_propose.swap(z_propose_right);
 
         rho += rho_subtree;
-        Eigen::VectorXd p_sharp_right = this->hamiltonian_.dtau_dp(this->z_);
+        Eigen::VectorXd& p_sharp_right = ws.p_sharp_right;
+        this->hamiltonian_.dtau_dp_into(this->z_, p_sharp_right);
         return compute_criterion(p_sharp_left, p_sharp_right, rho_subtree);
       }
 
@@ -226,6 +263,51 @@ namespace stan {
       int n_leapfrog_;
       int divergent_;
       double energy_;
+
+    protected:
+      /**
+       * Buffers used by one level of the recursion in build_tree.
+       */
+      struct subtree_workspace {
+        explicit subtree_workspace(int n)
+          : p_sharp_left(n), p_sharp_right(n), rho_subtree(n),
+            z_propose_right(n) {}
+
+        Eigen::VectorXd p_sharp_left;
+        Eigen::VectorXd p_sharp_right;
+        Eigen::VectorXd rho_subtree;
+        ps_point z_propose_right;
+      };
+
+      /**
+       * Grows the workspace so that it holds buffers of dimension n
+       * for every depth up to and including the given depth.  The
+       * buffers are kept across transitions, so only the first
+       * transition, or a change in the maximum depth, allocates.
+       *
+       * @param depth largest tree depth that will be built
+       * @param n dimension of the buffers
+       */
+      void resize_workspace_(int depth, int n) {
+        if (!workspace_.empty() && workspace_[0].rho_subtree.size() != n)
+          workspace_.clear();
+        if (static_cast<int>(workspace_.size()) <= depth)
+          workspace_.resize(depth + 1, subtree_workspace(n));
+      }
+
+      // Trajectory state reused across transitions
+      ps_point z_plus_;
+      ps_point z_minus_;
+      ps_point z_sample_;
+      ps_point z_propose_;
+
+      Eigen::VectorXd p_sharp_plus_;
+      Eigen::VectorXd p_sharp_minus_;
+      Eigen::VectorXd rho_;
+      Eigen::VectorXd rho_subtree_;
+
+      // Subtree buffers indexed by depth
+      std::vector<subtree_workspace> workspace_;
     };
 
   }  // mcmc
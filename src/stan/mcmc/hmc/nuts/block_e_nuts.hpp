@@ -0,0 +1,27 @@
+#ifndef STAN_MCMC_HMC_NUTS_BLOCK_E_NUTS_HPP
+#define STAN_MCMC_HMC_NUTS_BLOCK_E_NUTS_HPP
+
+#include <stan/mcmc/hmc/nuts/base_nuts.hpp>
+#include <stan/mcmc/hmc/hamiltonians/block_e_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/block_e_metric.hpp>
+#include <stan/mcmc/hmc/integrators/expl_leapfrog.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * The No-U-Turn sampler (NUTS) with multinomial sampling
+     * with a Gaussian-Euclidean disintegration and block diagonal metric
+     */
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class block_e_nuts : public base_nuts<Model, block_e_metric,
+                                          Integrator, BaseRNG> {
+    public:
+      block_e_nuts(const Model& model, BaseRNG& rng)
+        : base_nuts<Model, block_e_metric, Integrator,
+                    BaseRNG>(model, rng) { }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
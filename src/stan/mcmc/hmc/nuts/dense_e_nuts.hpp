@@ -12,12 +12,13 @@ namespace stan {
      * The No-U-Turn sampler (NUTS) with multinomial sampling
      * with a Gaussian-Euclidean disintegration and dense metric
      */
-    template <class Model, class BaseRNG>
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
     class dense_e_nuts : public base_nuts<Model, dense_e_metric,
-                                          expl_leapfrog, BaseRNG> {
+                                          Integrator, BaseRNG> {
     public:
       dense_e_nuts(const Model& model, BaseRNG& rng)
-        : base_nuts<Model, dense_e_metric, expl_leapfrog,
+        : base_nuts<Model, dense_e_metric, Integrator,
                     BaseRNG>(model, rng) { }
     };
 
@@ -12,12 +12,13 @@ namespace stan {
      * The No-U-Turn sampler (NUTS) with multinomial sampling
      * with a Gaussian-Euclidean disintegration and diagonal metric
      */
-    template <class Model, class BaseRNG>
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
     class diag_e_nuts : public base_nuts<Model, diag_e_metric,
-                                         expl_leapfrog, BaseRNG> {
+                                         Integrator, BaseRNG> {
     public:
       diag_e_nuts(const Model& model, BaseRNG& rng)
-        : base_nuts<Model, diag_e_metric, expl_leapfrog,
+        : base_nuts<Model, diag_e_metric, Integrator,
                     BaseRNG>(model, rng) { }
     };
 
@@ -0,0 +1,28 @@
+#ifndef STAN_MCMC_HMC_NUTS_LOWRANK_E_NUTS_HPP
+#define STAN_MCMC_HMC_NUTS_LOWRANK_E_NUTS_HPP
+
+#include <stan/mcmc/hmc/nuts/base_nuts.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_metric.hpp>
+#include <stan/mcmc/hmc/integrators/expl_leapfrog.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * The No-U-Turn sampler (NUTS) with multinomial sampling
+     * with a Gaussian-Euclidean disintegration and diagonal plus
+     * low-rank metric
+     */
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class lowrank_e_nuts : public base_nuts<Model, lowrank_e_metric,
+                                          Integrator, BaseRNG> {
+    public:
+      lowrank_e_nuts(const Model& model, BaseRNG& rng)
+        : base_nuts<Model, lowrank_e_metric, Integrator,
+                    BaseRNG>(model, rng) { }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
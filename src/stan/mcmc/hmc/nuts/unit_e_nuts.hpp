@@ -12,13 +12,14 @@ namespace stan {
      * The No-U-Turn sampler (NUTS) with multinomial sampling
      * with a Gaussian-Euclidean disintegration and unit metric
      */
-    template <class Model, class BaseRNG>
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
     class unit_e_nuts
       : public base_nuts<Model, unit_e_metric,
-                         expl_leapfrog, BaseRNG> {
+                         Integrator, BaseRNG> {
     public:
       unit_e_nuts(const Model& model, BaseRNG& rng)
-        : base_nuts<Model, unit_e_metric, expl_leapfrog,
+        : base_nuts<Model, unit_e_metric, Integrator,
                     BaseRNG>(model, rng) { }
     };
 
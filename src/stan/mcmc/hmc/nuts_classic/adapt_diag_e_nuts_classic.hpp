@@ -40,6 +40,8 @@ namespace stan {
                                                              this->z_.q);
 
           if (update) {
+            this->update_schedule(this->z_.mInv, info_writer);
+
             this->init_stepsize(info_writer);
 
             this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
@@ -51,6 +53,7 @@ namespace stan {
 
       void disengage_adaptation() {
         base_adapter::disengage_adaptation();
+        this->var_adaptation_.pick_up_pooled_variance(this->z_.mInv);
         this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
       }
     };
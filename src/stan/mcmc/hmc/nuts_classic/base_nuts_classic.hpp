@@ -1,5 +1,5 @@
-#ifndef STAN_MCMC_HMC_NUTS_BASE_NUTS_HPP
-#define STAN_MCMC_HMC_NUTS_BASE_NUTS_HPP
+#ifndef STAN_MCMC_HMC_NUTS_CLASSIC_BASE_NUTS_CLASSIC_HPP
+#define STAN_MCMC_HMC_NUTS_CLASSIC_BASE_NUTS_CLASSIC_HPP
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
@@ -36,7 +36,11 @@ namespace stan {
       base_nuts_classic(const Model& model, BaseRNG& rng):
         base_hmc<Model, Hamiltonian, Integrator, BaseRNG>(model, rng),
         depth_(0), max_depth_(5), max_delta_(1000),
-        n_leapfrog_(0), divergent_(0), energy_(0) {
+        n_leapfrog_(0), divergent_(0), energy_(0),
+        z_plus_(model.num_params_r()), z_minus_(model.num_params_r()),
+        z_sample_(model.num_params_r()), z_propose_(model.num_params_r()),
+        rho_init_(model.num_params_r()), rho_plus_(model.num_params_r()),
+        rho_minus_(model.num_params_r()), delta_rho_(model.num_params_r()) {
       }
 
       ~base_nuts_classic() {}
@@ -62,22 +66,20 @@ namespace stan {
 
         nuts_util util;
 
-        this->seed(init_sample.cont_params());
+        this->begin_transition_(init_sample.cont_params(),
+                                info_writer, error_writer);
 
-        this->hamiltonian_.sample_p(this->z_, this->rand_int_);
-        this->hamiltonian_.init(this->z_, info_writer, error_writer);
+        resize_workspace_(this->max_depth_, this->z_.q.size());
 
-        ps_point z_plus(this->z_);
-        ps_point z_minus(z_plus);
+        z_plus_ = this->z_;
+        z_minus_ = z_plus_;
 
-        ps_point z_sample(z_plus);
-        ps_point z_propose(z_plus);
+        z_sample_ = z_plus_;
+        z_propose_ = z_plus_;
 
-        int n_cont = init_sample.cont_params().size();
-
-        Eigen::VectorXd rho_init = this->z_.p;
-        Eigen::VectorXd rho_plus(n_cont); rho_plus.setZero();
-        Eigen::VectorXd rho_minus(n_cont); rho_minus.setZero();
+        rho_init_ = this->z_.p;
+        rho_plus_.setZero();
+        rho_minus_.setZero();
 
         util.H0 = this->hamiltonian_.H(this->z_);
 
@@ -100,19 +102,19 @@ namespace stan {
           Eigen::VectorXd* rho = 0;
 
           if (this->rand_uniform_() > 0.5) {
-            z = &z_plus;
-            rho = &rho_plus;
+            z = &z_plus_;
+            rho = &rho_plus_;
             util.sign = 1;
           } else {
-            z = &z_minus;
-            rho = &rho_minus;
+            z = &z_minus_;
+            rho = &rho_minus_;
             util.sign = -1;
           }
 
           // And build a new subtree in that direction
           this->z_.ps_point::operator=(*z);
 
-          int n_valid_subtree = build_tree(depth_, *rho, 0, z_propose, util,
+          int n_valid_subtree = build_tree(depth_, *rho, 0, z_propose_, util,
                                            info_writer, error_writer);
           ++(this->depth_);
 
@@ -132,26 +134,51 @@ namespace stan {
           }
 
           if (this->rand_uniform_() < subtree_prob)
-            z_sample = z_propose;
+            z_sample_ = z_propose_;
 
           n_valid += n_valid_subtree;
 
           // Check validity of completed tree
-          this->z_.ps_point::operator=(z_plus);
-          Eigen::VectorXd delta_rho = rho_minus + rho_init + rho_plus;
+          this->z_.ps_point::operator=(z_plus_);
+          delta_rho_ = rho_minus_ + rho_init_ + rho_plus_;
 
-          util.criterion = compute_criterion(z_minus, this->z_, delta_rho);
+          util.criterion = compute_criterion(z_minus_, this->z_, delta_rho_);
         }
 
         this->n_leapfrog_ = util.n_tree;
 
         double accept_prob = util.sum_prob / static_cast<double>(util.n_tree);
 
-        this->z_.ps_point::operator=(z_sample);
+        this->z_.ps_point::operator=(z_sample_);
         this->energy_ = this->hamiltonian_.H(this->z_);
+        this->end_transition_();
         return sample(this->z_.q, - this->z_.V, accept_prob);
       }
 
+      void save_state(io::checkpoint_writer& checkpoint) {
+        base_hmc<Model, Hamiltonian, Integrator, BaseRNG>
+          ::save_state(checkpoint);
+        checkpoint.begin_section("nuts_classic");
+        checkpoint.write(this->depth_);
+        checkpoint.write(this->max_depth_);
+        checkpoint.write(this->max_delta_);
+        checkpoint.write(this->n_leapfrog_);
+        checkpoint.write(this->divergent_);
+        checkpoint.write(this->energy_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        base_hmc<Model, Hamiltonian, Integrator, BaseRNG>
+          ::load_state(checkpoint);
+        checkpoint.begin_section("nuts_classic");
+        checkpoint.read(this->depth_);
+        checkpoint.read(this->max_depth_);
+        checkpoint.read(this->max_delta_);
+        checkpoint.read(this->n_leapfrog_);
+        checkpoint.read(this->divergent_);
+        checkpoint.read(this->energy_);
+      }
+
       void get_sampler_param_names(std::vector<std::string>& names) {
         names.push_back("stepsize__");
         names.push_back("treedepth__");
@@ -203,9 +230,14 @@ namespace stan {
 
           } else {
           // General recursion
-          Eigen::VectorXd left_subtree_rho(rho.size());
+          resize_workspace_(depth, rho.size());
+          subtree_workspace& ws = workspace_[depth];
+
+          Eigen::VectorXd& left_subtree_rho = ws.left_subtree_rho;
           left_subtree_rho.setZero();
-          ps_point z_init(this->z_);
+
+          // Overwritten by the first leaf of the left subtree
+          ps_point& z_init = ws.z_init;
 
           int n1 = build_tree(depth - 1, left_subtree_rho, &z_init,
                               z_propose, util,
@@ -215,9 +247,11 @@ namespace stan {
 
           if (!util.criterion) return 0;
 
-          Eigen::VectorXd right_subtree_rho(rho.size());
+          Eigen::VectorXd& right_subtree_rho = ws.right_subtree_rho;
           right_subtree_rho.setZero();
-          ps_point z_propose_right(z_init);
+
+          // Overwritten by the first leaf of the right subtree
+          ps_point& z_propose_right = ws.z_propose_right;
 
           int n2 = build_tree(depth - 1, right_subtree_rho, 0,
                               z_propose_right, util,
@@ -247,6 +281,51 @@ namespace stan {
       int n_leapfrog_;
       int divergent_;
       double energy_;
+
+    protected:
+      /**
+       * Buffers used by one level of the recursion in build_tree.
+       */
+      struct subtree_workspace {
+        explicit subtree_workspace(int n)
+          : left_subtree_rho(n), right_subtree_rho(n),
+            z_init(n), z_propose_right(n) {}
+
+        Eigen::VectorXd left_subtree_rho;
+        Eigen::VectorXd right_subtree_rho;
+        ps_point z_init;
+        ps_point z_propose_right;
+      };
+
+      /**
+       * Grows the workspace so that it holds buffers of dimension n
+       * for every depth up to and including the given depth.  The
+       * buffers are kept across transitions, so only the first
+       * transition, or a change in the maximum depth, allocates.
+       *
+       * @param depth largest tree depth that will be built
+       * @param n dimension of the buffers
+       */
+      void resize_workspace_(int depth, int n) {
+        if (!workspace_.empty() && workspace_[0].left_subtree_rho.size() != n)
+          workspace_.clear();
+        if (static_cast<int>(workspace_.size()) <= depth)
+          workspace_.resize(depth + 1, subtree_workspace(n));
+      }
+
+      // Trajectory state reused across transitions
+      ps_point z_plus_;
+      ps_point z_minus_;
+      ps_point z_sample_;
+      ps_point z_propose_;
+
+      Eigen::VectorXd rho_init_;
+      Eigen::VectorXd rho_plus_;
+      Eigen::VectorXd rho_minus_;
+      Eigen::VectorXd delta_rho_;
+
+      // Subtree buffers indexed by depth
+      std::vector<subtree_workspace> workspace_;
     };
 
   }  // mcmc
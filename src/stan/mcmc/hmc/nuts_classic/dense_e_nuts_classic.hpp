@@ -24,8 +24,8 @@ namespace stan {
       bool compute_criterion(ps_point& start,
                              dense_e_point& finish,
                              Eigen::VectorXd& rho) {
-        return finish.p.transpose() * finish.mInv * (rho - finish.p) > 0
-               && start.p.transpose() * finish.mInv * (rho - start.p)  > 0;
+        return finish.p.transpose() * finish.mInv() * (rho - finish.p) > 0
+               && start.p.transpose() * finish.mInv() * (rho - start.p)  > 0;
       }
     };
 
@@ -13,12 +13,14 @@ namespace stan {
      * Gaussian-Euclidean disintegration and adative dense metric and
      * adaptive step size
      */
-    template <class Model, class BaseRNG>
-    class adapt_dense_e_static_hmc : public dense_e_static_hmc<Model, BaseRNG>,
-                                     public stepsize_covar_adapter {
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class adapt_dense_e_static_hmc
+      : public dense_e_static_hmc<Model, BaseRNG, Integrator>,
+        public stepsize_covar_adapter {
     public:
       adapt_dense_e_static_hmc(const Model& model, BaseRNG& rng)
-        : dense_e_static_hmc<Model, BaseRNG>(model, rng),
+        : dense_e_static_hmc<Model, BaseRNG, Integrator>(model, rng),
         stepsize_covar_adapter(model.num_params_r()) { }
 
       ~adapt_dense_e_static_hmc() { }
@@ -28,9 +30,8 @@ namespace stan {
                  interface_callbacks::writer::base_writer& info_writer,
                  interface_callbacks::writer::base_writer& error_writer) {
         sample s
-          = dense_e_static_hmc<Model, BaseRNG>::transition(init_sample,
-                                                           info_writer,
-                                                           error_writer);
+          = dense_e_static_hmc<Model, BaseRNG, Integrator>::transition(
+              init_sample, info_writer, error_writer);
 
         if (this->adapt_flag_) {
           this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
@@ -38,9 +39,12 @@ namespace stan {
           this->update_L_();
 
           bool update = this->covar_adaptation_.learn_covariance
-            (this->z_.mInv, this->z_.q);
+            (this->covar_, this->z_.q);
 
           if (update) {
+            this->z_.set_mInv(this->covar_);
+            this->update_schedule(this->covar_, info_writer);
+
             this->init_stepsize(info_writer, error_writer);
             this->update_L_();
 
@@ -53,6 +57,8 @@ namespace stan {
 
       void disengage_adaptation() {
         base_adapter::disengage_adaptation();
+        if (this->covar_adaptation_.pick_up_pooled_covariance(this->covar_))
+          this->z_.set_mInv(this->covar_);
         this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
       }
     };
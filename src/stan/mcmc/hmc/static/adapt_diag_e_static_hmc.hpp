@@ -13,12 +13,14 @@ namespace stan {
      * Gaussian-Euclidean disintegration and adaptive diagonal metric and
      * adaptive step size
      */
-    template <class Model, class BaseRNG>
-    class adapt_diag_e_static_hmc : public diag_e_static_hmc<Model, BaseRNG>,
-                                    public stepsize_var_adapter {
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class adapt_diag_e_static_hmc
+      : public diag_e_static_hmc<Model, BaseRNG, Integrator>,
+        public stepsize_var_adapter {
     public:
       adapt_diag_e_static_hmc(const Model& model, BaseRNG& rng)
-        : diag_e_static_hmc<Model, BaseRNG>(model, rng),
+        : diag_e_static_hmc<Model, BaseRNG, Integrator>(model, rng),
         stepsize_var_adapter(model.num_params_r()) {}
 
       ~adapt_diag_e_static_hmc() {}
@@ -28,9 +30,8 @@ namespace stan {
                  interface_callbacks::writer::base_writer& info_writer,
                  interface_callbacks::writer::base_writer& error_writer) {
         sample s
-          = diag_e_static_hmc<Model, BaseRNG>::transition(init_sample,
-                                                          info_writer,
-                                                          error_writer);
+          = diag_e_static_hmc<Model, BaseRNG, Integrator>::transition(
+              init_sample, info_writer, error_writer);
 
         if (this->adapt_flag_) {
           this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
@@ -41,6 +42,8 @@ namespace stan {
                                                              this->z_.q);
 
           if (update) {
+            this->update_schedule(this->z_.mInv, info_writer);
+
             this->init_stepsize(info_writer, error_writer);
             this->update_L_();
 
@@ -53,6 +56,7 @@ namespace stan {
 
       void disengage_adaptation() {
         base_adapter::disengage_adaptation();
+        this->var_adaptation_.pick_up_pooled_variance(this->z_.mInv);
         this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
       }
     };
@@ -0,0 +1,66 @@
+#ifndef STAN_MCMC_HMC_STATIC_ADAPT_LOWRANK_E_STATIC_HMC_HPP
+#define STAN_MCMC_HMC_STATIC_ADAPT_LOWRANK_E_STATIC_HMC_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/hmc/static/lowrank_e_static_hmc.hpp>
+#include <stan/mcmc/stepsize_lowrank_adapter.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * Hamiltonian Monte Carlo implementation using the endpoint
+     * of trajectories with a static integration time with a
+     * Gaussian-Euclidean disintegration and adaptive diagonal plus
+     * low-rank metric and adaptive step size
+     */
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class adapt_lowrank_e_static_hmc
+      : public lowrank_e_static_hmc<Model, BaseRNG, Integrator>,
+        public stepsize_lowrank_adapter {
+    public:
+      adapt_lowrank_e_static_hmc(const Model& model, BaseRNG& rng)
+        : lowrank_e_static_hmc<Model, BaseRNG, Integrator>(model, rng),
+        stepsize_lowrank_adapter(model.num_params_r()) { }
+
+      ~adapt_lowrank_e_static_hmc() { }
+
+      sample
+      transition(sample& init_sample,
+                 interface_callbacks::writer::base_writer& info_writer,
+                 interface_callbacks::writer::base_writer& error_writer) {
+        sample s
+          = lowrank_e_static_hmc<Model, BaseRNG, Integrator>::transition(
+              init_sample, info_writer, error_writer);
+
+        if (this->adapt_flag_) {
+          this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
+                                                    s.accept_stat());
+          this->update_L_();
+
+          bool update = this->lowrank_adaptation_.learn_metric
+            (this->adapted_diag_, this->adapted_factor_, this->z_.q);
+
+          if (update) {
+            this->z_.set_metric(this->adapted_diag_, this->adapted_factor_);
+            this->update_schedule(this->z_, info_writer);
+
+            this->init_stepsize(info_writer, error_writer);
+            this->update_L_();
+
+            this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
+            this->stepsize_adaptation_.restart();
+          }
+        }
+        return s;
+      }
+
+      void disengage_adaptation() {
+        base_adapter::disengage_adaptation();
+        this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
@@ -37,10 +37,8 @@ namespace stan {
                  interface_callbacks::writer::base_writer& error_writer) {
         this->sample_stepsize();
 
-        this->seed(init_sample.cont_params());
-
-        this->hamiltonian_.sample_p(this->z_, this->rand_int_);
-        this->hamiltonian_.init(this->z_, info_writer, error_writer);
+        this->begin_transition_(init_sample.cont_params(),
+                                info_writer, error_writer);
 
         ps_point z_init(this->z_);
 
@@ -62,9 +60,28 @@ namespace stan {
         acceptProb = acceptProb > 1 ? 1 : acceptProb;
 
         this->energy_ = this->hamiltonian_.H(this->z_);
+        this->end_transition_();
         return sample(this->z_.q, - this->hamiltonian_.V(this->z_), acceptProb);
       }
 
+      void save_state(io::checkpoint_writer& checkpoint) {
+        base_hmc<Model, Hamiltonian, Integrator, BaseRNG>
+          ::save_state(checkpoint);
+        checkpoint.begin_section("static_hmc");
+        checkpoint.write(this->T_);
+        checkpoint.write(this->L_);
+        checkpoint.write(this->energy_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        base_hmc<Model, Hamiltonian, Integrator, BaseRNG>
+          ::load_state(checkpoint);
+        checkpoint.begin_section("static_hmc");
+        checkpoint.read(this->T_);
+        checkpoint.read(this->L_);
+        checkpoint.read(this->energy_);
+      }
+
       void get_sampler_param_names(std::vector<std::string>& names) {
         names.push_back("stepsize__");
         names.push_back("int_time__");
@@ -13,14 +13,15 @@ namespace stan {
      * of trajectories with a static integration time with a
      * Gaussian-Euclidean disintegration and diagonal metric
      */
-    template <class Model, class BaseRNG>
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
     class diag_e_static_hmc
       : public base_static_hmc<Model, diag_e_metric,
-                               expl_leapfrog, BaseRNG> {
+                               Integrator, BaseRNG> {
     public:
       diag_e_static_hmc(const Model& model, BaseRNG& rng)
         : base_static_hmc<Model, diag_e_metric,
-                          expl_leapfrog, BaseRNG>(model, rng) { }
+                          Integrator, BaseRNG>(model, rng) { }
     };
 
   }  // mcmc
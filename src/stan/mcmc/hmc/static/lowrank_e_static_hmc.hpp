@@ -0,0 +1,29 @@
+#ifndef STAN_MCMC_HMC_STATIC_LOWRANK_E_STATIC_HMC_HPP
+#define STAN_MCMC_HMC_STATIC_LOWRANK_E_STATIC_HMC_HPP
+
+#include <stan/mcmc/hmc/static/base_static_hmc.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_metric.hpp>
+#include <stan/mcmc/hmc/integrators/expl_leapfrog.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * Hamiltonian Monte Carlo implementation using the endpoint
+     * of trajectories with a static integration time with a
+     * Gaussian-Euclidean disintegration and diagonal plus low-rank metric
+     */
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class lowrank_e_static_hmc
+      : public base_static_hmc<Model, lowrank_e_metric,
+                               Integrator, BaseRNG> {
+    public:
+      lowrank_e_static_hmc(const Model& model, BaseRNG& rng)
+        : base_static_hmc<Model, lowrank_e_metric,
+                          Integrator, BaseRNG>(model, rng) { }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
@@ -37,9 +37,12 @@ namespace stan {
                                                     s.accept_stat());
 
           bool update = this->covar_adaptation_.learn_covariance
-            (this->z_.mInv, this->z_.q);
+            (this->covar_, this->z_.q);
 
           if (update) {
+            this->z_.set_mInv(this->covar_);
+            this->update_schedule(this->covar_, info_writer);
+
             this->init_stepsize(info_writer, error_writer);
             this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
             this->stepsize_adaptation_.restart();
@@ -50,6 +53,8 @@ namespace stan {
 
       void disengage_adaptation() {
         base_adapter::disengage_adaptation();
+        if (this->covar_adaptation_.pick_up_pooled_covariance(this->covar_))
+          this->z_.set_mInv(this->covar_);
         this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
       }
     };
@@ -39,6 +39,8 @@ namespace stan {
           bool update = this->var_adaptation_.learn_variance(this->z_.mInv,
                                                              this->z_.q);
           if (update) {
+            this->update_schedule(this->z_.mInv, info_writer);
+
             this->init_stepsize(info_writer, error_writer);
             this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
             this->stepsize_adaptation_.restart();
@@ -49,6 +51,7 @@ namespace stan {
 
       void disengage_adaptation() {
         base_adapter::disengage_adaptation();
+        this->var_adaptation_.pick_up_pooled_variance(this->z_.mInv);
         this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
       }
     };
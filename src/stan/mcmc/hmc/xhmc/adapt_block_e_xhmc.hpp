@@ -0,0 +1,63 @@
+#ifndef STAN_MCMC_HMC_XHMC_ADAPT_BLOCK_E_XHMC_HPP
+#define STAN_MCMC_HMC_XHMC_ADAPT_BLOCK_E_XHMC_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/stepsize_block_adapter.hpp>
+#include <stan/mcmc/hmc/xhmc/block_e_xhmc.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * Exhausive Hamiltonian Monte Carlo (XHMC) with multinomial sampling
+     * with a Gaussian-Euclidean disintegration and adaptive
+     * block diagonal metric and adaptive step size
+     */
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class adapt_block_e_xhmc
+      : public block_e_xhmc<Model, BaseRNG, Integrator>,
+        public stepsize_block_adapter {
+    public:
+        adapt_block_e_xhmc(const Model& model, BaseRNG& rng)
+          : block_e_xhmc<Model, BaseRNG, Integrator>(model, rng),
+          stepsize_block_adapter(model.num_params_r()) {}
+
+      ~adapt_block_e_xhmc() {}
+
+      sample
+      transition(sample& init_sample,
+                 interface_callbacks::writer::base_writer& info_writer,
+                 interface_callbacks::writer::base_writer& error_writer) {
+        sample s
+          = block_e_xhmc<Model, BaseRNG, Integrator>::transition(
+              init_sample, info_writer, error_writer);
+
+        if (this->adapt_flag_) {
+          this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
+                                                    s.accept_stat());
+
+          bool update = this->block_adaptation_.learn_metric
+            (this->adapted_blocks_, this->adapted_mInv_, this->z_.q);
+
+          if (update) {
+            this->z_.set_metric(this->adapted_blocks_, this->adapted_mInv_);
+            this->update_schedule(this->z_, info_writer);
+
+            this->init_stepsize(info_writer, error_writer);
+
+            this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
+            this->stepsize_adaptation_.restart();
+          }
+        }
+        return s;
+      }
+
+      void disengage_adaptation() {
+        base_adapter::disengage_adaptation();
+        this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
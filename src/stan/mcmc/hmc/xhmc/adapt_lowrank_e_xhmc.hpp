@@ -0,0 +1,63 @@
+#ifndef STAN_MCMC_HMC_XHMC_ADAPT_LOWRANK_E_XHMC_HPP
+#define STAN_MCMC_HMC_XHMC_ADAPT_LOWRANK_E_XHMC_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/stepsize_lowrank_adapter.hpp>
+#include <stan/mcmc/hmc/xhmc/lowrank_e_xhmc.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * Exhausive Hamiltonian Monte Carlo (XHMC) with multinomial sampling
+     * with a Gaussian-Euclidean disintegration and adaptive
+     * diagonal plus low-rank metric and adaptive step size
+     */
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class adapt_lowrank_e_xhmc
+      : public lowrank_e_xhmc<Model, BaseRNG, Integrator>,
+        public stepsize_lowrank_adapter {
+    public:
+        adapt_lowrank_e_xhmc(const Model& model, BaseRNG& rng)
+          : lowrank_e_xhmc<Model, BaseRNG, Integrator>(model, rng),
+          stepsize_lowrank_adapter(model.num_params_r()) {}
+
+      ~adapt_lowrank_e_xhmc() {}
+
+      sample
+      transition(sample& init_sample,
+                 interface_callbacks::writer::base_writer& info_writer,
+                 interface_callbacks::writer::base_writer& error_writer) {
+        sample s
+          = lowrank_e_xhmc<Model, BaseRNG, Integrator>::transition(
+              init_sample, info_writer, error_writer);
+
+        if (this->adapt_flag_) {
+          this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
+                                                    s.accept_stat());
+
+          bool update = this->lowrank_adaptation_.learn_metric
+            (this->adapted_diag_, this->adapted_factor_, this->z_.q);
+
+          if (update) {
+            this->z_.set_metric(this->adapted_diag_, this->adapted_factor_);
+            this->update_schedule(this->z_, info_writer);
+
+            this->init_stepsize(info_writer, error_writer);
+
+            this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
+            this->stepsize_adaptation_.restart();
+          }
+        }
+        return s;
+      }
+
+      void disengage_adaptation() {
+        base_adapter::disengage_adaptation();
+        this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
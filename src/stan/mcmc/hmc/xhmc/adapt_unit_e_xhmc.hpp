@@ -12,12 +12,14 @@ namespace stan {
      * with a Gaussian-Euclidean disintegration and unit metric
      * and adaptive step size
      */
-    template <class Model, class BaseRNG>
-    class adapt_unit_e_xhmc: public unit_e_xhmc<Model, BaseRNG>,
-                             public stepsize_adapter {
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class adapt_unit_e_xhmc
+      : public unit_e_xhmc<Model, BaseRNG, Integrator>,
+        public stepsize_adapter {
     public:
       adapt_unit_e_xhmc(const Model& model, BaseRNG& rng)
-        : unit_e_xhmc<Model, BaseRNG>(model, rng) {}
+        : unit_e_xhmc<Model, BaseRNG, Integrator>(model, rng) {}
 
       ~adapt_unit_e_xhmc() {}
 
@@ -26,9 +28,8 @@ namespace stan {
                  interface_callbacks::writer::base_writer& info_writer,
                  interface_callbacks::writer::base_writer& error_writer) {
         sample s
-          = unit_e_xhmc<Model, BaseRNG>::transition(init_sample,
-                                                    info_writer,
-                                                    error_writer);
+          = unit_e_xhmc<Model, BaseRNG, Integrator>::transition(
+              init_sample, info_writer, error_writer);
 
         if (this->adapt_flag_)
           this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
@@ -24,7 +24,9 @@ namespace stan {
       base_xhmc(const Model& model, BaseRNG& rng)
         : base_hmc<Model, Hamiltonian, Integrator, BaseRNG>(model, rng),
           depth_(0), max_depth_(5), max_deltaH_(1000), x_delta_(0.1),
-          n_leapfrog_(0), divergent_(0), energy_(0) {
+          n_leapfrog_(0), divergent_(0), energy_(0),
+          z_plus_(model.num_params_r()), z_minus_(model.num_params_r()),
+          z_sample_(model.num_params_r()), z_propose_(model.num_params_r()) {
       }
 
       ~base_xhmc() {}
@@ -54,16 +56,15 @@ namespace stan {
         // Initialize the algorithm
         this->sample_stepsize();
 
-        this->seed(init_sample.cont_params());
+        this->begin_transition_(init_sample.cont_params(),
+                                info_writer, error_writer);
 
-        this->hamiltonian_.sample_p(this->z_, this->rand_int_);
-        this->hamiltonian_.init(this->z_, info_writer, error_writer);
+        resize_workspace_(this->max_depth_, this->z_.q.size());
 
-        ps_point z_plus(this->z_);
-        ps_point z_minus(z_plus);
+        z_plus_ = this->z_;
+        z_minus_ = z_plus_;
 
-        ps_point z_sample(z_plus);
-        ps_point z_propose(z_plus);
+        z_sample_ = z_plus_;
 
         double sum_numer = this->hamiltonian_.dG_dt(this->z_,
                                                     info_writer, error_writer);
@@ -84,21 +85,21 @@ namespace stan {
           double sum_weight_subtree = 0;
 
           if (this->rand_uniform_() > 0.5) {
-            this->z_.ps_point::operator=(z_plus);
+            this->z_.ps_point::operator=(z_plus_);
             valid_subtree
-              = build_tree(this->depth_, z_propose,
+              = build_tree(this->depth_, z_propose_,
                            sum_numer_subtree, sum_weight_subtree,
                            H0, 1, n_leapfrog, sum_metro_prob,
                            info_writer, error_writer);
-            z_plus.ps_point::operator=(this->z_);
+            z_plus_.swap(this->z_);
           } else {
-            this->z_.ps_point::operator=(z_minus);
+            this->z_.ps_point::operator=(z_minus_);
             valid_subtree
-              = build_tree(this->depth_, z_propose,
+              = build_tree(this->depth_, z_propose_,
                            sum_numer_subtree, sum_weight_subtree,
                            H0, -1, n_leapfrog, sum_metro_prob,
                            info_writer, error_writer);
-            z_minus.ps_point::operator=(this->z_);
+            z_minus_.swap(this->z_);
           }
 
           sum_numer += sum_numer_subtree;
@@ -110,7 +111,7 @@ namespace stan {
 
           double accept_prob = sum_weight_subtree / sum_weight;
           if (this->rand_uniform_() < accept_prob)
-            z_sample = z_propose;
+            z_sample_.swap(z_propose_);
 
             // Break if exhaustion criterion is satisfied
             if (std::fabs(sum_numer / sum_weight) < x_delta_)
@@ -124,11 +125,38 @@ namespace stan {
         double accept_prob
           = sum_metro_prob / static_cast<double>(n_leapfrog + 1);
 
-        this->z_.ps_point::operator=(z_sample);
+        this->z_.swap(z_sample_);
         this->energy_ = this->hamiltonian_.H(this->z_);
+        this->end_transition_();
         return sample(this->z_.q, -this->z_.V, accept_prob);
       }
 
+      void save_state(io::checkpoint_writer& checkpoint) {
+        base_hmc<Model, Hamiltonian, Integrator, BaseRNG>
+          ::save_state(checkpoint);
+        checkpoint.begin_section("xhmc");
+        checkpoint.write(this->depth_);
+        checkpoint.write(this->max_depth_);
+        checkpoint.write(this->max_deltaH_);
+        checkpoint.write(this->x_delta_);
+        checkpoint.write(this->n_leapfrog_);
+        checkpoint.write(this->divergent_);
+        checkpoint.write(this->energy_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        base_hmc<Model, Hamiltonian, Integrator, BaseRNG>
+          ::load_state(checkpoint);
+        checkpoint.begin_section("xhmc");
+        checkpoint.read(this->depth_);
+        checkpoint.read(this->max_depth_);
+        checkpoint.read(this->max_deltaH_);
+        checkpoint.read(this->x_delta_);
+        checkpoint.read(this->n_leapfrog_);
+        checkpoint.read(this->divergent_);
+        checkpoint.read(this->energy_);
+      }
+
       void get_sampler_param_names(std::vector<std::string>& names) {
         names.push_back("stepsize__");
         names.push_back("treedepth__");
@@ -177,6 +205,7 @@ namespace stan {
             return !this->divergent_;
         }
         // General recursion
+        resize_workspace_(depth, this->z_.q.size());
 
         // Build the left subtree
         double sum_numer_left = 0;
@@ -192,8 +221,9 @@ namespace stan {
         sum_weight += sum_weight_left;
         if (!valid_left) return false;
 
-        // Build the right subtree
-        ps_point z_propose_right(this->z_);
+        // Build the right subtree, whose first leaf
+        // always overwrites its proposal
+        ps_point& z_propose_right = z_propose_right_[depth];
         double sum_numer_right = 0;
         double sum_weight_right = 0;
 
@@ -210,7 +240,7 @@ namespace stan {
         // Multinomial sample from right subtree
         double accept_prob = sum_weight_right / sum_weight;
         if (this->rand_uniform_() < accept_prob)
-          z_propose = z_propose_right;
+          z_propose.swap(z_propose_right);
 
         double sum_numer_subtree = sum_numer_left + sum_numer_right;
         double sum_weight_subtree = sum_weight_left + sum_weight_right;
@@ -225,6 +255,32 @@ namespace stan {
       int n_leapfrog_;
       int divergent_;
       double energy_;
+
+    protected:
+      /**
+       * Grows the workspace so that it holds proposals of dimension n
+       * for every depth up to and including the given depth.  The
+       * proposals are kept across transitions, so only the first
+       * transition, or a change in the maximum depth, allocates.
+       *
+       * @param depth largest tree depth that will be built
+       * @param n dimension of the proposals
+       */
+      void resize_workspace_(int depth, int n) {
+        if (!z_propose_right_.empty() && z_propose_right_[0].q.size() != n)
+          z_propose_right_.clear();
+        if (static_cast<int>(z_propose_right_.size()) <= depth)
+          z_propose_right_.resize(depth + 1, ps_point(n));
+      }
+
+      // Trajectory state reused across transitions
+      ps_point z_plus_;
+      ps_point z_minus_;
+      ps_point z_sample_;
+      ps_point z_propose_;
+
+      // Right subtree proposals indexed by depth
+      std::vector<ps_point> z_propose_right_;
     };
 
   }  // mcmc
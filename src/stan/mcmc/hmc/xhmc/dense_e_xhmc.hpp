@@ -12,13 +12,14 @@ namespace stan {
      * Exhausive Hamiltonian Monte Carlo (XHMC) with multinomial sampling
      * with a Gaussian-Euclidean disintegration and dense metric
      */
-    template <class Model, class BaseRNG>
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
     class dense_e_xhmc
       : public base_xhmc<Model, dense_e_metric,
-                         expl_leapfrog, BaseRNG> {
+                         Integrator, BaseRNG> {
     public:
       dense_e_xhmc(const Model& model, BaseRNG& rng)
-        : base_xhmc<Model, dense_e_metric, expl_leapfrog,
+        : base_xhmc<Model, dense_e_metric, Integrator,
                     BaseRNG>(model, rng) { }
     };
 
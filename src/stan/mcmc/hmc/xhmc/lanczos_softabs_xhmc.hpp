@@ -0,0 +1,28 @@
+#ifndef STAN_MCMC_HMC_XHMC_LANCZOS_SOFTABS_XHMC_HPP
+#define STAN_MCMC_HMC_XHMC_LANCZOS_SOFTABS_XHMC_HPP
+
+#include <stan/mcmc/hmc/xhmc/base_xhmc.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lanczos_softabs_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lanczos_softabs_metric.hpp>
+#include <stan/mcmc/hmc/integrators/impl_leapfrog.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * Exhausive Hamiltonian Monte Carlo (XHMC) with multinomial sampling
+     * with a Gaussian-Riemannian disintegration and matrix-free
+     * SoftAbs metric
+     */
+    template <class Model, class BaseRNG>
+    class lanczos_softabs_xhmc
+      : public base_xhmc<Model, lanczos_softabs_metric,
+                         impl_leapfrog, BaseRNG> {
+    public:
+      lanczos_softabs_xhmc(const Model& model, BaseRNG& rng)
+        : base_xhmc<Model, lanczos_softabs_metric, impl_leapfrog,
+                    BaseRNG>(model, rng) { }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
@@ -0,0 +1,29 @@
+#ifndef STAN_MCMC_HMC_XHMC_LOWRANK_E_XHMC_HPP
+#define STAN_MCMC_HMC_XHMC_LOWRANK_E_XHMC_HPP
+
+#include <stan/mcmc/hmc/xhmc/base_xhmc.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_metric.hpp>
+#include <stan/mcmc/hmc/integrators/expl_leapfrog.hpp>
+
+namespace stan {
+  namespace mcmc {
+    /**
+     * Exhausive Hamiltonian Monte Carlo (XHMC) with multinomial sampling
+     * with a Gaussian-Euclidean disintegration and diagonal plus
+     * low-rank metric
+     */
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
+    class lowrank_e_xhmc
+      : public base_xhmc<Model, lowrank_e_metric,
+                         Integrator, BaseRNG> {
+    public:
+      lowrank_e_xhmc(const Model& model, BaseRNG& rng)
+        : base_xhmc<Model, lowrank_e_metric, Integrator,
+                    BaseRNG>(model, rng) { }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
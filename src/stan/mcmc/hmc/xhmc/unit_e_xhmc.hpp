@@ -12,13 +12,14 @@ namespace stan {
      * Exhausive Hamiltonian Monte Carlo (XHMC) with multinomial sampling
      * with a Gaussian-Euclidean disintegration and unit metric
      */
-    template <class Model, class BaseRNG>
+    template <class Model, class BaseRNG,
+              template <class> class Integrator = expl_leapfrog>
     class unit_e_xhmc
       : public base_xhmc<Model, unit_e_metric,
-                         expl_leapfrog, BaseRNG> {
+                         Integrator, BaseRNG> {
     public:
       unit_e_xhmc(const Model& model, BaseRNG& rng)
-        : base_xhmc<Model, unit_e_metric, expl_leapfrog,
+        : base_xhmc<Model, unit_e_metric, Integrator,
                     BaseRNG>(model, rng) { }
     };
 
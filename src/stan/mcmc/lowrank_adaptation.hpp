@@ -0,0 +1,200 @@
+#ifndef STAN_MCMC_LOWRANK_ADAPTATION_HPP
+#define STAN_MCMC_LOWRANK_ADAPTATION_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/mcmc/windowed_adaptation.hpp>
+#include <stan/mcmc/welford_checkpoint.hpp>
+#include <stan/math/prim/mat/fun/welford_var_estimator.hpp>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace stan {
+
+  namespace mcmc {
+
+    /**
+     * Windowed adaptation of a diagonal plus low-rank inverse metric.
+     *
+     * The diagonal of the full inverse metric is the variance of all
+     * draws in a window, regularized as in var_adaptation; the
+     * diagonal part is what is left of it once the low-rank part is
+     * taken out.  The low-rank part captures the leading
+     * eigen-directions of the correlation of the most recent draws of
+     * the window: the draws are standardized by the window's mean and
+     * variance, and the directions whose variance exceeds what m
+     * draws of independent noise would show are found from the
+     * eigendecomposition of their small Gram matrix, so no D x D
+     * matrix is ever formed.
+     */
+    class lowrank_adaptation: public windowed_adaptation {
+    public:
+      explicit lowrank_adaptation(int n)
+        : windowed_adaptation("low-rank metric"), estimator_(n),
+          max_rank_(4), draws_(n, 100), num_draws_(0), next_draw_(0) {}
+
+      /**
+       * Sets the largest rank of the low-rank part.
+       *
+       * @param k largest rank
+       */
+      void set_max_rank(int k) {
+        if (k >= 0)
+          max_rank_ = k;
+      }
+
+      int get_max_rank() {
+        return max_rank_;
+      }
+
+      /**
+       * Sets how many of the most recent draws of a window are kept to
+       * estimate the low-rank part, which takes O(D m) memory.
+       *
+       * @param m number of draws kept, at least two
+       */
+      void set_num_draws(int m) {
+        if (m > 1) {
+          draws_.resize(draws_.rows(), m);
+          num_draws_ = 0;
+          next_draw_ = 0;
+        }
+      }
+
+      int get_num_draws() {
+        return draws_.cols();
+      }
+
+      bool learn_metric(Eigen::VectorXd& diag, Eigen::MatrixXd& factor,
+                        const Eigen::VectorXd& q) {
+        if (adaptation_window()) {
+          estimator_.add_sample(q);
+          draws_.col(next_draw_) = q;
+          next_draw_ = (next_draw_ + 1) % draws_.cols();
+          num_draws_ = std::min(num_draws_ + 1,
+                                static_cast<int>(draws_.cols()));
+        }
+
+        if (end_adaptation_window()) {
+          compute_next_window();
+
+          Eigen::VectorXd var(diag.size());
+          Eigen::VectorXd mean(diag.size());
+          estimator_.sample_variance(var);
+          estimator_.sample_mean(mean);
+          for (int i = 0; i < var.size(); ++i)
+            if (!(var(i) > 0))
+              var(i) = 1;
+
+          // The low-rank part already accounts for part of the
+          // variance of each parameter, which is taken out of the
+          // diagonal so that it is not counted twice; at least a
+          // thousandth of the variance is left to the diagonal
+          factor = lowrank_factor_(mean, var);
+          Eigen::VectorXd residual
+            = var - factor.rowwise().squaredNorm();
+          for (int i = 0; i < var.size(); ++i)
+            residual(i) = std::max(residual(i), 1e-3 * var(i));
+
+          double n = static_cast<double>(estimator_.num_samples());
+          diag = (n / (n + 5.0)) * residual
+                 + 1e-3 * (5.0 / (n + 5.0))
+                   * Eigen::VectorXd::Ones(var.size());
+          factor *= std::sqrt(n / (n + 5.0));
+
+          estimator_.restart();
+          num_draws_ = 0;
+          next_draw_ = 0;
+
+          ++adapt_window_counter_;
+          return true;
+        }
+
+        ++adapt_window_counter_;
+        return false;
+      }
+
+      void save_state(io::checkpoint_writer& checkpoint) {
+        windowed_adaptation::save_state(checkpoint);
+        write_estimator(checkpoint, estimator_);
+        checkpoint.write(max_rank_);
+        checkpoint.write(static_cast<int>(draws_.cols()));
+        checkpoint.write(draws_);
+        checkpoint.write(num_draws_);
+        checkpoint.write(next_draw_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        windowed_adaptation::load_state(checkpoint);
+        read_estimator(checkpoint, estimator_);
+        checkpoint.read(max_rank_);
+        int m;
+        checkpoint.read(m);
+        draws_.resize(draws_.rows(), m);
+        checkpoint.read(draws_);
+        checkpoint.read(num_draws_);
+        checkpoint.read(next_draw_);
+      }
+
+    protected:
+      stan::math::welford_var_estimator estimator_;
+
+      int max_rank_;
+
+      // Ring buffer of the most recent draws of the window
+      Eigen::MatrixXd draws_;
+      int num_draws_;
+      int next_draw_;
+
+      // Leading directions of the covariance of the stored draws,
+      // scaled so that the covariance is approximately
+      // diag(var - rowwise squared norms of factor) + factor * factor^T.
+      //
+      // With m draws in D dimensions the sample eigenvalues of pure
+      // noise spread up to the Marchenko-Pastur edge
+      // (1 + sqrt(D / (m - 1)))^2, which is about D / m when D >> m,
+      // so only eigenvalues above the edge are kept.  Each kept
+      // eigenvalue is shrunk to the population variance that would
+      // produce it in a spiked covariance model.
+      Eigen::MatrixXd lowrank_factor_(const Eigen::VectorXd& mean,
+                                      const Eigen::VectorXd& var) {
+        int m = num_draws_;
+        if (m < 2 || max_rank_ == 0)
+          return Eigen::MatrixXd(var.size(), 0);
+
+        Eigen::VectorXd sd = var.cwiseSqrt();
+        Eigen::MatrixXd z = draws_.leftCols(m);
+        z.colwise() -= mean;
+        z = sd.cwiseInverse().asDiagonal() * z;
+
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd>
+          solver(z.transpose() * z / (m - 1.0));
+
+        double gamma = var.size() / (m - 1.0);
+        double edge = (1.0 + std::sqrt(gamma)) * (1.0 + std::sqrt(gamma));
+
+        // Eigenvalues are in increasing order
+        std::vector<int> kept;
+        for (int j = m - 1; j >= 0 && static_cast<int>(kept.size())
+               < max_rank_; --j)
+          if (solver.eigenvalues()(j) > edge)
+            kept.push_back(j);
+
+        Eigen::MatrixXd factor(var.size(), kept.size());
+        for (size_t l = 0; l < kept.size(); ++l) {
+          double lambda = solver.eigenvalues()(kept[l]);
+          double b = lambda + 1.0 - gamma;
+          double spike = 0.5 * (b + std::sqrt(b * b - 4.0 * lambda));
+          factor.col(l) = sd.asDiagonal()
+            * (z * solver.eigenvectors().col(kept[l]))
+            * std::sqrt((spike - 1.0) / ((m - 1.0) * lambda));
+        }
+        return factor;
+      }
+    };
+
+  }  // mcmc
+
+}  // stan
+#endif
@@ -0,0 +1,402 @@
+#ifndef STAN_MCMC_REPLICA_EXCHANGE_REPLICA_EXCHANGE_HPP
+#define STAN_MCMC_REPLICA_EXCHANGE_REPLICA_EXCHANGE_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/io/checkpoint.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/mcmc/base_adapter.hpp>
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/sample.hpp>
+#include <stan/model/tempered_model.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <boost/random/uniform_01.hpp>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace mcmc {
+
+    /**
+     * Parallel tempering, or replica exchange, over a ladder of
+     * tempered copies of a sampler.
+     *
+     * Replica k runs its own sampler on the model's log density
+     * multiplied by an inverse temperature beta_k, with beta_0 = 1
+     * for the cold replica and the temperatures 1 / beta_k rising to
+     * a given maximum.  Every transition advances each replica once
+     * and then proposes to exchange the states of neighbouring
+     * replicas, alternating between the even and the odd pairs, and
+     * accepts an exchange of replicas i and j with probability
+     *
+     *   min(1, exp((beta_i - beta_j) (log p(q_j) - log p(q_i)))).
+     *
+     * The log densities come from the replicas' own transitions, so
+     * exchanges cost no extra evaluations.  Only the cold replica
+     * samples the posterior; transition returns its sample and the
+     * sampler parameters and state are those of the cold sampler, so
+     * the sampler can be recorded with the model's own mcmc_writer.
+     *
+     * The replicas are advanced one after another on the calling
+     * thread.  They share the model and the autodiff stack, which is a
+     * single global arena, so their gradients cannot be evaluated
+     * concurrently.
+     *
+     * While adaptation is engaged the interior temperatures are moved
+     * by stochastic approximation until all neighbouring pairs
+     * exchange at the same rate.  Only the temperatures are adapted
+     * here; the replica samplers adapt their own step sizes and
+     * metrics if they are adaptive and their adaptation is engaged.
+     *
+     * @tparam Model type of the model
+     * @tparam Sampler type of the replica samplers, which must be
+     *   instantiated with model::tempered_model<Model>
+     * @tparam BaseRNG type of the random number generator
+     */
+    template <class Model, class Sampler, class BaseRNG>
+    class replica_exchange : public base_mcmc, public base_adapter {
+    public:
+      /**
+       * The replicas start from a geometric temperature ladder between
+       * 1 and the maximum temperature.
+       *
+       * @param models one tempered model per replica, coldest first;
+       *   their inverse temperatures are set by the sampler
+       * @param samplers one sampler per replica, each using the
+       *   tempered model of the same index
+       * @param rng random number generator for the exchanges
+       * @param max_temperature temperature of the hottest replica
+       * @throw std::invalid_argument if there are no replicas, the
+       *   number of models and samplers differ or the maximum
+       *   temperature is below 1
+       */
+      replica_exchange(const std::vector<model::tempered_model<Model>*>&
+                       models,
+                       const std::vector<Sampler*>& samplers,
+                       BaseRNG& rng,
+                       double max_temperature)
+        : base_mcmc(),
+          base_adapter(),
+          models_(models),
+          samplers_(samplers),
+          rand_uniform_(rng),
+          max_temperature_(max_temperature),
+          log_gaps_(models.empty() ? 0 : models.size() - 1),
+          accept_prob_(log_gaps_.size()),
+          sum_accept_prob_(Eigen::VectorXd::Zero(log_gaps_.size())),
+          num_rounds_(0),
+          adapt_counter_(0),
+          kappa_(0.01),
+          t0_(1000) {
+        if (models.empty())
+          throw std::invalid_argument("Replica exchange needs at least "
+                                      "one replica");
+        if (models.size() != samplers.size())
+          throw std::invalid_argument("The number of tempered models and "
+                                      "replica samplers must match");
+        if (!(max_temperature >= 1))
+          throw std::invalid_argument("The maximum temperature must be at "
+                                      "least 1");
+
+        // Equal temperature ratios between neighbours
+        int n_gaps = log_gaps_.size();
+        double ratio = std::pow(max_temperature, 1.0 / n_gaps);
+        for (int i = 0; i < n_gaps; ++i)
+          log_gaps_(i) = i * std::log(ratio);
+        update_temperatures_();
+      }
+
+      ~replica_exchange() {}
+
+      sample
+      transition(sample& init_sample,
+                 interface_callbacks::writer::base_writer& info_writer,
+                 interface_callbacks::writer::base_writer& error_writer) {
+        // Every replica starts from the first initial point
+        if (samples_.empty())
+          samples_.assign(samplers_.size(), init_sample);
+        else
+          samples_[0] = init_sample;
+
+        for (size_t k = 0; k < samplers_.size(); ++k)
+          samples_[k] = samplers_[k]->transition(samples_[k],
+                                                 info_writer, error_writer);
+
+        if (samplers_.size() > 1) {
+          exchange_();
+          if (this->adapt_flag_)
+            adapt_temperatures_();
+        }
+
+        return samples_[0];
+      }
+
+      void get_sampler_param_names(std::vector<std::string>& names) {
+        samplers_[0]->get_sampler_param_names(names);
+      }
+
+      void get_sampler_params(std::vector<double>& values) {
+        samplers_[0]->get_sampler_params(values);
+      }
+
+      void
+      write_sampler_state(interface_callbacks::writer::base_writer& writer) {
+        samplers_[0]->write_sampler_state(writer);
+
+        writer("Inverse temperatures of the replicas:");
+        std::stringstream betas;
+        betas << models_[0]->get_inverse_temperature();
+        for (size_t k = 1; k < models_.size(); ++k)
+          betas << ", " << models_[k]->get_inverse_temperature();
+        writer(betas.str());
+      }
+
+      void
+      get_sampler_diagnostic_names(std::vector<std::string>& model_names,
+                                   std::vector<std::string>& names) {
+        samplers_[0]->get_sampler_diagnostic_names(model_names, names);
+      }
+
+      void get_sampler_diagnostics(std::vector<double>& values) {
+        samplers_[0]->get_sampler_diagnostics(values);
+      }
+
+      void save_state(io::checkpoint_writer& checkpoint) {
+        checkpoint.begin_section("replica_exchange");
+        checkpoint.write(max_temperature_);
+        checkpoint.write(log_gaps_);
+        checkpoint.write(sum_accept_prob_);
+        checkpoint.write(num_rounds_);
+        checkpoint.write(adapt_counter_);
+        checkpoint.write(static_cast<int>(samples_.size()));
+        for (size_t k = 0; k < samples_.size(); ++k) {
+          checkpoint.write(samples_[k].cont_params());
+          checkpoint.write(samples_[k].log_prob());
+          checkpoint.write(samples_[k].accept_stat());
+        }
+        for (size_t k = 0; k < samplers_.size(); ++k)
+          samplers_[k]->save_state(checkpoint);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        checkpoint.begin_section("replica_exchange");
+        checkpoint.read(max_temperature_);
+        checkpoint.read(log_gaps_);
+        checkpoint.read(sum_accept_prob_);
+        checkpoint.read(num_rounds_);
+        checkpoint.read(adapt_counter_);
+        int n_samples;
+        checkpoint.read(n_samples);
+        samples_.clear();
+        for (int k = 0; k < n_samples; ++k) {
+          Eigen::VectorXd q(models_[0]->num_params_r());
+          double log_prob;
+          double accept_stat;
+          checkpoint.read(q);
+          checkpoint.read(log_prob);
+          checkpoint.read(accept_stat);
+          samples_.push_back(sample(q, log_prob, accept_stat));
+        }
+        update_temperatures_();
+        for (size_t k = 0; k < samplers_.size(); ++k)
+          samplers_[k]->load_state(checkpoint);
+      }
+
+      /**
+       * Sets the gain of the temperature adaptation, which at the
+       * adaptation's t-th exchange round is kappa t0 / (t + t0).
+       *
+       * @param kappa initial gain
+       * @param t0 number of rounds over which the gain halves
+       */
+      void set_adaptation_rate(double kappa, double t0) {
+        if (kappa > 0)
+          kappa_ = kappa;
+        if (t0 > 0)
+          t0_ = t0;
+      }
+
+      /**
+       * Restarts the decay of the temperature adaptation's gain and
+       * the exchange statistics.
+       */
+      void restart() {
+        adapt_counter_ = 0;
+        num_rounds_ = 0;
+        sum_accept_prob_.setZero();
+      }
+
+      int num_replicas() const {
+        return samplers_.size();
+      }
+
+      /**
+       * Replaces the temperature ladder.
+       *
+       * @param betas inverse temperatures of the replicas, coldest
+       *   first, starting at 1 and strictly decreasing
+       * @throw std::invalid_argument if the number of inverse
+       *   temperatures does not match the number of replicas or they
+       *   are not a valid ladder
+       */
+      void set_inverse_temperatures(const std::vector<double>& betas) {
+        if (betas.size() != models_.size())
+          throw std::invalid_argument("The number of inverse temperatures "
+                                      "must match the number of replicas");
+        if (betas[0] != 1)
+          throw std::invalid_argument("The cold replica must have inverse "
+                                      "temperature 1");
+        for (size_t k = 1; k < betas.size(); ++k) {
+          if (!(betas[k] > 0 && betas[k] < betas[k - 1]))
+            throw std::invalid_argument("The inverse temperatures must be "
+                                        "positive and strictly "
+                                        "decreasing");
+        }
+
+        max_temperature_ = 1 / betas.back();
+        for (int i = 0; i < log_gaps_.size(); ++i)
+          log_gaps_(i) = std::log(1 / betas[i + 1] - 1 / betas[i]);
+        update_temperatures_();
+
+        for (size_t k = 1; k < samplers_.size(); ++k) {
+          if (k < samples_.size())
+            samplers_[k]->seed(samples_[k].cont_params());
+        }
+      }
+
+      std::vector<double> get_inverse_temperatures() const {
+        std::vector<double> betas;
+        for (size_t k = 0; k < models_.size(); ++k)
+          betas.push_back(models_[k]->get_inverse_temperature());
+        return betas;
+      }
+
+      /**
+       * Returns the average probability of accepting an exchange of
+       * each pair of neighbouring replicas since the start or the last
+       * restart.  Entry i belongs to replicas i and i + 1.
+       *
+       * @return average exchange acceptance probabilities
+       */
+      Eigen::VectorXd get_exchange_rates() const {
+        if (num_rounds_ == 0)
+          return sum_accept_prob_;
+        return sum_accept_prob_ / num_rounds_;
+      }
+
+      /**
+       * Returns the current sample of a replica.
+       *
+       * @param k index of the replica, 0 for the cold replica
+       * @return current sample of the replica
+       */
+      const sample& replica_sample(int k) const {
+        return samples_.at(k);
+      }
+
+    protected:
+      std::vector<model::tempered_model<Model>*> models_;
+      std::vector<Sampler*> samplers_;
+      std::vector<sample> samples_;
+
+      // Uniform(0, 1) RNG
+      boost::uniform_01<BaseRNG&> rand_uniform_;
+
+      double max_temperature_;
+
+      // Logarithms of the differences of neighbouring temperatures,
+      // which are normalized so that the temperatures span
+      // [1, max_temperature_]
+      Eigen::VectorXd log_gaps_;
+
+      Eigen::VectorXd accept_prob_;
+      Eigen::VectorXd sum_accept_prob_;
+      int num_rounds_;
+
+      int adapt_counter_;
+      double kappa_;
+      double t0_;
+
+      /**
+       * Proposes exchanges between the even pairs of neighbours on
+       * even rounds and the odd pairs on odd rounds.  The acceptance
+       * probabilities of all pairs are computed from the current
+       * states, which the exchanges of disjoint pairs leave valid for
+       * the pairs that are attempted.
+       */
+      void exchange_() {
+        const int n_pairs = accept_prob_.size();
+        for (int i = 0; i < n_pairs; ++i) {
+          double beta_i = models_[i]->get_inverse_temperature();
+          double beta_j = models_[i + 1]->get_inverse_temperature();
+          double lp_i = samples_[i].log_prob() / beta_i;
+          double lp_j = samples_[i + 1].log_prob() / beta_j;
+
+          double log_ratio = (beta_i - beta_j) * (lp_j - lp_i);
+          double accept_prob = log_ratio > 0 ? 1 : std::exp(log_ratio);
+          if (boost::math::isnan(accept_prob))
+            accept_prob = 0;
+          accept_prob_(i) = accept_prob;
+        }
+
+        for (int i = num_rounds_ % 2; i < n_pairs; i += 2) {
+          if (rand_uniform_() < accept_prob_(i)) {
+            double beta_i = models_[i]->get_inverse_temperature();
+            double beta_j = models_[i + 1]->get_inverse_temperature();
+            double lp_i = samples_[i].log_prob() / beta_i;
+            double lp_j = samples_[i + 1].log_prob() / beta_j;
+
+            sample z_i(samples_[i + 1].cont_params(), beta_i * lp_j,
+                       samples_[i].accept_stat());
+            sample z_j(samples_[i].cont_params(), beta_j * lp_i,
+                       samples_[i + 1].accept_stat());
+            samples_[i] = z_i;
+            samples_[i + 1] = z_j;
+          }
+        }
+
+        sum_accept_prob_ += accept_prob_;
+        ++num_rounds_;
+      }
+
+      /**
+       * Widens the temperature gaps of pairs that exchange more often
+       * than average and narrows the others, keeping the coldest and
+       * the hottest temperatures fixed.
+       */
+      void adapt_temperatures_() {
+        if (accept_prob_.size() < 2)
+          return;
+
+        ++adapt_counter_;
+        double gain = kappa_ * t0_ / (adapt_counter_ + t0_);
+        log_gaps_.array() += gain * (accept_prob_.array()
+                                     - accept_prob_.mean());
+        update_temperatures_();
+
+        // The replicas' cached densities belong to the old temperatures
+        for (size_t k = 1; k < samplers_.size(); ++k)
+          samplers_[k]->seed(samples_[k].cont_params());
+      }
+
+      void update_temperatures_() {
+        models_[0]->set_inverse_temperature(1);
+        if (log_gaps_.size() == 0)
+          return;
+
+        Eigen::VectorXd gaps = (log_gaps_.array() - log_gaps_.maxCoeff()).exp();
+        gaps *= (max_temperature_ - 1) / gaps.sum();
+
+        double T = 1;
+        for (int i = 0; i < gaps.size(); ++i) {
+          T += gaps(i);
+          models_[i + 1]->set_inverse_temperature(1 / T);
+        }
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
@@ -0,0 +1,75 @@
+#ifndef STAN_MCMC_RWM_ADAPT_RWM_HPP
+#define STAN_MCMC_RWM_ADAPT_RWM_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/rwm/rwm.hpp>
+#include <stan/mcmc/stepsize_covar_adapter.hpp>
+#include <cmath>
+
+namespace stan {
+  namespace mcmc {
+
+    /**
+     * Random walk Metropolis with an adaptive proposal covariance and
+     * an adaptive step size.
+     *
+     * The covariance is estimated over the same windows as the dense
+     * metric of HMC and the step size is tuned by dual averaging
+     * towards the target acceptance rate, which for random walk
+     * proposals is best set near 0.234 rather than the 0.8 used for
+     * HMC.
+     */
+    template <class Model, class BaseRNG>
+    class adapt_rwm
+      : public rwm<Model, BaseRNG>,
+        public stepsize_covar_adapter {
+    public:
+      adapt_rwm(const Model& model, BaseRNG& rng)
+        : rwm<Model, BaseRNG>(model, rng),
+          stepsize_covar_adapter(model.num_params_r()) {
+        this->stepsize_adaptation_.set_delta(0.234);
+      }
+
+      ~adapt_rwm() {}
+
+      sample
+      transition(sample& init_sample,
+                 interface_callbacks::writer::base_writer& info_writer,
+                 interface_callbacks::writer::base_writer& error_writer) {
+        sample s
+          = rwm<Model, BaseRNG>::transition(init_sample,
+                                            info_writer, error_writer);
+
+        if (this->adapt_flag_) {
+          this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
+                                                    s.accept_stat());
+
+          bool update
+            = this->covar_adaptation_.learn_covariance(this->proposal_covar_,
+                                                       this->z_.q);
+
+          if (update) {
+            this->factor_proposal_();
+            this->update_schedule(this->proposal_covar_, info_writer);
+
+            this->init_stepsize(info_writer, error_writer);
+
+            this->stepsize_adaptation_.set_mu(log(this->nom_epsilon_));
+            this->stepsize_adaptation_.restart();
+          }
+        }
+        return s;
+      }
+
+      void disengage_adaptation() {
+        base_adapter::disengage_adaptation();
+        if (this->covar_adaptation_
+            .pick_up_pooled_covariance(this->proposal_covar_))
+          this->factor_proposal_();
+        this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
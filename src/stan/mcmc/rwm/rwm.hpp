@@ -0,0 +1,338 @@
+#ifndef STAN_MCMC_RWM_RWM_HPP
+#define STAN_MCMC_RWM_RWM_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/io/checkpoint.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/sample.hpp>
+#include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/uniform_01.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <Eigen/Cholesky>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace mcmc {
+
+    /**
+     * Random walk Metropolis with a multivariate normal proposal,
+     *
+     *   q' = q + epsilon L u,  u ~ N(0, I),
+     *
+     * where L is the Cholesky factor of the proposal covariance and
+     * epsilon plays the role of the step size.
+     *
+     * The sampler needs no gradients.  A transition evaluates the log
+     * density once, in double precision, so no autodiff tape is
+     * built.  Constant terms cancel in the Metropolis ratio, so they
+     * are kept and the reported log density includes them.
+     */
+    template <class Model, class BaseRNG>
+    class rwm : public base_mcmc {
+    public:
+      rwm(const Model& model, BaseRNG& rng)
+        : base_mcmc(),
+          model_(model),
+          z_(model.num_params_r()),
+          q_propose_(model.num_params_r()),
+          u_(model.num_params_r()),
+          proposal_covar_(Eigen::MatrixXd::Identity(model.num_params_r(),
+                                                    model.num_params_r())),
+          proposal_L_(proposal_covar_),
+          rand_int_(rng),
+          rand_uniform_(rand_int_),
+          rand_unit_gaus_(rand_int_, boost::normal_distribution<>()),
+          nom_epsilon_(1),
+          epsilon_(nom_epsilon_),
+          epsilon_jitter_(0.0),
+          z_current_(false) {}
+
+      sample
+      transition(sample& init_sample,
+                 interface_callbacks::writer::base_writer& info_writer,
+                 interface_callbacks::writer::base_writer& error_writer) {
+        this->sample_stepsize();
+        this->begin_transition_(init_sample.cont_params(), error_writer);
+
+        propose_();
+        double lp_propose = log_prob_(q_propose_, error_writer);
+
+        double log_ratio = lp_propose + z_.V;
+        double accept_prob = log_ratio > 0 ? 1 : std::exp(log_ratio);
+        if (boost::math::isnan(accept_prob))
+          accept_prob = 0;
+
+        if (this->rand_uniform_() < accept_prob) {
+          z_.q.swap(q_propose_);
+          z_.V = -lp_propose;
+        }
+
+        z_current_ = true;
+        return sample(z_.q, -z_.V, accept_prob);
+      }
+
+      void
+      write_sampler_state(interface_callbacks::writer::base_writer& writer) {
+        std::stringstream nominal_stepsize;
+        nominal_stepsize << "Step size = " << get_nominal_stepsize();
+        writer(nominal_stepsize.str());
+
+        writer("Elements of proposal covariance:");
+        std::stringstream covar_ss;
+        for (int i = 0; i < proposal_covar_.rows(); ++i) {
+          covar_ss.str("");
+          covar_ss << proposal_covar_(i, 0);
+          for (int j = 1; j < proposal_covar_.cols(); ++j)
+            covar_ss << ", " << proposal_covar_(i, j);
+          writer(covar_ss.str());
+        }
+      }
+
+      void get_sampler_param_names(std::vector<std::string>& names) {
+        names.push_back("stepsize__");
+      }
+
+      void get_sampler_params(std::vector<double>& values) {
+        values.push_back(this->epsilon_);
+      }
+
+      void save_state(io::checkpoint_writer& checkpoint) {
+        checkpoint.begin_section("rwm");
+        checkpoint.write(nom_epsilon_);
+        checkpoint.write(epsilon_);
+        checkpoint.write(epsilon_jitter_);
+        checkpoint.write(z_current_);
+        checkpoint.write(proposal_covar_);
+        z_.save_state(checkpoint);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        checkpoint.begin_section("rwm");
+        checkpoint.read(nom_epsilon_);
+        checkpoint.read(epsilon_);
+        checkpoint.read(epsilon_jitter_);
+        checkpoint.read(z_current_);
+        checkpoint.read(proposal_covar_);
+        z_.load_state(checkpoint);
+        factor_proposal_();
+      }
+
+      /**
+       * Sets the covariance of the proposal, which is scaled by the
+       * square of the step size.
+       *
+       * @param covar symmetric positive definite covariance
+       * @throw std::invalid_argument if the covariance does not match
+       * the number of parameters or is not positive definite
+       */
+      void set_proposal_covariance(const Eigen::MatrixXd& covar) {
+        if (covar.rows() != z_.q.size() || covar.cols() != z_.q.size())
+          throw std::invalid_argument("The proposal covariance does not "
+                                      "match the number of parameters");
+        Eigen::LLT<Eigen::MatrixXd> llt(covar);
+        if (llt.info() != Eigen::Success)
+          throw std::invalid_argument("The proposal covariance must be "
+                                      "positive definite");
+        proposal_covar_ = covar;
+        proposal_L_ = llt.matrixL();
+      }
+
+      const Eigen::MatrixXd& get_proposal_covariance() {
+        return proposal_covar_;
+      }
+
+      /**
+       * Scales the step size until a single proposal from the current
+       * point is accepted with probability close to 0.234, the
+       * optimal rate for random walk proposals in many dimensions,
+       * mirroring the heuristic of base_hmc::init_stepsize.
+       */
+      void
+      init_stepsize(interface_callbacks::writer::base_writer& info_writer,
+                    interface_callbacks::writer::base_writer& error_writer) {
+        z_current_ = false;
+
+        // Skip initialization for extreme step sizes
+        if (this->nom_epsilon_ == 0 || this->nom_epsilon_ > 1e7)
+          return;
+
+        const double log_accept_target = std::log(0.234);
+        double lp0 = log_prob_(z_.q, error_writer);
+
+        this->epsilon_ = this->nom_epsilon_;
+        propose_();
+        double log_ratio = log_prob_(q_propose_, error_writer) - lp0;
+
+        int direction = log_ratio > log_accept_target ? 1 : -1;
+
+        while (1) {
+          this->epsilon_ = this->nom_epsilon_;
+          propose_();
+          log_ratio = log_prob_(q_propose_, error_writer) - lp0;
+
+          if ((direction == 1) && !(log_ratio > log_accept_target))
+            break;
+          else if ((direction == -1) && !(log_ratio < log_accept_target))
+            break;
+          else
+            this->nom_epsilon_
+              = direction == 1
+              ? 2.0 * this->nom_epsilon_
+              : 0.5 * this->nom_epsilon_;
+
+          if (this->nom_epsilon_ > 1e7)
+            throw std::runtime_error("Posterior is improper. "
+                                     "Please check your model.");
+          if (this->nom_epsilon_ == 0)
+            throw std::runtime_error("No acceptably small step size could "
+                                     "be found. Perhaps the posterior is "
+                                     "not continuous?");
+        }
+        this->epsilon_ = this->nom_epsilon_;
+      }
+
+      /**
+       * Returns the current point.  Only the position and the
+       * potential, the negative log density, are used.  The point may
+       * be modified through the returned reference, so its log density
+       * is recomputed at the start of the next transition.
+       *
+       * @return current point
+       */
+      ps_point& z() {
+        z_current_ = false;
+        return z_;
+      }
+
+      void seed(const Eigen::VectorXd& q) {
+        z_.q = q;
+        z_current_ = false;
+      }
+
+      virtual void set_nominal_stepsize(double e) {
+        if (e > 0)
+          nom_epsilon_ = e;
+      }
+
+      double get_nominal_stepsize() {
+        return this->nom_epsilon_;
+      }
+
+      double get_current_stepsize() {
+        return this->epsilon_;
+      }
+
+      virtual void set_stepsize_jitter(double j) {
+        if (j > 0 && j < 1)
+          epsilon_jitter_ = j;
+      }
+
+      double get_stepsize_jitter() {
+        return this->epsilon_jitter_;
+      }
+
+      void sample_stepsize() {
+        this->epsilon_ = this->nom_epsilon_;
+        if (this->epsilon_jitter_)
+          this->epsilon_ *= 1.0
+            + this->epsilon_jitter_ * (2.0 * this->rand_uniform_() - 1.0);
+      }
+
+    protected:
+      const Model& model_;
+
+      // Current position, with the negative log density as potential
+      ps_point z_;
+      Eigen::VectorXd q_propose_;
+      Eigen::VectorXd u_;
+
+      Eigen::MatrixXd proposal_covar_;
+      Eigen::MatrixXd proposal_L_;
+
+      BaseRNG& rand_int_;
+
+      // Uniform(0, 1) RNG
+      boost::uniform_01<BaseRNG&> rand_uniform_;
+
+      // Standard normal RNG
+      boost::variate_generator<BaseRNG&, boost::normal_distribution<> >
+        rand_unit_gaus_;
+
+      double nom_epsilon_;
+      double epsilon_;
+      double epsilon_jitter_;
+
+      // True while z_.V holds the potential at z_.q
+      bool z_current_;
+
+      /**
+       * Recomputes the Cholesky factor after the proposal covariance
+       * changes, which happens only at the end of an adaptation
+       * window.
+       */
+      void factor_proposal_() {
+        proposal_L_ = proposal_covar_.llt().matrixL();
+      }
+
+      void
+      begin_transition_(const Eigen::VectorXd& q,
+                        interface_callbacks::writer::base_writer& error_writer) {
+        bool reuse = z_current_
+          && q.size() == z_.q.size()
+          && q == z_.q;
+        z_current_ = false;
+
+        if (!reuse) {
+          z_.q = q;
+          z_.V = -log_prob_(z_.q, error_writer);
+        }
+      }
+
+      void propose_() {
+        for (int i = 0; i < u_.size(); ++i)
+          u_(i) = rand_unit_gaus_();
+        q_propose_.noalias() = proposal_L_.triangularView<Eigen::Lower>() * u_;
+        q_propose_ = z_.q + this->epsilon_ * q_propose_;
+      }
+
+      double
+      log_prob_(Eigen::VectorXd& q,
+                interface_callbacks::writer::base_writer& error_writer) {
+        double lp;
+        try {
+          lp = model_.template log_prob<false, true>(q, 0);
+        } catch (const std::exception& e) {
+          write_error_msg_(e, error_writer);
+          return -std::numeric_limits<double>::infinity();
+        }
+        if (boost::math::isnan(lp))
+          return -std::numeric_limits<double>::infinity();
+        return lp;
+      }
+
+      void write_error_msg_(const std::exception& e,
+                            interface_callbacks::writer::base_writer& writer) {
+        writer();
+        writer("Informational Message: The current Metropolis proposal "
+               "is about to be rejected because of the following issue:");
+        writer(e.what());
+        writer("If this warning occurs sporadically, such as for highly "
+               "constrained variable types like covariance matrices, then "
+               "the sampler is fine,");
+        writer();
+        writer("but if this warning occurs often then your model may be "
+               "either severely ill-conditioned or misspecified.");
+      }
+    };
+
+  }  // mcmc
+}  // stan
+#endif
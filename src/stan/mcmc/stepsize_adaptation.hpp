@@ -59,6 +59,11 @@ namespace stan {
         return t0_;
       }
 
+      // Dual averaged log step size of the current adaptation run
+      double get_x_bar() {
+        return x_bar_;
+      }
+
       void restart() {
         counter_ = 0;
         s_bar_ = 0;
@@ -83,8 +88,37 @@ namespace stan {
         epsilon = std::exp(x);
       }
 
+      // Leaves the step size alone when no adaptation iterations ran.
+      // With num_warmup = 0 the step size keeps its initial value,
+      // such as one loaded by a warm start, where it used to become
+      // exp(x_bar_) = exp(0) = 1.
       void complete_adaptation(double& epsilon) {
-        epsilon = std::exp(x_bar_);
+        if (counter_ > 0)
+          epsilon = std::exp(x_bar_);
+      }
+
+      void save_state(io::checkpoint_writer& checkpoint) {
+        checkpoint.begin_section("stepsize_adaptation");
+        checkpoint.write(counter_);
+        checkpoint.write(s_bar_);
+        checkpoint.write(x_bar_);
+        checkpoint.write(mu_);
+        checkpoint.write(delta_);
+        checkpoint.write(gamma_);
+        checkpoint.write(kappa_);
+        checkpoint.write(t0_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        checkpoint.begin_section("stepsize_adaptation");
+        checkpoint.read(counter_);
+        checkpoint.read(s_bar_);
+        checkpoint.read(x_bar_);
+        checkpoint.read(mu_);
+        checkpoint.read(delta_);
+        checkpoint.read(gamma_);
+        checkpoint.read(kappa_);
+        checkpoint.read(t0_);
       }
 
     protected:
@@ -1,8 +1,13 @@
 #ifndef STAN_MCMC_STEPSIZE_ADAPTER_HPP
 #define STAN_MCMC_STEPSIZE_ADAPTER_HPP
 
+#include <stan/interface_callbacks/writer/base_writer.hpp>
 #include <stan/mcmc/base_adapter.hpp>
 #include <stan/mcmc/stepsize_adaptation.hpp>
+#include <stan/mcmc/windowed_adaptation.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <cmath>
+#include <limits>
 
 namespace stan {
 
@@ -10,14 +15,119 @@ namespace stan {
 
     class stepsize_adapter: public base_adapter {
     public:
-      stepsize_adapter() { }
+      stepsize_adapter()
+        : last_x_bar_(0), num_windows_(0) { }
+
+      /**
+       * Constructor for adapters whose metric is summarized by
+       * metric_size values when measuring its change between windows.
+       *
+       * @param metric_size number of values summarizing the metric
+       */
+      explicit stepsize_adapter(int metric_size)
+        : last_metric_(Eigen::VectorXd::Ones(metric_size)),
+          last_x_bar_(0), num_windows_(0) { }
 
       stepsize_adaptation& get_stepsize_adaptation() {
         return stepsize_adaptation_;
       }
 
+      /**
+       * Lets the length of warmup follow the stability of the
+       * adaptation.  See windowed_adaptation::set_adaptive_schedule;
+       * adapters without a windowed metric adaptation ignore it.
+       *
+       * @param tolerance largest change considered stable
+       * @param max_num_warmup largest number of warmup iterations
+       */
+      void set_adaptive_schedule(double tolerance,
+                                 unsigned int max_num_warmup) {
+        windowed_adaptation* adaptation = schedule_adaptation_();
+        if (adaptation)
+          adaptation->set_adaptive_schedule(tolerance, max_num_warmup);
+      }
+
+      bool adaptation_complete() {
+        windowed_adaptation* adaptation = schedule_adaptation_();
+        return adaptation && adaptation->schedule_complete();
+      }
+
+      unsigned int max_num_warmup() {
+        windowed_adaptation* adaptation = schedule_adaptation_();
+        if (adaptation && adaptation->adaptive_schedule())
+          return adaptation->get_max_num_warmup();
+        return 0;
+      }
+
+      void save_adaptation_state(io::checkpoint_writer& checkpoint) {
+        base_adapter::save_adaptation_state(checkpoint);
+        stepsize_adaptation_.save_state(checkpoint);
+      }
+
+      void load_adaptation_state(io::checkpoint_reader& checkpoint) {
+        base_adapter::load_adaptation_state(checkpoint);
+        stepsize_adaptation_.load_state(checkpoint);
+      }
+
     protected:
       stepsize_adaptation stepsize_adaptation_;
+
+      // Adapted values at the end of the previous window
+      Eigen::VectorXd last_metric_;
+      double last_x_bar_;
+      int num_windows_;
+
+      /**
+       * Returns the windowed adaptation whose schedule follows the
+       * stability of the adaptation, or 0 if there is none.
+       */
+      virtual windowed_adaptation* schedule_adaptation_() {
+        return 0;
+      }
+
+      /**
+       * Measures how much the metric and the dual averaged step size
+       * changed since the previous adaptation window and lets an
+       * adaptive schedule react to it.  Called by the derived
+       * adapters when their metric adaptation closes a window, before
+       * the step size adaptation restarts.  The first window has
+       * nothing to compare against and never counts as stable.
+       *
+       * @param metric values summarizing the metric estimated over
+       * the window; the change is their relative Euclidean distance
+       * to the values of the previous window
+       * @param writer writer for the schedule
+       */
+      void update_schedule_(const Eigen::VectorXd& metric,
+                            interface_callbacks::writer::base_writer&
+                            writer) {
+        double metric_change = std::numeric_limits<double>::infinity();
+        double stepsize_change = std::numeric_limits<double>::infinity();
+        double x_bar = stepsize_adaptation_.get_x_bar();
+        if (num_windows_ > 0) {
+          metric_change = (metric - last_metric_).norm() / last_metric_.norm();
+          stepsize_change = std::fabs(x_bar - last_x_bar_);
+        }
+        last_metric_ = metric;
+        last_x_bar_ = x_bar;
+        ++num_windows_;
+
+        windowed_adaptation* adaptation = schedule_adaptation_();
+        if (adaptation)
+          adaptation->adapt_schedule(metric_change, stepsize_change, writer);
+      }
+
+      void save_schedule_state_(io::checkpoint_writer& checkpoint) {
+        checkpoint.write(last_metric_);
+        checkpoint.write(last_x_bar_);
+        checkpoint.write(num_windows_);
+      }
+
+      void load_schedule_state_(io::checkpoint_reader& checkpoint) {
+        checkpoint.read(last_metric_);
+        checkpoint.read(last_x_bar_);
+        checkpoint.read(num_windows_);
+      }
     };
 
   }  // mcmc
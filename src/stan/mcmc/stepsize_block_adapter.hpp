@@ -0,0 +1,83 @@
+#ifndef STAN_MCMC_STEPSIZE_BLOCK_ADAPTER_HPP
+#define STAN_MCMC_STEPSIZE_BLOCK_ADAPTER_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/stepsize_adapter.hpp>
+#include <stan/mcmc/block_adaptation.hpp>
+#include <stan/mcmc/hmc/hamiltonians/block_e_point.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <vector>
+
+namespace stan {
+
+  namespace mcmc {
+
+    class stepsize_block_adapter: public stepsize_adapter {
+    public:
+      explicit stepsize_block_adapter(int n)
+        : stepsize_adapter(n), block_adaptation_(n),
+          adapted_blocks_(), adapted_mInv_() {
+      }
+
+      block_adaptation& get_block_adaptation() {
+        return block_adaptation_;
+      }
+
+      void set_window_params(unsigned int num_warmup,
+                             unsigned int init_buffer,
+                             unsigned int term_buffer,
+                             unsigned int base_window,
+                             interface_callbacks::writer::base_writer& writer) {
+        block_adaptation_.set_window_params(num_warmup,
+                                            init_buffer,
+                                            term_buffer,
+                                            base_window,
+                                            writer);
+      }
+
+      /**
+       * Lets an adaptive schedule react to the metric estimated over
+       * the window just closed.  The change is measured on the
+       * diagonal of the metric, which stays comparable when the
+       * blocks are detected after the first window.
+       *
+       * @param z point holding the metric estimated over the window
+       * @param writer writer for the schedule
+       */
+      void update_schedule(const block_e_point& z,
+                           interface_callbacks::writer::base_writer& writer) {
+        update_schedule_(z.mInv_full_diag(), writer);
+      }
+
+      void save_adaptation_state(io::checkpoint_writer& checkpoint) {
+        base_adapter::save_adaptation_state(checkpoint);
+        stepsize_adaptation_.save_state(checkpoint);
+        block_adaptation_.save_state(checkpoint);
+        save_schedule_state_(checkpoint);
+      }
+
+      void load_adaptation_state(io::checkpoint_reader& checkpoint) {
+        base_adapter::load_adaptation_state(checkpoint);
+        stepsize_adaptation_.load_state(checkpoint);
+        block_adaptation_.load_state(checkpoint);
+        load_schedule_state_(checkpoint);
+      }
+
+    protected:
+      block_adaptation block_adaptation_;
+
+      // Metric estimated at the end of a window, before it is set on
+      // the point
+      std::vector<std::vector<int> > adapted_blocks_;
+      std::vector<Eigen::MatrixXd> adapted_mInv_;
+
+      windowed_adaptation* schedule_adaptation_() {
+        return &block_adaptation_;
+      }
+    };
+
+  }  // mcmc
+
+}  // stan
+
+#endif
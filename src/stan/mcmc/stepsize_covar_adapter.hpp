@@ -2,22 +2,19 @@
 #define STAN_MCMC_STEPSIZE_COVAR_ADAPTER_HPP
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
-#include <stan/mcmc/base_adapter.hpp>
-#include <stan/mcmc/stepsize_adaptation.hpp>
+#include <stan/mcmc/stepsize_adapter.hpp>
 #include <stan/mcmc/covar_adaptation.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
 
 namespace stan {
 
   namespace mcmc {
 
-    class stepsize_covar_adapter: public base_adapter {
+    class stepsize_covar_adapter: public stepsize_adapter {
     public:
       explicit stepsize_covar_adapter(int n)
-        : covar_adaptation_(n) {
-      }
-
-      stepsize_adaptation& get_stepsize_adaptation() {
-        return stepsize_adaptation_;
+        : stepsize_adapter(n * n), covar_adaptation_(n),
+          covar_(Eigen::MatrixXd::Identity(n, n)) {
       }
 
       covar_adaptation& get_covar_adaptation() {
@@ -36,9 +33,44 @@ namespace stan {
                                             writer);
       }
 
+      /**
+       * Lets an adaptive schedule react to the covariance estimated
+       * over the window just closed by learn_covariance.  The change
+       * is measured on all of the matrix's elements.
+       *
+       * @param metric metric estimated over the window
+       * @param writer writer for the schedule
+       */
+      void update_schedule(const Eigen::MatrixXd& metric,
+                           interface_callbacks::writer::base_writer& writer) {
+        update_schedule_(Eigen::Map<const Eigen::VectorXd>(metric.data(),
+                                                           metric.size()),
+                         writer);
+      }
+
+      void save_adaptation_state(io::checkpoint_writer& checkpoint) {
+        base_adapter::save_adaptation_state(checkpoint);
+        stepsize_adaptation_.save_state(checkpoint);
+        covar_adaptation_.save_state(checkpoint);
+        save_schedule_state_(checkpoint);
+      }
+
+      void load_adaptation_state(io::checkpoint_reader& checkpoint) {
+        base_adapter::load_adaptation_state(checkpoint);
+        stepsize_adaptation_.load_state(checkpoint);
+        covar_adaptation_.load_state(checkpoint);
+        load_schedule_state_(checkpoint);
+      }
+
     protected:
-      stepsize_adaptation stepsize_adaptation_;
       covar_adaptation covar_adaptation_;
+      // Covariance estimated over the last window, which adapters
+      // hand to metrics that refactor it when it is set
+      Eigen::MatrixXd covar_;
+
+      windowed_adaptation* schedule_adaptation_() {
+        return &covar_adaptation_;
+      }
     };
 
   }  // mcmc
@@ -0,0 +1,82 @@
+#ifndef STAN_MCMC_STEPSIZE_LOWRANK_ADAPTER_HPP
+#define STAN_MCMC_STEPSIZE_LOWRANK_ADAPTER_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/mcmc/stepsize_adapter.hpp>
+#include <stan/mcmc/lowrank_adaptation.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_point.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+
+namespace stan {
+
+  namespace mcmc {
+
+    class stepsize_lowrank_adapter: public stepsize_adapter {
+    public:
+      explicit stepsize_lowrank_adapter(int n)
+        : stepsize_adapter(n), lowrank_adaptation_(n),
+          adapted_diag_(n), adapted_factor_(n, 0) {
+      }
+
+      lowrank_adaptation& get_lowrank_adaptation() {
+        return lowrank_adaptation_;
+      }
+
+      void set_window_params(unsigned int num_warmup,
+                             unsigned int init_buffer,
+                             unsigned int term_buffer,
+                             unsigned int base_window,
+                             interface_callbacks::writer::base_writer& writer) {
+        lowrank_adaptation_.set_window_params(num_warmup,
+                                              init_buffer,
+                                              term_buffer,
+                                              base_window,
+                                              writer);
+      }
+
+      /**
+       * Lets an adaptive schedule react to the metric estimated over
+       * the window just closed.  The change is measured on the
+       * diagonal of the full inverse metric, which costs O(D k)
+       * instead of forming the D x D matrix.
+       *
+       * @param z point holding the metric estimated over the window
+       * @param writer writer for the schedule
+       */
+      void update_schedule(const lowrank_e_point& z,
+                           interface_callbacks::writer::base_writer& writer) {
+        update_schedule_(z.mInv_full_diag(), writer);
+      }
+
+      void save_adaptation_state(io::checkpoint_writer& checkpoint) {
+        base_adapter::save_adaptation_state(checkpoint);
+        stepsize_adaptation_.save_state(checkpoint);
+        lowrank_adaptation_.save_state(checkpoint);
+        save_schedule_state_(checkpoint);
+      }
+
+      void load_adaptation_state(io::checkpoint_reader& checkpoint) {
+        base_adapter::load_adaptation_state(checkpoint);
+        stepsize_adaptation_.load_state(checkpoint);
+        lowrank_adaptation_.load_state(checkpoint);
+        load_schedule_state_(checkpoint);
+      }
+
+    protected:
+      lowrank_adaptation lowrank_adaptation_;
+
+      // Metric estimated at the end of a window, before it is set on
+      // the point
+      Eigen::VectorXd adapted_diag_;
+      Eigen::MatrixXd adapted_factor_;
+
+      windowed_adaptation* schedule_adaptation_() {
+        return &lowrank_adaptation_;
+      }
+    };
+
+  }  // mcmc
+
+}  // stan
+
+#endif
@@ -2,21 +2,17 @@
 #define STAN_MCMC_STEPSIZE_VAR_ADAPTER_HPP
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
-#include <stan/mcmc/base_adapter.hpp>
-#include <stan/mcmc/stepsize_adaptation.hpp>
+#include <stan/mcmc/stepsize_adapter.hpp>
 #include <stan/mcmc/var_adaptation.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
 
 namespace stan {
   namespace mcmc {
 
-    class stepsize_var_adapter: public base_adapter {
+    class stepsize_var_adapter: public stepsize_adapter {
     public:
       explicit stepsize_var_adapter(int n)
-        : var_adaptation_(n) {
-      }
-
-      stepsize_adaptation& get_stepsize_adaptation() {
-        return stepsize_adaptation_;
+        : stepsize_adapter(n), var_adaptation_(n) {
       }
 
       var_adaptation& get_var_adaptation() {
@@ -35,10 +31,38 @@ namespace stan {
                                           writer);
       }
 
+      /**
+       * Lets an adaptive schedule react to the variance estimated
+       * over the window just closed by learn_variance.
+       *
+       * @param metric metric estimated over the window
+       * @param writer writer for the schedule
+       */
+      void update_schedule(const Eigen::VectorXd& metric,
+                           interface_callbacks::writer::base_writer& writer) {
+        update_schedule_(metric, writer);
+      }
+
+      void save_adaptation_state(io::checkpoint_writer& checkpoint) {
+        base_adapter::save_adaptation_state(checkpoint);
+        stepsize_adaptation_.save_state(checkpoint);
+        var_adaptation_.save_state(checkpoint);
+        save_schedule_state_(checkpoint);
+      }
+
+      void load_adaptation_state(io::checkpoint_reader& checkpoint) {
+        base_adapter::load_adaptation_state(checkpoint);
+        stepsize_adaptation_.load_state(checkpoint);
+        var_adaptation_.load_state(checkpoint);
+        load_schedule_state_(checkpoint);
+      }
 
     protected:
-      stepsize_adaptation stepsize_adaptation_;
       var_adaptation var_adaptation_;
+
+      windowed_adaptation* schedule_adaptation_() {
+        return &var_adaptation_;
+      }
     };
 
   }  // mcmc
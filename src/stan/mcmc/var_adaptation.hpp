@@ -3,7 +3,10 @@
 
 #include <stan/math/prim/mat/fun/Eigen.hpp>
 #include <stan/mcmc/windowed_adaptation.hpp>
+#include <stan/mcmc/welford_checkpoint.hpp>
+#include <stan/mcmc/var_adaptation_pool.hpp>
 #include <stan/math/prim/mat/fun/welford_var_estimator.hpp>
+#include <stdexcept>
 #include <vector>
 
 namespace stan {
@@ -13,9 +16,30 @@ namespace stan {
     class var_adaptation: public windowed_adaptation {
     public:
       explicit var_adaptation(int n)
-        : windowed_adaptation("variance"), estimator_(n) {}
+        : windowed_adaptation("variance"), estimator_(n),
+          pool_(0), pool_generation_(0), waiting_(false) {}
+
+      /**
+       * Estimates the variance from the draws of every chain that
+       * joins the specified pool instead of from this chain alone.
+       * Chains sharing a pool must use the same window parameters and
+       * be advanced in lockstep, one transition per chain in turn.
+       * When resuming, set the pool before loading the state of this
+       * adaptation, and load the pool itself once.
+       *
+       * @param pool pool to join; must outlive this adaptation
+       */
+      void set_pool(var_adaptation_pool* pool) {
+        pool_ = pool;
+        pool_->join();
+        pool_generation_ = pool_->generation();
+        waiting_ = false;
+      }
 
       bool learn_variance(Eigen::VectorXd& var, const Eigen::VectorXd& q) {
+        if (pool_)
+          return learn_pooled_variance_(var, q);
+
         if (adaptation_window())
           estimator_.add_sample(q);
 
@@ -38,8 +62,74 @@ namespace stan {
         return false;
       }
 
+      /**
+       * Copies the pooled variance into var if it was published after
+       * this chain closed its last window.  Such a chain otherwise
+       * picks the estimate up only at its next call to learn_variance,
+       * which never comes once adaptation is disengaged.
+       *
+       * @return true if var was updated
+       */
+      bool pick_up_pooled_variance(Eigen::VectorXd& var) {
+        return pool_ && pick_up_pooled_(var);
+      }
+
+      void save_state(io::checkpoint_writer& checkpoint) {
+        windowed_adaptation::save_state(checkpoint);
+        write_estimator(checkpoint, estimator_);
+        checkpoint.write(pool_generation_);
+        checkpoint.write(waiting_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        windowed_adaptation::load_state(checkpoint);
+        read_estimator(checkpoint, estimator_);
+        checkpoint.read(pool_generation_);
+        checkpoint.read(waiting_);
+      }
+
     protected:
       stan::math::welford_var_estimator estimator_;
+
+      var_adaptation_pool* pool_;
+      unsigned int pool_generation_;
+      // True between the end of a window and the pooled update
+      bool waiting_;
+
+      // The last chain to finish a window computes the pooled
+      // variance; chains that finished before it pick it up at
+      // their next call, so no draw is added to a window that has
+      // not been closed by every chain.
+      bool learn_pooled_variance_(Eigen::VectorXd& var,
+                                  const Eigen::VectorXd& q) {
+        bool update = pick_up_pooled_(var);
+
+        if (adaptation_window()) {
+          if (waiting_)
+            throw std::logic_error("Chains sharing an adaptation pool "
+                                   "must be advanced in lockstep");
+          pool_->add_sample(q);
+        }
+
+        if (end_adaptation_window()) {
+          compute_next_window();
+          waiting_ = true;
+          pool_->end_window();
+          update = pick_up_pooled_(var) || update;
+        }
+
+        ++adapt_window_counter_;
+        return update;
+      }
+
+      bool pick_up_pooled_(Eigen::VectorXd& var) {
+        if (!waiting_ || pool_->generation() == pool_generation_)
+          return false;
+        var = pool_->variance();
+        pool_generation_ = pool_->generation();
+        waiting_ = false;
+        return true;
+      }
     };
 
   }  // mcmc
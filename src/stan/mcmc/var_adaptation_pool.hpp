@@ -0,0 +1,101 @@
+#ifndef STAN_MCMC_VAR_ADAPTATION_POOL_HPP
+#define STAN_MCMC_VAR_ADAPTATION_POOL_HPP
+
+#include <stan/io/checkpoint.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/mcmc/welford_checkpoint.hpp>
+#include <stan/math/prim/mat/fun/welford_var_estimator.hpp>
+
+namespace stan {
+
+  namespace mcmc {
+
+    /**
+     * Variance estimator shared by the var_adaptation of several
+     * chains that warm up together.
+     *
+     * Every chain adds its draws to one Welford estimator.  When the
+     * last chain of the pool reaches the end of an adaptation window
+     * the pooled variance is computed, regularized as in
+     * var_adaptation, and published under a new generation number
+     * for every chain to pick up.
+     */
+    class var_adaptation_pool {
+    public:
+      explicit var_adaptation_pool(int n)
+        : estimator_(n), var_(Eigen::VectorXd::Ones(n)),
+          num_chains_(0), num_arrived_(0), generation_(0) {}
+
+      void join() {
+        ++num_chains_;
+      }
+
+      int num_chains() const {
+        return num_chains_;
+      }
+
+      unsigned int generation() const {
+        return generation_;
+      }
+
+      const Eigen::VectorXd& variance() const {
+        return var_;
+      }
+
+      void add_sample(const Eigen::VectorXd& q) {
+        estimator_.add_sample(q);
+      }
+
+      /**
+       * Records that a chain reached the end of the current window.
+       * The last chain to arrive computes the pooled variance.
+       */
+      void end_window() {
+        if (++num_arrived_ < num_chains_)
+          return;
+
+        estimator_.sample_variance(var_);
+
+        double n = static_cast<double>(estimator_.num_samples());
+        var_ = (n / (n + 5.0)) * var_
+               + 1e-3 * (5.0 / (n + 5.0)) * Eigen::VectorXd::Ones(var_.size());
+
+        estimator_.restart();
+        num_arrived_ = 0;
+        ++generation_;
+      }
+
+      /**
+       * Saves the pooled draws and the published estimate.  The
+       * chains are not saved; they join again when their adaptations
+       * are given the restored pool.
+       */
+      void save_state(io::checkpoint_writer& checkpoint) {
+        checkpoint.begin_section("var_adaptation_pool");
+        write_estimator(checkpoint, estimator_);
+        checkpoint.write(var_);
+        checkpoint.write(num_arrived_);
+        checkpoint.write(generation_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        checkpoint.begin_section("var_adaptation_pool");
+        read_estimator(checkpoint, estimator_);
+        checkpoint.read(var_);
+        checkpoint.read(num_arrived_);
+        checkpoint.read(generation_);
+      }
+
+    protected:
+      stan::math::welford_var_estimator estimator_;
+      Eigen::VectorXd var_;
+
+      int num_chains_;
+      int num_arrived_;
+      unsigned int generation_;
+    };
+
+  }  // mcmc
+
+}  // stan
+#endif
@@ -0,0 +1,120 @@
+#ifndef STAN_MCMC_WELFORD_CHECKPOINT_HPP
+#define STAN_MCMC_WELFORD_CHECKPOINT_HPP
+
+#include <stan/io/checkpoint.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat/fun/welford_covar_estimator.hpp>
+#include <stan/math/prim/mat/fun/welford_var_estimator.hpp>
+
+namespace stan {
+
+  namespace mcmc {
+
+    namespace internal {
+
+      // Stan Math keeps the running sums of the Welford estimators
+      // protected; a derived class may name them, which gives the
+      // checkpoint pointers to them without touching the estimators'
+      // interface.
+      struct welford_var_access
+        : public stan::math::welford_var_estimator {
+        typedef stan::math::welford_var_estimator estimator_t;
+
+        static double estimator_t::* num_samples() {
+          return &welford_var_access::num_samples_;
+        }
+
+        static Eigen::VectorXd estimator_t::* m() {
+          return &welford_var_access::m_;
+        }
+
+        static Eigen::VectorXd estimator_t::* m2() {
+          return &welford_var_access::m2_;
+        }
+      };
+
+      struct welford_covar_access
+        : public stan::math::welford_covar_estimator {
+        typedef stan::math::welford_covar_estimator estimator_t;
+
+        static double estimator_t::* num_samples() {
+          return &welford_covar_access::num_samples_;
+        }
+
+        static Eigen::VectorXd estimator_t::* m() {
+          return &welford_covar_access::m_;
+        }
+
+        static Eigen::MatrixXd estimator_t::* m2() {
+          return &welford_covar_access::m2_;
+        }
+      };
+
+    }
+
+    /**
+     * Writes the running sums of a variance estimator to a
+     * checkpoint.
+     *
+     * @param checkpoint checkpoint writer
+     * @param estimator estimator to save
+     */
+    inline void
+    write_estimator(io::checkpoint_writer& checkpoint,
+                    const stan::math::welford_var_estimator& estimator) {
+      typedef internal::welford_var_access access;
+      checkpoint.write(estimator.*access::num_samples());
+      checkpoint.write(estimator.*access::m());
+      checkpoint.write(estimator.*access::m2());
+    }
+
+    /**
+     * Restores the running sums written by write_estimator.
+     *
+     * @param checkpoint checkpoint reader
+     * @param estimator estimator of the same size as the one saved
+     */
+    inline void
+    read_estimator(io::checkpoint_reader& checkpoint,
+                   stan::math::welford_var_estimator& estimator) {
+      typedef internal::welford_var_access access;
+      checkpoint.read(estimator.*access::num_samples());
+      checkpoint.read(estimator.*access::m());
+      checkpoint.read(estimator.*access::m2());
+    }
+
+    /**
+     * Writes the running sums of a covariance estimator to a
+     * checkpoint.
+     *
+     * @param checkpoint checkpoint writer
+     * @param estimator estimator to save
+     */
+    inline void
+    write_estimator(io::checkpoint_writer& checkpoint,
+                    const stan::math::welford_covar_estimator& estimator) {
+      typedef internal::welford_covar_access access;
+      checkpoint.write(estimator.*access::num_samples());
+      checkpoint.write(estimator.*access::m());
+      checkpoint.write(estimator.*access::m2());
+    }
+
+    /**
+     * Restores the running sums written by write_estimator.
+     *
+     * @param checkpoint checkpoint reader
+     * @param estimator estimator of the same size as the one saved
+     */
+    inline void
+    read_estimator(io::checkpoint_reader& checkpoint,
+                   stan::math::welford_covar_estimator& estimator) {
+      typedef internal::welford_covar_access access;
+      checkpoint.read(estimator.*access::num_samples());
+      checkpoint.read(estimator.*access::m());
+      checkpoint.read(estimator.*access::m2());
+    }
+
+  }  // mcmc
+
+}  // stan
+#endif
@@ -3,7 +3,9 @@
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
 #include <stan/mcmc/base_adaptation.hpp>
+#include <algorithm>
 #include <ostream>
+#include <sstream>
 #include <string>
 
 namespace stan {
@@ -18,6 +20,10 @@ namespace stan {
         adapt_term_buffer_ = 0;
         adapt_base_window_ = 0;
 
+        adaptive_schedule_ = false;
+        schedule_tolerance_ = 0;
+        max_num_warmup_ = 0;
+
         restart();
       }
 
@@ -75,6 +81,96 @@ namespace stan {
         restart();
       }
 
+      /**
+       * Lets the length of warmup follow how much the adapted values
+       * change between adaptation windows.  When the change over a
+       * window falls below the tolerance, the remaining windows are
+       * dropped and warmup ends after the terminal buffer.  While the
+       * change stays above it, the last window is followed by further
+       * windows, up to max_num_warmup iterations in total.  Must be
+       * called after set_window_params, and has no effect when
+       * num_warmup was too short for any adaptation window.
+       *
+       * @param tolerance largest change considered stable; a
+       * nonpositive tolerance restores the fixed schedule
+       * @param max_num_warmup largest number of warmup iterations
+       */
+      void set_adaptive_schedule(double tolerance,
+                                 unsigned int max_num_warmup) {
+        adaptive_schedule_ = tolerance > 0 && num_warmup_ > 0;
+        schedule_tolerance_ = tolerance;
+        max_num_warmup_ = std::max(max_num_warmup, num_warmup_);
+      }
+
+      bool adaptive_schedule() {
+        return adaptive_schedule_;
+      }
+
+      unsigned int get_num_warmup() {
+        return num_warmup_;
+      }
+
+      unsigned int get_max_num_warmup() {
+        return max_num_warmup_;
+      }
+
+      /**
+       * Returns true once an adaptive schedule has run every warmup
+       * iteration; a fixed schedule never reports completion.
+       */
+      bool schedule_complete() {
+        return adaptive_schedule_ && adapt_window_counter_ >= num_warmup_;
+      }
+
+      /**
+       * Shortens or extends an adaptive schedule at the end of an
+       * adaptation window and reports the decision.  Must be called
+       * after the window has been closed by the derived class.
+       *
+       * @param metric_change relative change of the metric over the
+       * window
+       * @param stepsize_change absolute change of the log step size
+       * over the window
+       * @param writer writer for the schedule
+       */
+      void adapt_schedule(double metric_change, double stepsize_change,
+                          interface_callbacks::writer::base_writer& writer) {
+        if (!adaptive_schedule_)
+          return;
+
+        unsigned int window_end = adapt_window_counter_;
+        bool last_window = adapt_next_window_ < window_end;
+
+        std::stringstream msg;
+        msg << "Adaptation window ending at iteration " << window_end
+            << ": metric change = " << metric_change
+            << ", step size change = " << stepsize_change;
+        writer(msg.str());
+
+        unsigned int num_warmup = num_warmup_;
+        if (std::max(metric_change, stepsize_change) < schedule_tolerance_) {
+          if (!last_window) {
+            num_warmup_ = window_end + adapt_term_buffer_;
+            adapt_next_window_ = window_end - 1;
+          }
+        } else if (last_window) {
+          unsigned int extension
+            = std::min(adapt_window_size_, max_num_warmup_ - num_warmup_);
+          if (extension > 0 && extension >= adapt_base_window_) {
+            num_warmup_ += extension;
+            adapt_next_window_ = num_warmup_ - adapt_term_buffer_ - 1;
+          }
+        }
+
+        if (num_warmup_ != num_warmup) {
+          msg.str("");
+          msg << "Warmup " << (num_warmup_ < num_warmup
+                               ? "shortened" : "extended")
+              << " to " << num_warmup_ << " iterations";
+          writer(msg.str());
+        }
+      }
+
       bool adaptation_window() {
         return (adapt_window_counter_ >= adapt_init_buffer_)
                && (adapt_window_counter_ < num_warmup_ - adapt_term_buffer_)
@@ -106,6 +202,34 @@ namespace stan {
         }
       }
 
+      void save_state(io::checkpoint_writer& checkpoint) {
+        checkpoint.begin_section("windowed_adaptation");
+        checkpoint.write(num_warmup_);
+        checkpoint.write(adapt_init_buffer_);
+        checkpoint.write(adapt_term_buffer_);
+        checkpoint.write(adapt_base_window_);
+        checkpoint.write(adapt_window_counter_);
+        checkpoint.write(adapt_next_window_);
+        checkpoint.write(adapt_window_size_);
+        checkpoint.write(adaptive_schedule_);
+        checkpoint.write(schedule_tolerance_);
+        checkpoint.write(max_num_warmup_);
+      }
+
+      void load_state(io::checkpoint_reader& checkpoint) {
+        checkpoint.begin_section("windowed_adaptation");
+        checkpoint.read(num_warmup_);
+        checkpoint.read(adapt_init_buffer_);
+        checkpoint.read(adapt_term_buffer_);
+        checkpoint.read(adapt_base_window_);
+        checkpoint.read(adapt_window_counter_);
+        checkpoint.read(adapt_next_window_);
+        checkpoint.read(adapt_window_size_);
+        checkpoint.read(adaptive_schedule_);
+        checkpoint.read(schedule_tolerance_);
+        checkpoint.read(max_num_warmup_);
+      }
+
     protected:
       std::string estimator_name_;
 
@@ -117,6 +241,10 @@ namespace stan {
       unsigned int adapt_window_counter_;
       unsigned int adapt_next_window_;
       unsigned int adapt_window_size_;
+
+      bool adaptive_schedule_;
+      double schedule_tolerance_;
+      unsigned int max_num_warmup_;
     };
 
   }  // mcmc
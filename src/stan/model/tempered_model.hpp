@@ -0,0 +1,77 @@
+#ifndef STAN_MODEL_TEMPERED_MODEL_HPP
+#define STAN_MODEL_TEMPERED_MODEL_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+  namespace model {
+
+    /**
+     * Adapts a model so that its log density is multiplied by an
+     * inverse temperature beta, targeting p(q)^beta.
+     *
+     * The adaptor exposes the parts of the model interface used by
+     * the samplers, so any sampler can be instantiated with it.  It
+     * holds a reference to the underlying model, which must outlive
+     * it, and never copies the model's data.
+     *
+     * @tparam Model type of the underlying model
+     */
+    template <class Model>
+    class tempered_model {
+    public:
+      /**
+       * @param model underlying model
+       * @param beta inverse temperature, 1 for the untempered model
+       */
+      explicit tempered_model(const Model& model, double beta = 1)
+        : model_(model), beta_(beta) {}
+
+      inline size_t num_params_r() const {
+        return model_.num_params_r();
+      }
+
+      inline size_t num_params_i() const {
+        return model_.num_params_i();
+      }
+
+      template <bool propto, bool jacobian_adjust_transform, typename T>
+      T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+                 std::ostream* msgs = 0) const {
+        return beta_ * model_.template log_prob<propto,
+                                                jacobian_adjust_transform,
+                                                T>(params_r, msgs);
+      }
+
+      template <bool propto, bool jacobian_adjust_transform, typename T>
+      T log_prob(std::vector<T>& params_r,
+                 std::vector<int>& params_i,
+                 std::ostream* msgs = 0) const {
+        return beta_ * model_.template log_prob<propto,
+                                                jacobian_adjust_transform,
+                                                T>(params_r, params_i, msgs);
+      }
+
+      void set_inverse_temperature(double beta) {
+        beta_ = beta;
+      }
+
+      double get_inverse_temperature() const {
+        return beta_;
+      }
+
+      const Model& model() const {
+        return model_;
+      }
+
+    private:
+      const Model& model_;
+      double beta_;
+    };
+
+  }
+}
+#endif
@@ -488,6 +488,52 @@ namespace stan {
                                             x, X, grad_tr_X_hess_f);
     }
 
+    /**
+     * Compute the gradient of the bilinear form u^T H w of the
+     * Hessian H of the log density with a single third-order sweep,
+     * where grad_tr_mat_times_hessian needs one sweep per parameter.
+     *
+     * @tparam M Class of model
+     * @param[in] model Model
+     * @param[in] x Parameters
+     * @param[in] u Left vector of the bilinear form
+     * @param[in] w Right vector of the bilinear form
+     * @param[out] grad_u_hess_f_w Gradient of u^T H w
+     * @param[in,out] msgs Stream to which print statements in Stan
+     * programs are written, default is 0
+     */
+    template <class M>
+    void grad_hessian_bilinear_form(const M& model,
+            const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+            const Eigen::Matrix<double, Eigen::Dynamic, 1>& u,
+            const Eigen::Matrix<double, Eigen::Dynamic, 1>& w,
+            Eigen::Matrix<double, Eigen::Dynamic, 1>& grad_u_hess_f_w,
+            std::ostream* msgs = 0) {
+      using stan::math::fvar;
+      using stan::math::var;
+      stan::math::start_nested();
+      try {
+        Eigen::Matrix<var, Eigen::Dynamic, 1> x_var(x.size());
+        Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> x_fvar(x.size());
+        for (int i = 0; i < x.size(); ++i) {
+          x_var(i) = x(i);
+          x_fvar(i) = fvar<var>(x_var(i), w(i));
+        }
+        fvar<var> fx;
+        fvar<var> grad_fx_dot_u;
+        stan::math::gradient_dot_vector(model_functional<M>(model, msgs),
+                                        x_fvar, u, fx, grad_fx_dot_u);
+        stan::math::grad(grad_fx_dot_u.d_.vi_);
+        grad_u_hess_f_w.resize(x.size());
+        for (int i = 0; i < x.size(); ++i)
+          grad_u_hess_f_w(i) = x_var(i).adj();
+      } catch (const std::exception& e) {
+        stan::math::recover_memory_nested();
+        throw;
+      }
+      stan::math::recover_memory_nested();
+    }
+
   }
 }
 #endif
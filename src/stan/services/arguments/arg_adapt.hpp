@@ -10,6 +10,8 @@
 #include <stan/services/arguments/arg_adapt_init_buffer.hpp>
 #include <stan/services/arguments/arg_adapt_term_buffer.hpp>
 #include <stan/services/arguments/arg_adapt_window.hpp>
+#include <stan/services/arguments/arg_adapt_tolerance.hpp>
+#include <stan/services/arguments/arg_adapt_max_warmup.hpp>
 
 namespace stan {
   namespace services {
@@ -27,6 +29,8 @@ namespace stan {
         _subarguments.push_back(new arg_adapt_init_buffer());
         _subarguments.push_back(new arg_adapt_term_buffer());
         _subarguments.push_back(new arg_adapt_window());
+        _subarguments.push_back(new arg_adapt_tolerance());
+        _subarguments.push_back(new arg_adapt_max_warmup());
       }
     };
 
@@ -0,0 +1,24 @@
+#ifndef STAN_SERVICES_ARGUMENTS_ARG_ADAPT_MAX_WARMUP_HPP
+#define STAN_SERVICES_ARGUMENTS_ARG_ADAPT_MAX_WARMUP_HPP
+
+#include <stan/services/arguments/singleton_argument.hpp>
+
+namespace stan {
+  namespace services {
+
+    class arg_adapt_max_warmup: public u_int_argument {
+    public:
+      arg_adapt_max_warmup(): u_int_argument() {
+        _name = "max_warmup";
+        _description = "Largest number of warmup iterations when the schedule "
+                       "adapts, 0 to use num_warmup";
+        _default = "0";
+        _default_value = 0;
+        _value = _default_value;
+      }
+    };
+
+  }  // services
+}  // stan
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef STAN_SERVICES_ARGUMENTS_ARG_ADAPT_TOLERANCE_HPP
+#define STAN_SERVICES_ARGUMENTS_ARG_ADAPT_TOLERANCE_HPP
+
+#include <stan/services/arguments/singleton_argument.hpp>
+
+namespace stan {
+
+  namespace services {
+
+    class arg_adapt_tolerance: public real_argument {
+    public:
+      arg_adapt_tolerance(): real_argument() {
+        _name = "tolerance";
+        _description = "Change between slow adaptation intervals below which "
+                       "warmup ends early, 0 for a fixed schedule";
+        _validity = "0 <= tolerance";
+        _default = "0";
+        _default_value = 0.0;
+        _constrained = true;
+        _good_value = 0.1;
+        _bad_value = -1.0;
+        _value = _default_value;
+      }
+
+      bool is_valid(double value) { return 0 <= value; }
+    };
+
+  }  // services
+}  // stan
+
+#endif
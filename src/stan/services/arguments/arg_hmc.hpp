@@ -4,6 +4,7 @@
 #include <stan/services/arguments/categorical_argument.hpp>
 #include <stan/services/arguments/arg_engine.hpp>
 #include <stan/services/arguments/arg_metric.hpp>
+#include <stan/services/arguments/arg_integrator.hpp>
 #include <stan/services/arguments/arg_stepsize.hpp>
 #include <stan/services/arguments/arg_stepsize_jitter.hpp>
 
@@ -18,6 +19,7 @@ namespace stan {
 
         _subarguments.push_back(new arg_engine());
         _subarguments.push_back(new arg_metric());
+        _subarguments.push_back(new arg_integrator());
         _subarguments.push_back(new arg_stepsize());
         _subarguments.push_back(new arg_stepsize_jitter());
       }
@@ -2,6 +2,8 @@
 #define STAN_SERVICES_ARGUMENTS_ARG_RWM_HPP
 
 #include <stan/services/arguments/categorical_argument.hpp>
+#include <stan/services/arguments/arg_stepsize.hpp>
+#include <stan/services/arguments/arg_stepsize_jitter.hpp>
 
 namespace stan {
   namespace services {
@@ -11,6 +13,9 @@ namespace stan {
       arg_rwm() {
         _name = "rwm";
         _description = "Random Walk Metropolis Monte Carlo";
+
+        _subarguments.push_back(new arg_stepsize());
+        _subarguments.push_back(new arg_stepsize_jitter());
       }
     };
 
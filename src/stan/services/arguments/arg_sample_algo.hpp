@@ -3,6 +3,7 @@
 
 #include <stan/services/arguments/list_argument.hpp>
 #include <stan/services/arguments/arg_hmc.hpp>
+#include <stan/services/arguments/arg_rwm.hpp>
 #include <stan/services/arguments/arg_fixed_param.hpp>
 
 namespace stan {
@@ -15,6 +16,7 @@ namespace stan {
         _description = "Sampling algorithm";
 
         _values.push_back(new arg_hmc());
+        _values.push_back(new arg_rwm());
         _values.push_back(new arg_fixed_param());
 
         _default_cursor = 0;
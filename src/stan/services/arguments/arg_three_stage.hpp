@@ -0,0 +1,21 @@
+#ifndef STAN_SERVICES_ARGUMENTS_ARG_THREE_STAGE_HPP
+#define STAN_SERVICES_ARGUMENTS_ARG_THREE_STAGE_HPP
+
+#include <stan/services/arguments/unvalued_argument.hpp>
+
+namespace stan {
+  namespace services {
+
+    class arg_three_stage: public unvalued_argument {
+    public:
+      arg_three_stage() {
+        _name = "three_stage";
+        _description = "Three stage splitting, three gradients per step";
+      }
+    };
+
+  }  // services
+}  // stan
+
+#endif
+
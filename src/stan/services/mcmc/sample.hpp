@@ -3,9 +3,11 @@
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/convergence_monitor.hpp>
 #include <stan/services/sample/mcmc_writer.hpp>
 #include <stan/services/sample/generate_transitions.hpp>
 #include <string>
+#include <vector>
 
 namespace stan {
   namespace services {
@@ -45,6 +47,89 @@ namespace stan {
            callback, info_writer, error_writer);
       }
 
+      /**
+       * Runs the sampling iterations of several chains that share one model.
+       * See the multi-chain overload of
+       * <code>stan::services::sample::generate_transitions</code>.
+       */
+      template <class Model, class RNG, class StartTransitionCallback,
+                class SampleRecorder, class DiagnosticRecorder,
+                class MessageRecorder>
+      void sample(std::vector<stan::mcmc::base_mcmc*>& samplers,
+                  int num_warmup,
+                  int num_samples,
+                  int num_thin,
+                  int refresh,
+                  bool save,
+                  std::vector<stan::services::sample::mcmc_writer<
+                  Model, SampleRecorder, DiagnosticRecorder, MessageRecorder>*>&
+                  mcmc_writers,
+                  std::vector<stan::mcmc::sample>& init_s,
+                  Model& model,
+                  std::vector<RNG*>& base_rngs,
+                  const std::string& prefix,
+                  const std::string& suffix,
+                  std::ostream& o,
+                  StartTransitionCallback& callback,
+                  interface_callbacks::writer::base_writer& info_writer,
+                  interface_callbacks::writer::base_writer& error_writer) {
+        stan::services::sample::generate_transitions<Model, RNG,
+                                                     StartTransitionCallback,
+                                                     SampleRecorder,
+                                                     DiagnosticRecorder,
+                                                     MessageRecorder>
+          (samplers, num_samples, num_warmup, num_warmup + num_samples, num_thin,
+           refresh, save, false,
+           mcmc_writers,
+           init_s, model, base_rngs,
+           prefix, suffix, o,
+           callback, info_writer, error_writer);
+      }
+
+      /**
+       * Runs the sampling iterations of several chains that share one
+       * model until the monitor reports convergence or
+       * <code>num_samples</code> iterations have run.  See
+       * <code>stan::services::sample::generate_transitions_until_converged</code>.
+       *
+       * @return number of sampling iterations run
+       */
+      template <class Model, class RNG, class StartTransitionCallback,
+                class SampleRecorder, class DiagnosticRecorder,
+                class MessageRecorder>
+      int sample_until_converged(std::vector<stan::mcmc::base_mcmc*>& samplers,
+                                 int num_warmup,
+                                 int num_samples,
+                                 int num_thin,
+                                 int refresh,
+                                 bool save,
+                                 int check_every,
+                                 stan::mcmc::convergence_monitor& monitor,
+                                 std::vector<stan::services::sample::mcmc_writer<
+                                 Model, SampleRecorder, DiagnosticRecorder,
+                                 MessageRecorder>*>& mcmc_writers,
+                                 std::vector<stan::mcmc::sample>& init_s,
+                                 Model& model,
+                                 std::vector<RNG*>& base_rngs,
+                                 const std::string& prefix,
+                                 const std::string& suffix,
+                                 std::ostream& o,
+                                 StartTransitionCallback& callback,
+                                 interface_callbacks::writer::base_writer&
+                                 info_writer,
+                                 interface_callbacks::writer::base_writer&
+                                 error_writer) {
+        return stan::services::sample::generate_transitions_until_converged
+          <Model, RNG, StartTransitionCallback, SampleRecorder,
+           DiagnosticRecorder, MessageRecorder>
+          (samplers, num_samples, num_warmup, num_warmup + num_samples,
+           num_thin, refresh, save, check_every, monitor,
+           mcmc_writers,
+           init_s, model, base_rngs,
+           prefix, suffix, o,
+           callback, info_writer, error_writer);
+      }
+
     }
   }
 }
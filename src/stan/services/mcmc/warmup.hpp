@@ -1,19 +1,99 @@
 #ifndef STAN_SERVICES_MCMC_WARMUP_HPP
 #define STAN_SERVICES_MCMC_WARMUP_HPP
 
+#include <stan/mcmc/base_adapter.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
 #include <stan/services/sample/mcmc_writer.hpp>
 #include <stan/services/sample/generate_transitions.hpp>
+#include <stan/services/sample/progress.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace stan {
   namespace services {
     namespace mcmc {
 
+      /**
+       * Runs warmup iterations until the sampler's adaptive schedule
+       * completes or <code>max_num_warmup</code> iterations have run,
+       * whichever comes first.  Samplers without an adaptive schedule
+       * run all <code>max_num_warmup</code> iterations.
+       *
+       * @return number of warmup iterations run
+       */
       template <class Model, class RNG, class StartTransitionCallback,
                 class SampleRecorder, class DiagnosticRecorder,
                 class MessageRecorder>
-      void warmup(stan::mcmc::base_mcmc* sampler,
+      int adaptive_warmup(stan::mcmc::base_mcmc* sampler,
+                          int max_num_warmup,
+                          int num_samples,
+                          int num_thin,
+                          int refresh,
+                          bool save,
+                          stan::services::sample::mcmc_writer<
+                          Model, SampleRecorder, DiagnosticRecorder,
+                          MessageRecorder>& mcmc_writer,
+                          stan::mcmc::sample& init_s,
+                          Model& model,
+                          RNG& base_rng,
+                          const std::string& prefix,
+                          const std::string& suffix,
+                          std::ostream& o,
+                          StartTransitionCallback& callback,
+                          interface_callbacks::writer::base_writer&
+                          info_writer,
+                          interface_callbacks::writer::base_writer&
+                          error_writer) {
+        stan::mcmc::base_adapter* adapter
+          = dynamic_cast<stan::mcmc::base_adapter*>(sampler);
+
+        int m = 0;
+        try {
+          while (m < max_num_warmup) {
+            callback();
+
+            sample::progress(m, 0, max_num_warmup + num_samples, refresh,
+                             true, prefix, suffix, o);
+
+            init_s = sampler->transition(init_s, info_writer, error_writer);
+
+            if ( save && ( (m % num_thin) == 0) ) {
+              mcmc_writer.write_sample_params(base_rng, init_s, *sampler,
+                                              model);
+              mcmc_writer.write_diagnostic_params(init_s, sampler);
+            }
+
+            ++m;
+            if (adapter && adapter->adaptation_complete())
+              break;
+          }
+        } catch (...) {
+          mcmc_writer.flush();
+          throw;
+        }
+        mcmc_writer.flush();
+        return m;
+      }
+
+      /**
+       * Runs the warmup iterations of a sampler.
+       *
+       * A sampler that is adapting with an adaptive schedule decides
+       * the length of warmup itself: it runs until the schedule
+       * completes, which may be before or after num_warmup
+       * iterations, as in adaptive_warmup.  Callers pass the returned
+       * count on to sampling and record it as the number of warmup
+       * iterations.
+       *
+       * @return number of warmup iterations run
+       */
+      template <class Model, class RNG, class StartTransitionCallback,
+                class SampleRecorder, class DiagnosticRecorder,
+                class MessageRecorder>
+      int warmup(stan::mcmc::base_mcmc* sampler,
                   int num_warmup,
                   int num_samples,
                   int num_thin,
@@ -31,6 +111,16 @@ namespace stan {
                   StartTransitionCallback& callback,
                   interface_callbacks::writer::base_writer& info_writer,
                   interface_callbacks::writer::base_writer& error_writer) {
+        stan::mcmc::base_adapter* adapter
+          = dynamic_cast<stan::mcmc::base_adapter*>(sampler);
+        if (adapter && adapter->adapting() && adapter->max_num_warmup() > 0) {
+          return adaptive_warmup(sampler, adapter->max_num_warmup(),
+                                 num_samples, num_thin, refresh, save,
+                                 mcmc_writer, init_s, model, base_rng,
+                                 prefix, suffix, o, callback,
+                                 info_writer, error_writer);
+        }
+
         sample::generate_transitions<Model, RNG, StartTransitionCallback,
                                      SampleRecorder, DiagnosticRecorder,
                                      MessageRecorder>
@@ -40,6 +130,125 @@ namespace stan {
            init_s, model, base_rng,
            prefix, suffix, o,
            callback, info_writer, error_writer);
+        return num_warmup;
+      }
+
+      /**
+       * Runs the warmup iterations of several chains that share one model.
+       * See the multi-chain overload of
+       * <code>stan::services::sample::generate_transitions</code>.
+       *
+       * Chains that are adapting with an adaptive schedule each run
+       * until their own schedule completes, so chains may end warmup
+       * after different numbers of iterations.  Chains that share an
+       * adaptation pool must close their windows together and should
+       * not use an adaptive schedule.
+       *
+       * @return number of warmup iterations run by each chain
+       */
+      template <class Model, class RNG, class StartTransitionCallback,
+                class SampleRecorder, class DiagnosticRecorder,
+                class MessageRecorder>
+      std::vector<int>
+      warmup(std::vector<stan::mcmc::base_mcmc*>& samplers,
+                  int num_warmup,
+                  int num_samples,
+                  int num_thin,
+                  int refresh,
+                  bool save,
+                  std::vector<stan::services::sample::mcmc_writer<
+                  Model, SampleRecorder, DiagnosticRecorder, MessageRecorder>*>&
+                  mcmc_writers,
+                  std::vector<stan::mcmc::sample>& init_s,
+                  Model& model,
+                  std::vector<RNG*>& base_rngs,
+                  const std::string& prefix,
+                  const std::string& suffix,
+                  std::ostream& o,
+                  StartTransitionCallback& callback,
+                  interface_callbacks::writer::base_writer& info_writer,
+                  interface_callbacks::writer::base_writer& error_writer) {
+        const size_t num_chains = samplers.size();
+        std::vector<stan::mcmc::base_adapter*> adapters(num_chains, 0);
+        int max_num_warmup = num_warmup;
+        for (size_t k = 0; k < num_chains; ++k) {
+          stan::mcmc::base_adapter* adapter
+            = dynamic_cast<stan::mcmc::base_adapter*>(samplers[k]);
+          if (adapter && adapter->adapting()
+              && adapter->max_num_warmup() > 0) {
+            adapters[k] = adapter;
+            max_num_warmup
+              = std::max(max_num_warmup,
+                         static_cast<int>(adapter->max_num_warmup()));
+          }
+        }
+
+        if (std::count(adapters.begin(), adapters.end(),
+                       static_cast<stan::mcmc::base_adapter*>(0))
+            < static_cast<std::ptrdiff_t>(num_chains)) {
+          if (mcmc_writers.size() != num_chains
+              || init_s.size() != num_chains
+              || base_rngs.size() != num_chains)
+            throw std::invalid_argument("warmup: the number of writers, "
+                                        "samples and random number "
+                                        "generators must match the number "
+                                        "of samplers");
+
+          std::vector<bool> running(num_chains, true);
+          std::vector<int> num_run(num_chains, 0);
+          size_t num_running = num_chains;
+          try {
+            for (int m = 0; num_running > 0 && m < max_num_warmup; ++m) {
+              callback();
+
+              sample::progress(m, 0, max_num_warmup + num_samples, refresh,
+                               true, prefix, suffix, o);
+
+              for (size_t k = 0; k < num_chains; ++k) {
+                if (!running[k])
+                  continue;
+
+                init_s[k] = samplers[k]->transition(init_s[k], info_writer,
+                                                    error_writer);
+                ++num_run[k];
+
+                if ( save && ( (m % num_thin) == 0) ) {
+                  mcmc_writers[k]->write_sample_params(*base_rngs[k],
+                                                       init_s[k],
+                                                       *samplers[k], model);
+                  mcmc_writers[k]->write_diagnostic_params(init_s[k],
+                                                           samplers[k]);
+                }
+
+                if (adapters[k] ? adapters[k]->adaptation_complete()
+                                : m + 1 >= num_warmup) {
+                  running[k] = false;
+                  --num_running;
+                }
+              }
+            }
+          } catch (...) {
+            for (size_t k = 0; k < num_chains; ++k)
+              mcmc_writers[k]->flush();
+            throw;
+          }
+          for (size_t k = 0; k < num_chains; ++k)
+            mcmc_writers[k]->flush();
+          return num_run;
+        }
+
+        stan::services::sample::generate_transitions<Model, RNG,
+                                                     StartTransitionCallback,
+                                                     SampleRecorder,
+                                                     DiagnosticRecorder,
+                                                     MessageRecorder>
+          (samplers, num_warmup, 0, num_warmup + num_samples, num_thin,
+           refresh, save, true,
+           mcmc_writers,
+           init_s, model, base_rngs,
+           prefix, suffix, o,
+           callback, info_writer, error_writer);
+        return std::vector<int>(num_chains, num_warmup);
       }
 
     }
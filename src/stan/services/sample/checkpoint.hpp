@@ -0,0 +1,106 @@
+#ifndef STAN_SERVICES_SAMPLE_CHECKPOINT_HPP
+#define STAN_SERVICES_SAMPLE_CHECKPOINT_HPP
+
+#include <stan/io/checkpoint.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/mcmc/base_adapter.hpp>
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/sample.hpp>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace stan {
+  namespace services {
+    namespace sample {
+
+      /**
+       * Writes a binary checkpoint of a chain between two iterations.
+       *
+       * The checkpoint holds the state of the sampler, the state of
+       * its adaptation if it adapts, the sample the next transition
+       * starts from, and the state of the random number generator.
+       * Restoring it with read_checkpoint and continuing the run
+       * reproduces the output of an uninterrupted run exactly.  The
+       * caller is responsible for recording how many iterations have
+       * been completed.
+       *
+       * @tparam RNG Random number generator class
+       * @param[out] o binary output stream
+       * @param[in] sampler sampler
+       * @param[in] s sample the next transition starts from
+       * @param[in] base_rng random number generator
+       */
+      template <class RNG>
+      void write_checkpoint(std::ostream& o,
+                            stan::mcmc::base_mcmc& sampler,
+                            const stan::mcmc::sample& s,
+                            RNG& base_rng) {
+        stan::io::checkpoint_writer checkpoint(o);
+
+        sampler.save_state(checkpoint);
+
+        stan::mcmc::base_adapter* adapter
+          = dynamic_cast<stan::mcmc::base_adapter*>(&sampler);
+        checkpoint.write(adapter != 0);
+        if (adapter)
+          adapter->save_adaptation_state(checkpoint);
+
+        checkpoint.begin_section("sample");
+        checkpoint.write(s.cont_params());
+        checkpoint.write(s.log_prob());
+        checkpoint.write(s.accept_stat());
+
+        checkpoint.write_rng(base_rng);
+      }
+
+      /**
+       * Restores a chain from a checkpoint written by
+       * write_checkpoint.  The sampler must be of the same type and
+       * built for the same model as the one that was saved.
+       *
+       * @tparam RNG Random number generator class
+       * @param[in] i binary input stream
+       * @param[in,out] sampler sampler
+       * @param[in,out] s sample of the model's dimension; set to the
+       * sample the next transition starts from
+       * @param[out] base_rng random number generator
+       * @throw std::runtime_error if the checkpoint is malformed or
+       * was written by a different kind of sampler or model
+       */
+      template <class RNG>
+      void read_checkpoint(std::istream& i,
+                           stan::mcmc::base_mcmc& sampler,
+                           stan::mcmc::sample& s,
+                           RNG& base_rng) {
+        stan::io::checkpoint_reader checkpoint(i);
+
+        sampler.load_state(checkpoint);
+
+        stan::mcmc::base_adapter* adapter
+          = dynamic_cast<stan::mcmc::base_adapter*>(&sampler);
+        bool saved_adapter;
+        checkpoint.read(saved_adapter);
+        if (saved_adapter != (adapter != 0))
+          throw std::runtime_error("Checkpoint adaptation state does not "
+                                   "match the sampler");
+        if (adapter)
+          adapter->load_adaptation_state(checkpoint);
+
+        checkpoint.begin_section("sample");
+        Eigen::VectorXd q(s.cont_params().size());
+        double log_prob;
+        double accept_stat;
+        checkpoint.read(q);
+        checkpoint.read(log_prob);
+        checkpoint.read(accept_stat);
+        s = stan::mcmc::sample(q, log_prob, accept_stat);
+
+        checkpoint.read_rng(base_rng);
+      }
+
+    }
+  }
+}
+
+#endif
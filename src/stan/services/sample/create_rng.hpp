@@ -0,0 +1,52 @@
+#ifndef STAN_SERVICES_SAMPLE_CREATE_RNG_HPP
+#define STAN_SERVICES_SAMPLE_CREATE_RNG_HPP
+
+#include <boost/cstdint.hpp>
+
+namespace stan {
+  namespace services {
+    namespace sample {
+
+      /**
+       * Seeds the specified random number generator for a chain.
+       *
+       * Every chain starts from the same seed and then skips ahead
+       * by a fixed stride proportional to its identifier, so the
+       * streams of different chains never overlap and each one is
+       * reproducible from the seed and chain identifier alone.
+       *
+       * @tparam RNG Random number generator class
+       * @param[out] rng random number generator to seed
+       * @param[in] seed seed shared by all chains
+       * @param[in] chain_id identifier of the chain
+       */
+      template <class RNG>
+      void seed_chain_rng(RNG& rng,
+                          const unsigned int seed,
+                          const unsigned int chain_id) {
+        static const boost::uintmax_t DISCARD_STRIDE
+          = static_cast<boost::uintmax_t>(1) << 50;
+        rng.seed(seed);
+        rng.discard(DISCARD_STRIDE * chain_id);
+      }
+
+      /**
+       * Returns a random number generator seeded for a chain.
+       *
+       * @tparam RNG Random number generator class
+       * @param[in] seed seed shared by all chains
+       * @param[in] chain_id identifier of the chain
+       * @return seeded random number generator
+       */
+      template <class RNG>
+      RNG create_rng(const unsigned int seed, const unsigned int chain_id) {
+        RNG rng;
+        seed_chain_rng(rng, seed, chain_id);
+        return rng;
+      }
+
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef STAN_SERVICES_SAMPLE_FORK_CHAINS_HPP
+#define STAN_SERVICES_SAMPLE_FORK_CHAINS_HPP
+
+#include <stan/io/checkpoint.hpp>
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/sample.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace services {
+    namespace sample {
+
+      /**
+       * Starts several sampling chains from a single warmed up
+       * sampler, so that warmup runs once instead of once per chain.
+       *
+       * Every chain receives a copy of the state of the warmed up
+       * sampler: its nominal step size, stepsize jitter and
+       * integration settings, its metric and its final phase space
+       * point, including the potential and gradient there.  The
+       * chains keep their own random number generators, which should
+       * be seeded independently, for example with seed_chain_rng, and
+       * then run with the multi-chain overload of
+       * stan::services::mcmc::sample.
+       *
+       * The chain samplers must share the Hamiltonian and integration
+       * scheme of the warmed up sampler but need not adapt; the
+       * warmed up sampler is typically an adapt_* sampler whose
+       * adaptation has been disengaged and the chains are the
+       * corresponding non-adapting samplers.
+       *
+       * @param[in] warmed sampler at the end of warmup
+       * @param[in] s sample warmup finished at
+       * @param[in,out] chains samplers of the sampling chains
+       * @param[out] init_s one sample per chain to start sampling from
+       * @throw std::runtime_error if a chain sampler does not match the
+       * kind or dimension of the warmed up sampler
+       */
+      inline void fork_chains(stan::mcmc::base_mcmc& warmed,
+                              const stan::mcmc::sample& s,
+                              std::vector<stan::mcmc::base_mcmc*>& chains,
+                              std::vector<stan::mcmc::sample>& init_s) {
+        std::stringstream state;
+        {
+          stan::io::checkpoint_writer checkpoint(state);
+          warmed.save_state(checkpoint);
+        }
+        const std::string saved = state.str();
+
+        init_s.clear();
+        for (size_t n = 0; n < chains.size(); ++n) {
+          std::stringstream chain_state(saved);
+          stan::io::checkpoint_reader checkpoint(chain_state);
+          chains[n]->load_state(checkpoint);
+          init_s.push_back(s);
+        }
+      }
+
+    }
+  }
+}
+
+#endif
@@ -3,9 +3,13 @@
 
 #include <stan/interface_callbacks/writer/base_writer.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/convergence_monitor.hpp>
 #include <stan/services/sample/mcmc_writer.hpp>
 #include <stan/services/sample/progress.hpp>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace stan {
   namespace services {
@@ -37,18 +41,240 @@ namespace stan {
                                 info_writer,
                                 interface_callbacks::writer::base_writer&
                                 error_writer) {
-        for (int m = 0; m < num_iterations; ++m) {
-          callback();
+        try {
+          for (int m = 0; m < num_iterations; ++m) {
+            callback();
 
-          progress(m, start, finish, refresh, warmup, prefix, suffix, o);
+            progress(m, start, finish, refresh, warmup, prefix, suffix, o);
 
-          init_s = sampler->transition(init_s, info_writer, error_writer);
+            init_s = sampler->transition(init_s, info_writer, error_writer);
 
-          if ( save && ( (m % num_thin) == 0) ) {
-            mcmc_writer.write_sample_params(base_rng, init_s, *sampler, model);
-            mcmc_writer.write_diagnostic_params(init_s, sampler);
+            if ( save && ( (m % num_thin) == 0) ) {
+              mcmc_writer.write_sample_params(base_rng, init_s, *sampler,
+                                              model);
+              mcmc_writer.write_diagnostic_params(init_s, sampler);
+            }
           }
+        } catch (...) {
+          mcmc_writer.flush();
+          throw;
         }
+        mcmc_writer.flush();
+      }
+
+      /**
+       * Generates transitions for several chains that share one
+       * model.
+       *
+       * The chains are advanced in lockstep on the calling thread: each
+       * iteration runs one transition of every chain in order before
+       * moving on.  The model is constructed once by the caller and only
+       * used through const methods, so no chain repeats the data reads or
+       * the model construction.  Each chain owns its sampler, its random
+       * number generator and its writer, so the draws of a chain do not
+       * depend on how many other chains run alongside it.  The writers
+       * are flushed once the iterations are done, also when an
+       * iteration throws.
+       *
+       * @param samplers one sampler per chain
+       * @param num_iterations number of iterations per chain
+       * @param start iteration count before this call, used for progress
+       * @param finish total number of iterations, used for progress
+       * @param num_thin period of saved iterations
+       * @param refresh period of progress messages
+       * @param save true if the draws are written
+       * @param warmup true if the iterations are warmup iterations
+       * @param mcmc_writers one writer per chain
+       * @param init_s one current sample per chain, updated in place
+       * @param model the model shared by all chains
+       * @param base_rngs one random number generator per chain, used by
+       *   the model's generated quantities
+       * @param prefix string written before progress messages
+       * @param suffix string written after progress messages
+       * @param o stream for progress messages
+       * @param callback called once per iteration
+       * @param info_writer writer for informational messages
+       * @param error_writer writer for error messages
+       */
+      template <class Model, class RNG, class StartTransitionCallback,
+                class SampleRecorder, class DiagnosticRecorder,
+                class MessageRecorder>
+      void generate_transitions(std::vector<stan::mcmc::base_mcmc*>& samplers,
+                                const int num_iterations,
+                                const int start,
+                                const int finish,
+                                const int num_thin,
+                                const int refresh,
+                                const bool save,
+                                const bool warmup,
+                                std::vector<stan::services::sample::mcmc_writer<
+                                Model, SampleRecorder,
+                                DiagnosticRecorder, MessageRecorder>*>&
+                                mcmc_writers,
+                                std::vector<stan::mcmc::sample>& init_s,
+                                Model& model,
+                                std::vector<RNG*>& base_rngs,
+                                const std::string& prefix,
+                                const std::string& suffix,
+                                std::ostream& o,
+                                StartTransitionCallback& callback,
+                                interface_callbacks::writer::base_writer&
+                                info_writer,
+                                interface_callbacks::writer::base_writer&
+                                error_writer) {
+        const size_t num_chains = samplers.size();
+        if (mcmc_writers.size() != num_chains
+            || init_s.size() != num_chains
+            || base_rngs.size() != num_chains)
+          throw std::invalid_argument("generate_transitions: the number of "
+                                      "writers, samples and random number "
+                                      "generators must match the number of "
+                                      "samplers");
+
+        try {
+          for (int m = 0; m < num_iterations; ++m) {
+            callback();
+
+            progress(m, start, finish, refresh, warmup, prefix, suffix, o);
+
+            for (size_t k = 0; k < num_chains; ++k) {
+              init_s[k] = samplers[k]->transition(init_s[k],
+                                                  info_writer, error_writer);
+
+              if ( save && ( (m % num_thin) == 0) ) {
+                mcmc_writers[k]->write_sample_params(*base_rngs[k],
+                                                     init_s[k],
+                                                     *samplers[k], model);
+                mcmc_writers[k]->write_diagnostic_params(init_s[k],
+                                                         samplers[k]);
+              }
+            }
+          }
+        } catch (...) {
+          for (size_t k = 0; k < num_chains; ++k)
+            mcmc_writers[k]->flush();
+          throw;
+        }
+        for (size_t k = 0; k < num_chains; ++k)
+          mcmc_writers[k]->flush();
+      }
+
+      /**
+       * Generates sampling transitions for several chains that share
+       * one model, like the multi-chain generate_transitions, and stops
+       * early once the draws have converged.
+       *
+       * Every chain's draw is recorded in the monitor after each
+       * iteration.  Every <code>check_every</code> iterations the
+       * monitor's diagnostics are recomputed across chains; when every
+       * parameter meets the targets the remaining iterations are
+       * skipped.  All chains stop after the same iteration, so their
+       * output stays aligned.
+       *
+       * @param samplers one sampler per chain
+       * @param num_iterations largest number of iterations per chain
+       * @param start iteration count before this call, used for progress
+       * @param finish total number of iterations, used for progress
+       * @param num_thin period of saved iterations
+       * @param refresh period of progress messages
+       * @param save true if the draws are written
+       * @param check_every period of convergence checks
+       * @param monitor convergence monitor with one set of batches
+       *   per chain
+       * @param mcmc_writers one writer per chain
+       * @param init_s one current sample per chain, updated in place
+       * @param model the model shared by all chains
+       * @param base_rngs one random number generator per chain, used by
+       *   the model's generated quantities
+       * @param prefix string written before progress messages
+       * @param suffix string written after progress messages
+       * @param o stream for progress messages
+       * @param callback called once per iteration
+       * @param info_writer writer for informational messages
+       * @param error_writer writer for error messages
+       * @return number of iterations run
+       * @throw std::invalid_argument if the numbers of chains do not
+       *   match or if check_every is not positive
+       */
+      template <class Model, class RNG, class StartTransitionCallback,
+                class SampleRecorder, class DiagnosticRecorder,
+                class MessageRecorder>
+      int generate_transitions_until_converged(
+        std::vector<stan::mcmc::base_mcmc*>& samplers,
+        const int num_iterations,
+        const int start,
+        const int finish,
+        const int num_thin,
+        const int refresh,
+        const bool save,
+        const int check_every,
+        stan::mcmc::convergence_monitor& monitor,
+        std::vector<stan::services::sample::mcmc_writer<
+        Model, SampleRecorder, DiagnosticRecorder, MessageRecorder>*>&
+        mcmc_writers,
+        std::vector<stan::mcmc::sample>& init_s,
+        Model& model,
+        std::vector<RNG*>& base_rngs,
+        const std::string& prefix,
+        const std::string& suffix,
+        std::ostream& o,
+        StartTransitionCallback& callback,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        const size_t num_chains = samplers.size();
+        if (mcmc_writers.size() != num_chains
+            || init_s.size() != num_chains
+            || base_rngs.size() != num_chains
+            || static_cast<size_t>(monitor.num_chains()) != num_chains)
+          throw std::invalid_argument("generate_transitions_until_converged: "
+                                      "the number of writers, samples, "
+                                      "random number generators and "
+                                      "monitored chains must match the "
+                                      "number of samplers");
+        if (check_every < 1)
+          throw std::invalid_argument("generate_transitions_until_converged: "
+                                      "check_every must be positive");
+
+        int m = 0;
+        try {
+          for (; m < num_iterations; ++m) {
+            callback();
+
+            progress(m, start, finish, refresh, false, prefix, suffix, o);
+
+            for (size_t k = 0; k < num_chains; ++k) {
+              init_s[k] = samplers[k]->transition(init_s[k],
+                                                  info_writer, error_writer);
+              monitor.add(k, init_s[k].cont_params());
+
+              if ( save && ( (m % num_thin) == 0) ) {
+                mcmc_writers[k]->write_sample_params(*base_rngs[k],
+                                                     init_s[k],
+                                                     *samplers[k], model);
+                mcmc_writers[k]->write_diagnostic_params(init_s[k],
+                                                         samplers[k]);
+              }
+            }
+
+            if ((m + 1) % check_every == 0 && m + 1 < num_iterations
+                && monitor.converged()) {
+              std::stringstream msg;
+              msg << "Converged after " << m + 1 << " iterations: "
+                  << "minimum ESS = " << monitor.min_ess()
+                  << ", maximum split R hat = " << monitor.max_rhat();
+              info_writer(msg.str());
+              ++m;
+              break;
+            }
+          }
+        } catch (...) {
+          for (size_t k = 0; k < num_chains; ++k)
+            mcmc_writers[k]->flush();
+          throw;
+        }
+        for (size_t k = 0; k < num_chains; ++k)
+          mcmc_writers[k]->flush();
+        return m;
       }
 
     }
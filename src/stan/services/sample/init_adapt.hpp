@@ -12,6 +12,15 @@ namespace stan {
   namespace services {
     namespace sample {
 
+      /**
+       * Configures step size adaptation and engages adaptation.
+       *
+       * The step size is tuned with the heuristic in init_stepsize
+       * unless tune_stepsize is false, which keeps a step size that
+       * was loaded from a previous run.
+       *
+       * @return false if the step size could not be initialized
+       */
       template<class Sampler>
       bool init_adapt(Sampler* sampler,
                       const double delta,
@@ -20,7 +29,8 @@ namespace stan {
                       const double t0,
                       const Eigen::VectorXd& cont_params,
                       interface_callbacks::writer::base_writer& info_writer,
-                      interface_callbacks::writer::base_writer& error_writer) {
+                      interface_callbacks::writer::base_writer& error_writer,
+                      const bool tune_stepsize = true) {
         const double epsilon = sampler->get_nominal_stepsize();
 
         sampler->get_stepsize_adaptation().set_mu(log(10 * epsilon));
@@ -33,7 +43,8 @@ namespace stan {
 
         try {
           sampler->z().q = cont_params;
-          sampler->init_stepsize(info_writer, error_writer);
+          if (tune_stepsize)
+            sampler->init_stepsize(info_writer, error_writer);
         } catch (const std::exception& e) {
           error_writer("Exception initializing step size.");
           error_writer(e.what());
@@ -47,7 +58,8 @@ namespace stan {
                       categorical_argument* adapt,
                       const Eigen::VectorXd& cont_params,
                       interface_callbacks::writer::base_writer& info_writer,
-                      interface_callbacks::writer::base_writer& error_writer) {
+                      interface_callbacks::writer::base_writer& error_writer,
+                      const bool tune_stepsize = true) {
         double delta
           = dynamic_cast<real_argument*>(adapt->arg("delta"))->value();
         double gamma
@@ -59,7 +71,8 @@ namespace stan {
 
         return init_adapt<Sampler>(dynamic_cast<Sampler*>(sampler),
                                    delta, gamma, kappa, t0, cont_params,
-                                   info_writer, error_writer);
+                                   info_writer, error_writer,
+                                   tune_stepsize);
       }
 
     }
@@ -0,0 +1,38 @@
+#ifndef STAN_SERVICES_SAMPLE_INIT_RWM_HPP
+#define STAN_SERVICES_SAMPLE_INIT_RWM_HPP
+
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/services/arguments/argument.hpp>
+#include <stan/services/arguments/categorical_argument.hpp>
+#include <stan/services/arguments/singleton_argument.hpp>
+
+namespace stan {
+  namespace services {
+    namespace sample {
+
+      template<class Sampler>
+      bool init_rwm(stan::mcmc::base_mcmc* sampler,
+                    stan::services::argument* algorithm) {
+        stan::services::categorical_argument* rwm
+          = dynamic_cast<stan::services::categorical_argument*>
+          (algorithm->arg("rwm"));
+
+        double epsilon
+          = dynamic_cast<stan::services::real_argument*>(rwm->arg("stepsize"))
+          ->value();
+        double epsilon_jitter
+          = dynamic_cast<stan::services::real_argument*>(
+                                                 rwm->arg("stepsize_jitter"))
+          ->value();
+
+        dynamic_cast<Sampler*>(sampler)->set_nominal_stepsize(epsilon);
+        dynamic_cast<Sampler*>(sampler)->set_stepsize_jitter(epsilon_jitter);
+
+        return true;
+      }
+
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,231 @@
+#ifndef STAN_SERVICES_SAMPLE_INIT_WARM_START_HPP
+#define STAN_SERVICES_SAMPLE_INIT_WARM_START_HPP
+
+#include <stan/interface_callbacks/writer/base_writer.hpp>
+#include <stan/io/checkpoint.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/hmc/hamiltonians/dense_e_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/diag_e_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace stan {
+  namespace services {
+    namespace sample {
+
+      /**
+       * Copies the inverse metric of a point without an adaptable
+       * metric, which is empty.
+       *
+       * @param[in] z point
+       * @param[out] metric empty matrix
+       */
+      inline void get_inv_metric(stan::mcmc::ps_point& z,
+                                 Eigen::MatrixXd& metric) {
+        metric.resize(0, 0);
+      }
+
+      /**
+       * Copies the diagonal inverse metric of a point as a single
+       * row, the layout of the adaptation block of a Stan CSV file.
+       *
+       * @param[in] z point
+       * @param[out] metric 1 x N matrix
+       */
+      inline void get_inv_metric(stan::mcmc::diag_e_point& z,
+                                 Eigen::MatrixXd& metric) {
+        metric = z.mInv.transpose();
+      }
+
+      /**
+       * Copies the dense inverse metric of a point.
+       *
+       * @param[in] z point
+       * @param[out] metric N x N matrix
+       */
+      inline void get_inv_metric(stan::mcmc::dense_e_point& z,
+                                 Eigen::MatrixXd& metric) {
+        metric = z.mInv();
+      }
+
+      /**
+       * Rejects a metric for a point without an adaptable metric
+       * unless the metric is empty.
+       *
+       * @param[in,out] z point
+       * @param[in] metric inverse metric
+       * @throw std::invalid_argument if the metric is not empty
+       */
+      inline void set_inv_metric(stan::mcmc::ps_point& z,
+                                 const Eigen::MatrixXd& metric) {
+        if (metric.size() != 0)
+          throw std::invalid_argument("The sampler has no adaptable metric "
+                                      "to initialize");
+      }
+
+      /**
+       * Sets the diagonal inverse metric of a point from either a
+       * single row or column, or from the diagonal of a square
+       * matrix.
+       *
+       * @param[in,out] z point
+       * @param[in] metric inverse metric
+       * @throw std::invalid_argument if the metric does not match the
+       * dimension of the point or is not positive
+       */
+      inline void set_inv_metric(stan::mcmc::diag_e_point& z,
+                                 const Eigen::MatrixXd& metric) {
+        int n = z.mInv.size();
+        Eigen::VectorXd mInv(n);
+        if (metric.rows() == 1 && metric.cols() == n)
+          mInv = metric.row(0).transpose();
+        else if (metric.rows() == n && metric.cols() == 1)
+          mInv = metric.col(0);
+        else if (metric.rows() == n && metric.cols() == n)
+          mInv = metric.diagonal();
+        else
+          throw std::invalid_argument("The metric does not match the "
+                                      "number of parameters");
+
+        for (int i = 0; i < n; ++i)
+          if (!(mInv(i) > 0))
+            throw std::invalid_argument("The diagonal metric must be "
+                                        "positive");
+        z.mInv = mInv;
+      }
+
+      /**
+       * Sets the dense inverse metric of a point from a square
+       * matrix, or from a single row holding its diagonal.
+       *
+       * @param[in,out] z point
+       * @param[in] metric inverse metric
+       * @throw std::invalid_argument if the metric does not match the
+       * dimension of the point or is not symmetric positive definite
+       */
+      inline void set_inv_metric(stan::mcmc::dense_e_point& z,
+                                 const Eigen::MatrixXd& metric) {
+        int n = z.mInv().rows();
+        Eigen::MatrixXd mInv(n, n);
+        if (metric.rows() == n && metric.cols() == n)
+          mInv = metric;
+        else if (metric.rows() == 1 && metric.cols() == n)
+          mInv = metric.row(0).asDiagonal();
+        else
+          throw std::invalid_argument("The metric does not match the "
+                                      "number of parameters");
+
+        if (!mInv.isApprox(mInv.transpose())
+            || mInv.llt().info() != Eigen::Success)
+          throw std::invalid_argument("The dense metric must be symmetric "
+                                      "positive definite");
+        z.set_mInv(mInv);
+      }
+
+      /**
+       * Copies the nominal step size and inverse metric of a sampler,
+       * typically at the end of warmup, into an adaptation block.
+       *
+       * @tparam Sampler HMC sampler class
+       * @param[in] sampler sampler
+       * @param[out] adaptation step size and inverse metric
+       */
+      template <class Sampler>
+      void get_adaptation(stan::mcmc::base_mcmc* sampler,
+                          stan::io::stan_csv_adaptation& adaptation) {
+        Sampler* s = dynamic_cast<Sampler*>(sampler);
+        adaptation.step_size = s->get_nominal_stepsize();
+        get_inv_metric(s->z(), adaptation.metric);
+      }
+
+      /**
+       * Writes an adaptation block to a binary stream.
+       *
+       * @param[out] o binary output stream
+       * @param[in] adaptation step size and inverse metric
+       */
+      inline void
+      write_adaptation(std::ostream& o,
+                       const stan::io::stan_csv_adaptation& adaptation) {
+        stan::io::checkpoint_writer checkpoint(o);
+        checkpoint.begin_section("adaptation");
+        checkpoint.write(adaptation.step_size);
+        checkpoint.write(static_cast<int>(adaptation.metric.rows()));
+        checkpoint.write(static_cast<int>(adaptation.metric.cols()));
+        checkpoint.write(adaptation.metric);
+      }
+
+      /**
+       * Reads an adaptation block written by write_adaptation.
+       *
+       * @param[in] i binary input stream
+       * @param[out] adaptation step size and inverse metric
+       * @throw std::runtime_error if the stream does not hold an
+       * adaptation block
+       */
+      inline void
+      read_adaptation(std::istream& i,
+                      stan::io::stan_csv_adaptation& adaptation) {
+        stan::io::checkpoint_reader checkpoint(i);
+        checkpoint.begin_section("adaptation");
+        checkpoint.read(adaptation.step_size);
+        int rows;
+        int cols;
+        checkpoint.read(rows);
+        checkpoint.read(cols);
+        adaptation.metric.resize(rows, cols);
+        checkpoint.read(adaptation.metric);
+      }
+
+      /**
+       * Initializes the step size and inverse metric of a sampler
+       * from the adaptation of a previous run, read either from the
+       * adaptation block of a Stan CSV file or with read_adaptation.
+       *
+       * Combined with init_adapt or init_windowed_adapt called with
+       * tune_stepsize set to false, warmup continues from the loaded
+       * values, so it can be short or skipped entirely.
+       *
+       * @tparam Sampler HMC sampler class
+       * @param[in,out] sampler sampler
+       * @param[in] adaptation step size and inverse metric
+       * @param[out] error_writer writer for error messages
+       * @return true if the adaptation was loaded
+       */
+      template <class Sampler>
+      bool
+      init_warm_start(stan::mcmc::base_mcmc* sampler,
+                      const stan::io::stan_csv_adaptation& adaptation,
+                      interface_callbacks::writer::base_writer& error_writer) {
+        Sampler* s = dynamic_cast<Sampler*>(sampler);
+
+        if (!(adaptation.step_size > 0)) {
+          std::stringstream msg;
+          msg << "Warm start step size must be positive, found "
+              << adaptation.step_size;
+          error_writer(msg.str());
+          return false;
+        }
+
+        try {
+          set_inv_metric(s->z(), adaptation.metric);
+        } catch (const std::exception& e) {
+          error_writer("Exception initializing metric for warm start.");
+          error_writer(e.what());
+          return false;
+        }
+
+        s->set_nominal_stepsize(adaptation.step_size);
+        return true;
+      }
+
+    }
+  }
+}
+
+#endif
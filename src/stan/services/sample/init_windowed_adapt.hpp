@@ -19,9 +19,10 @@ namespace stan {
                           unsigned int num_warmup,
                           const Eigen::VectorXd& cont_params,
                           interface_callbacks::writer::base_writer& info_writer,
-                      interface_callbacks::writer::base_writer& error_writer) {
+                      interface_callbacks::writer::base_writer& error_writer,
+                          const bool tune_stepsize = true) {
         init_adapt<Sampler>(sampler, adapt, cont_params,
-                            info_writer, error_writer);
+                            info_writer, error_writer, tune_stepsize);
 
         unsigned int init_buffer
           = dynamic_cast<u_int_argument*>(adapt->arg("init_buffer"))->value();
@@ -34,6 +35,15 @@ namespace stan {
           ->set_window_params(num_warmup, init_buffer, term_buffer,
                               window, info_writer);
 
+        double tolerance
+          = dynamic_cast<real_argument*>(adapt->arg("tolerance"))->value();
+        unsigned int max_warmup
+          = dynamic_cast<u_int_argument*>(adapt->arg("max_warmup"))->value();
+        if (tolerance > 0)
+          dynamic_cast<Sampler*>(sampler)
+            ->set_adaptive_schedule(tolerance,
+                                    max_warmup > 0 ? max_warmup : num_warmup);
+
         return true;
       }
 
@@ -4,8 +4,10 @@
 #include <stan/mcmc/base_mcmc.hpp>
 #include <stan/mcmc/sample.hpp>
 #include <stan/model/prob_grad.hpp>
+#include <stan/services/sample/output_filter.hpp>
 #include <sstream>
 #include <iomanip>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -16,6 +18,15 @@ namespace stan {
       /**
        * mcmc_writer writes out headers and samples
        *
+       * Rows of sample and diagnostic values are collected in buffers
+       * that are reused from draw to draw and handed to the writers
+       * as blocks of up to block_rows rows.  The blocks are written
+       * when they are full, before anything else is written to the
+       * same writer, and by flush, which must be called once the last
+       * draw is written unless timing is written after it.  With the
+       * default of one row per block each row is written on its own,
+       * as a std::vector, exactly as before blocks were introduced.
+       *
        * @tparam Model Model class
        * @tparam SampleWriter Class for recording samples
        * @tparam DiagnosticWriter Class for diagnostic samples
@@ -29,6 +40,24 @@ namespace stan {
         DiagnosticWriter& diagnostic_writer_;
         MessageWriter& message_writer_;
 
+        // Rows not yet written, in row major order
+        struct block {
+          std::vector<double> values;
+          int rows;
+          int cols;
+
+          block() : rows(0), cols(0) { }
+        };
+
+        output_filter filter_;
+
+        int block_rows_;
+        block sample_block_;
+        block diagnostic_block_;
+
+        std::vector<double> values_;
+        Eigen::VectorXd model_values_;
+
       public:
         /**
          * Constructor.
@@ -36,24 +65,32 @@ namespace stan {
          * @param sample_writer samples are "written" to this stream (can abstract this?)
          * @param diagnostic_writer diagnostic information is "written" to this stream
          * @param message_writer messages are written to this stream
+         * @param block_rows largest number of rows handed to the sample
+         *   and diagnostic writers at once
          *
          * @pre arguments == 0 if and only if they are not meant to be used
          * @post none
          * @sideeffects streams are stored in this object
+         * @throw std::invalid_argument if block_rows is not positive
          */
         mcmc_writer(SampleWriter& sample_writer,
                     DiagnosticWriter& diagnostic_writer,
-                    MessageWriter& message_writer)
+                    MessageWriter& message_writer,
+                    int block_rows = 1)
           : sample_writer_(sample_writer),
             diagnostic_writer_(diagnostic_writer),
-            message_writer_(message_writer) {
+            message_writer_(message_writer),
+            block_rows_(block_rows) {
+          if (block_rows < 1)
+            throw std::invalid_argument("mcmc_writer: block_rows must be "
+                                        "positive");
         }
 
         /**
          * Outputs parameter string names. First outputs the names stored in
          * the sample object (stan::mcmc::sample), then uses the sampler provided
          * to output sampler specific names, then adds the model constrained
-         * parameter names.
+         * parameter names that pass the output filter.
          *
          * The names are written to the sample_stream as comma separated values
          * with a newline at the end.
@@ -74,12 +111,27 @@ namespace stan {
 
           sample.get_sample_param_names(names);
           sampler->get_sampler_param_names(names);
-          model.constrained_param_names(names, true, true);
 
+          std::vector<std::string> model_names;
+          model.constrained_param_names(model_names, true, true);
+          filter_.append(model_names, names);
+
+          write_block_(sample_writer_, sample_block_);
           sample_writer_(names);
         }
 
 
+        /**
+         * Sets the filter that selects which of the model's values
+         * are written with each draw, from the next names or draw
+         * written on.  By default every value is written.
+         *
+         * @param filter filter resolved against the model
+         */
+        void set_output_filter(const output_filter& filter) {
+          filter_ = filter;
+        }
+
         /**
          * Outputs samples. First outputs the values of the sample params
          * from a stan::mcmc::sample, then outputs the values of the sampler
@@ -99,26 +151,23 @@ namespace stan {
                                  stan::mcmc::sample& sample,
                                  stan::mcmc::base_mcmc& sampler,
                                  Model& model) {
-          std::vector<double> values;
-
-          sample.get_sample_params(values);
-          sampler.get_sampler_params(values);
-
-          Eigen::VectorXd model_values;
+          values_.clear();
+          sample.get_sample_params(values_);
+          sampler.get_sampler_params(values_);
 
           std::stringstream ss;
           model.write_array(rng,
                             const_cast<Eigen::VectorXd&>(sample.cont_params()),
-                            model_values,
-                            true, true,
+                            model_values_,
+                            filter_.include_tparams(),
+                            filter_.include_gqs(),
                             &ss);
           if (ss.str().length() > 0)
             message_writer_(ss.str());
 
-          for (int i = 0; i < model_values.size(); ++i)
-            values.push_back(model_values(i));
+          filter_.append(model_values_, values_);
 
-          sample_writer_(values);
+          add_row_(sample_writer_, sample_block_, values_);
         }
 
         /**
@@ -129,6 +178,7 @@ namespace stan {
          * @param sampler sampler
          */
         void write_adapt_finish(stan::mcmc::base_mcmc* sampler) {
+          write_block_(sample_writer_, sample_block_);
           sample_writer_("Adaptation terminated");
           sampler->write_sampler_state(sample_writer_);
         }
@@ -159,6 +209,7 @@ namespace stan {
 
           sampler->get_sampler_diagnostic_names(model_names, names);
 
+          write_block_(diagnostic_writer_, diagnostic_block_);
           diagnostic_writer_(names);
         }
 
@@ -176,13 +227,20 @@ namespace stan {
          */
         void write_diagnostic_params(stan::mcmc::sample& sample,
                                      stan::mcmc::base_mcmc* sampler) {
-          std::vector<double> values;
+          values_.clear();
+          sample.get_sample_params(values_);
+          sampler->get_sampler_params(values_);
+          sampler->get_sampler_diagnostics(values_);
 
-          sample.get_sample_params(values);
-          sampler->get_sampler_params(values);
-          sampler->get_sampler_diagnostics(values);
+          add_row_(diagnostic_writer_, diagnostic_block_, values_);
+        }
 
-          diagnostic_writer_(values);
+        /**
+         * Writes the buffered rows of sample and diagnostic values.
+         */
+        void flush() {
+          write_block_(sample_writer_, sample_block_);
+          write_block_(diagnostic_writer_, diagnostic_block_);
         }
 
 
@@ -206,6 +264,7 @@ namespace stan {
           std::string title(" Elapsed Time: ");
           std::stringstream ss;
 
+          flush();
 
           writer();
 
@@ -239,6 +298,44 @@ namespace stan {
           write_timing(warmDeltaT, sampleDeltaT, diagnostic_writer_);
           write_timing(warmDeltaT, sampleDeltaT, message_writer_);
         }
+
+      private:
+        /**
+         * Adds a row to a block, writing the block first if the row
+         * has a different length and afterwards if the block is full.
+         * Without blocking each row is written as it comes.
+         */
+        template <class Writer>
+        void add_row_(Writer& writer, block& b,
+                      const std::vector<double>& row) {
+          if (block_rows_ == 1) {
+            writer(row);
+            return;
+          }
+          if (row.empty())
+            return;
+          if (b.rows > 0 && static_cast<int>(row.size()) != b.cols)
+            write_block_(writer, b);
+          if (b.rows == 0)
+            b.values.clear();
+
+          b.cols = row.size();
+          b.values.insert(b.values.end(), row.begin(), row.end());
+          if (++b.rows == block_rows_)
+            write_block_(writer, b);
+        }
+
+        template <class Writer>
+        void write_block_(Writer& writer, block& b) {
+          if (b.rows == 0)
+            return;
+          int rows = b.rows;
+          b.rows = 0;
+          // Through base_writer, since a writer that overrides only
+          // the older overloads hides the one for blocks
+          interface_callbacks::writer::base_writer& base_writer = writer;
+          base_writer(&b.values[0], rows, b.cols);
+        }
       };
     }
   }
@@ -0,0 +1,201 @@
+#ifndef STAN_SERVICES_SAMPLE_OUTPUT_FILTER_HPP
+#define STAN_SERVICES_SAMPLE_OUTPUT_FILTER_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace services {
+    namespace sample {
+
+      /**
+       * Selects which of a model's constrained values are written
+       * with each draw.
+       *
+       * A filter is built from name patterns and resolved once
+       * against the model's constrained_param_names, so writing a
+       * draw only copies the selected values.  A pattern matches a
+       * name in the output header, such as "theta.1.2", either
+       * exactly or as a prefix ending at a '.', so "theta" selects
+       * every element of theta.  Indexes may also be written with
+       * brackets, as in "theta[1,2]", and '*' matches any sequence of
+       * characters.
+       *
+       * The filter also reports whether any transformed parameter or
+       * generated quantity is selected, so write_array can skip
+       * computing blocks no one asked for.  Generated quantities are
+       * only computed together with the transformed parameters.  A
+       * model whose generated quantities use random numbers draws
+       * fewer of them when they are skipped, so the draws that follow
+       * differ from an unfiltered run.
+       */
+      class output_filter {
+      public:
+        /**
+         * Constructs a filter that selects every value.
+         */
+        output_filter()
+          : all_(true), include_tparams_(true), include_gqs_(true) {}
+
+        /**
+         * Constructs a filter selecting the values whose names match
+         * any of the patterns.  An empty list of patterns selects
+         * every value.
+         *
+         * @tparam Model model class
+         * @param patterns name patterns
+         * @param model model the filter is applied to
+         * @throw std::invalid_argument if a pattern matches no name
+         */
+        template <class Model>
+        output_filter(const std::vector<std::string>& patterns,
+                      const Model& model)
+          : all_(patterns.empty()),
+            include_tparams_(true), include_gqs_(true) {
+          if (all_)
+            return;
+
+          std::vector<std::string> names;
+          model.constrained_param_names(names, false, false);
+          size_t num_params = names.size();
+          names.clear();
+          model.constrained_param_names(names, true, false);
+          size_t num_tparams = names.size() - num_params;
+          names.clear();
+          model.constrained_param_names(names, true, true);
+
+          std::vector<bool> selected(names.size(), false);
+          for (size_t p = 0; p < patterns.size(); ++p) {
+            std::string pattern = normalize_(patterns[p]);
+            bool found = false;
+            for (size_t n = 0; n < names.size(); ++n) {
+              if (matches_(pattern, names[n])) {
+                selected[n] = true;
+                found = true;
+              }
+            }
+            if (!found)
+              throw std::invalid_argument("output_filter: no output "
+                                          "matches " + patterns[p]);
+          }
+
+          include_tparams_ = false;
+          include_gqs_ = false;
+          for (size_t n = 0; n < names.size(); ++n) {
+            if (!selected[n])
+              continue;
+            indices_.push_back(n);
+            if (n >= num_params + num_tparams)
+              include_gqs_ = true;
+            else if (n >= num_params)
+              include_tparams_ = true;
+          }
+          if (include_gqs_)
+            include_tparams_ = true;
+        }
+
+        /**
+         * Appends the selected names.
+         *
+         * @param names all of the model's constrained parameter names
+         * @param selected names the selected names are appended to
+         */
+        void append(const std::vector<std::string>& names,
+                    std::vector<std::string>& selected) const {
+          if (all_) {
+            selected.insert(selected.end(), names.begin(), names.end());
+            return;
+          }
+          for (size_t n = 0; n < indices_.size(); ++n)
+            selected.push_back(names[indices_[n]]);
+        }
+
+        /**
+         * Appends the selected values.
+         *
+         * @param values values written by write_array with
+         *   include_tparams() and include_gqs()
+         * @param selected values the selected values are appended to
+         */
+        void append(const Eigen::VectorXd& values,
+                    std::vector<double>& selected) const {
+          if (all_) {
+            selected.insert(selected.end(), values.data(),
+                            values.data() + values.size());
+            return;
+          }
+          for (size_t n = 0; n < indices_.size(); ++n)
+            selected.push_back(values(indices_[n]));
+        }
+
+        /**
+         * Returns true if write_array must compute the transformed
+         * parameters.
+         */
+        bool include_tparams() const {
+          return include_tparams_;
+        }
+
+        /**
+         * Returns true if write_array must compute the generated
+         * quantities.
+         */
+        bool include_gqs() const {
+          return include_gqs_;
+        }
+
+      private:
+        bool all_;
+        bool include_tparams_;
+        bool include_gqs_;
+        std::vector<size_t> indices_;
+
+        /**
+         * Writes bracketed indexes the way they appear in the output
+         * header, so "theta[1,2]" becomes "theta.1.2".
+         */
+        static std::string normalize_(const std::string& pattern) {
+          std::string normalized;
+          for (size_t n = 0; n < pattern.size(); ++n) {
+            char c = pattern[n];
+            if (c == '[' || c == ',')
+              normalized += '.';
+            else if (c != ']' && c != ' ')
+              normalized += c;
+          }
+          return normalized;
+        }
+
+        static bool matches_(const std::string& pattern,
+                             const std::string& name) {
+          if (glob_(pattern, 0, name, 0))
+            return true;
+          for (size_t n = 0; n < name.size(); ++n)
+            if (name[n] == '.' && glob_(pattern, 0, name.substr(0, n), 0))
+              return true;
+          return false;
+        }
+
+        static bool glob_(const std::string& pattern, size_t p,
+                          const std::string& name, size_t n) {
+          for (; p < pattern.size(); ++p, ++n) {
+            if (pattern[p] == '*') {
+              for (size_t k = n; k <= name.size(); ++k)
+                if (glob_(pattern, p + 1, name, k))
+                  return true;
+              return false;
+            }
+            if (n == name.size() || pattern[p] != name[n])
+              return false;
+          }
+          return n == name.size();
+        }
+      };
+
+    }
+  }
+}
+
+#endif
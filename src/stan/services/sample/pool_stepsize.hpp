@@ -0,0 +1,44 @@
+#ifndef STAN_SERVICES_SAMPLE_POOL_STEPSIZE_HPP
+#define STAN_SERVICES_SAMPLE_POOL_STEPSIZE_HPP
+
+#include <stan/mcmc/base_mcmc.hpp>
+#include <cmath>
+#include <vector>
+
+namespace stan {
+  namespace services {
+    namespace sample {
+
+      /**
+       * Sets the nominal step size of every chain to the geometric
+       * mean of their adapted step sizes.
+       *
+       * Called once the adaptation of chains that warmed up together
+       * has been disengaged, so that they continue with a common step
+       * size.  Since each chain's adapted step size is the exponential
+       * of its dual averaging iterate, this averages those iterates.
+       *
+       * @tparam Sampler HMC sampler class
+       * @param[in,out] chains samplers of the chains
+       */
+      template <class Sampler>
+      void pool_stepsize(std::vector<stan::mcmc::base_mcmc*>& chains) {
+        if (chains.empty())
+          return;
+
+        double log_stepsize = 0;
+        for (size_t n = 0; n < chains.size(); ++n)
+          log_stepsize += std::log(dynamic_cast<Sampler*>(chains[n])
+                                   ->get_nominal_stepsize());
+        log_stepsize /= chains.size();
+
+        for (size_t n = 0; n < chains.size(); ++n)
+          dynamic_cast<Sampler*>(chains[n])
+            ->set_nominal_stepsize(std::exp(log_stepsize));
+      }
+
+    }
+  }
+}
+
+#endif
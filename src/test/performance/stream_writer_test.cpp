@@ -0,0 +1,114 @@
+/**
+ * Performance test: stream_writer.
+ *
+ * This test writes the same block of draws to a file twice: once
+ * the way stream_writer used to write rows, inserting each value
+ * with operator<< and ending each row with std::endl, and once
+ * through stream_writer.  It prints the rows per second of each and
+ * checks that both files hold the same bytes.
+ *
+ * The draws have 1000 columns of values with full precision, which
+ * is the shape that makes sample output slow for large models.
+ *
+ * Below are the test routines in this test.
+ * 1. reference: Times the operator<< and std::endl rows.
+ * 2. stream_writer: Times stream_writer.
+ * 3. same_output: Compares the two files.  Test will succeed if the
+ *    files are identical; the test will fail otherwise.
+ */
+
+#include <gtest/gtest.h>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class performance_stream_writer : public ::testing::Test {
+public:
+  static void SetUpTestCase() {
+    N_rows = 5000;
+    N_cols = 1000;
+
+    boost::ecuyer1988 rng(0);
+    boost::variate_generator<boost::ecuyer1988&,
+                             boost::normal_distribution<> >
+      normal(rng, boost::normal_distribution<>());
+    draws.resize(N_rows, std::vector<double>(N_cols));
+    for (int n = 0; n < N_rows; ++n)
+      for (int k = 0; k < N_cols; ++k)
+        draws[n][k] = normal();
+  }
+
+  static void TearDownTestCase() {
+    std::remove(reference_file);
+    std::remove(stream_writer_file);
+  }
+
+  static double rows_per_second(clock_t t) {
+    return N_rows / (static_cast<double>(t) / CLOCKS_PER_SEC);
+  }
+
+  static int N_rows;
+  static int N_cols;
+  static std::vector<std::vector<double> > draws;
+  static const char* reference_file;
+  static const char* stream_writer_file;
+};
+
+int performance_stream_writer::N_rows;
+int performance_stream_writer::N_cols;
+std::vector<std::vector<double> > performance_stream_writer::draws;
+const char* performance_stream_writer::reference_file
+  = "test/performance/stream_writer_reference.csv";
+const char* performance_stream_writer::stream_writer_file
+  = "test/performance/stream_writer_output.csv";
+
+TEST_F(performance_stream_writer, reference) {
+  std::ofstream output(reference_file);
+  clock_t t = clock();
+  for (int n = 0; n < N_rows; ++n) {
+    std::vector<double>::const_iterator last = draws[n].end();
+    --last;
+    for (std::vector<double>::const_iterator it = draws[n].begin();
+         it != last; ++it)
+      output << *it << ",";
+    output << draws[n].back() << std::endl;
+  }
+  output.close();
+  t = clock() - t;
+  std::cout << "operator<<: " << rows_per_second(t) << " rows per second"
+            << std::endl;
+  SUCCEED();
+}
+
+TEST_F(performance_stream_writer, stream_writer) {
+  std::ofstream output(stream_writer_file);
+  stan::interface_callbacks::writer::stream_writer writer(output);
+  clock_t t = clock();
+  for (int n = 0; n < N_rows; ++n)
+    writer(draws[n]);
+  writer.flush();
+  output.close();
+  t = clock() - t;
+  std::cout << "stream_writer: " << rows_per_second(t) << " rows per second"
+            << std::endl;
+  SUCCEED();
+}
+
+TEST_F(performance_stream_writer, same_output) {
+  std::ifstream reference(reference_file);
+  std::ifstream written(stream_writer_file);
+  std::stringstream reference_text;
+  std::stringstream written_text;
+  reference_text << reference.rdbuf();
+  written_text << written.rdbuf();
+  ASSERT_FALSE(reference_text.str().empty());
+  EXPECT_TRUE(reference_text.str() == written_text.str());
+}
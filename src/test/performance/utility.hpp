@@ -450,14 +450,15 @@ namespace stan {
         // Warm-Up
         clock_t start = clock();
           
-        services::mcmc::warmup<Model, rng_t>(sampler_ptr, num_warmup, num_samples, num_thin,
-                                             refresh, save_warmup,
-                                             writer,
-                                             s, model, base_rng,
-                                             prefix, suffix, std::cout,
-                                             startTransitionCallback,
-                                             info_writer,
-                                             err_writer);
+        int num_warmup_run
+          = services::mcmc::warmup<Model, rng_t>(sampler_ptr, num_warmup, num_samples, num_thin,
+                                                 refresh, save_warmup,
+                                                 writer,
+                                                 s, model, base_rng,
+                                                 prefix, suffix, std::cout,
+                                                 startTransitionCallback,
+                                                 info_writer,
+                                                 err_writer);
 
         clock_t end = clock();
         warmDeltaT = static_cast<double>(end - start) / CLOCKS_PER_SEC;
@@ -471,7 +472,7 @@ namespace stan {
         start = clock();
           
         services::mcmc::sample<Model, rng_t>
-          (sampler_ptr, num_warmup, num_samples, num_thin,
+          (sampler_ptr, num_warmup_run, num_samples, num_thin,
            refresh, true,
            writer,
            s, model, base_rng,
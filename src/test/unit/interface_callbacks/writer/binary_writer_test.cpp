@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <stan/interface_callbacks/writer/binary_writer.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace format = stan::io::stan_binary;
+
+class StanInterfaceCallbacksBinaryWriter: public ::testing::Test {
+public:
+  StanInterfaceCallbacksBinaryWriter() :
+    ss(), writer(ss, 2) {}
+
+  // Checks the file header and leaves the stream at the first record
+  void read_file_header() {
+    ss.seekg(0);
+    char magic[sizeof(format::MAGIC)];
+    ss.read(magic, sizeof(magic));
+    EXPECT_EQ(std::string(format::MAGIC, sizeof(format::MAGIC)),
+              std::string(magic, sizeof(magic)));
+    EXPECT_EQ(format::VERSION, format::read_uint(ss));
+  }
+
+  std::stringstream ss;
+  stan::interface_callbacks::writer::binary_writer writer;
+};
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, file_header) {
+  std::string bytes = ss.str();
+  ASSERT_EQ(12U, bytes.size());
+  EXPECT_EQ("standrws", bytes.substr(0, 8));
+  EXPECT_EQ(std::string("\x01\x00\x00\x00", 4), bytes.substr(8));
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, key_values) {
+  const double values[] = { 1.5, -2, 3.25, 4, 5, 6 };
+
+  writer("key", 5.2);
+  writer("key", -3);
+  writer("key", std::string("value"));
+  writer("key", values, 3);
+  writer("key", values, 2, 3);
+  writer("key", values, 0);
+
+  read_file_header();
+  double x;
+  EXPECT_EQ(format::KEY_DOUBLE, ss.get());
+  EXPECT_EQ("key", format::read_string(ss));
+  format::read_doubles(ss, &x, 1);
+  EXPECT_FLOAT_EQ(5.2, x);
+
+  EXPECT_EQ(format::KEY_INT, ss.get());
+  EXPECT_EQ("key", format::read_string(ss));
+  EXPECT_EQ(-3, format::read_int(ss));
+
+  EXPECT_EQ(format::KEY_STRING, ss.get());
+  EXPECT_EQ("key", format::read_string(ss));
+  EXPECT_EQ("value", format::read_string(ss));
+
+  std::vector<double> read(6);
+  EXPECT_EQ(format::KEY_VECTOR, ss.get());
+  EXPECT_EQ("key", format::read_string(ss));
+  EXPECT_EQ(3U, format::read_uint(ss));
+  format::read_doubles(ss, &read[0], 3);
+  EXPECT_FLOAT_EQ(3.25, read[2]);
+
+  EXPECT_EQ(format::KEY_MATRIX, ss.get());
+  EXPECT_EQ("key", format::read_string(ss));
+  EXPECT_EQ(2U, format::read_uint(ss));
+  EXPECT_EQ(3U, format::read_uint(ss));
+  format::read_doubles(ss, &read[0], 6);
+  for (int n = 0; n < 6; ++n)
+    EXPECT_FLOAT_EQ(values[n], read[n]);
+
+  ss.get();
+  EXPECT_TRUE(ss.eof());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, names_and_messages) {
+  std::vector<std::string> names;
+  names.push_back("lp__");
+  names.push_back("theta.1");
+
+  writer("message");
+  writer();
+  writer(names);
+  writer(std::vector<std::string>());
+
+  read_file_header();
+  EXPECT_EQ(format::MESSAGE, ss.get());
+  EXPECT_EQ("message", format::read_string(ss));
+  EXPECT_EQ(format::MESSAGE, ss.get());
+  EXPECT_EQ("", format::read_string(ss));
+  EXPECT_EQ(format::NAMES, ss.get());
+  EXPECT_EQ(2U, format::read_uint(ss));
+  EXPECT_EQ("lp__", format::read_string(ss));
+  EXPECT_EQ("theta.1", format::read_string(ss));
+
+  ss.get();
+  EXPECT_TRUE(ss.eof());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, draws_in_column_blocks) {
+  std::vector<double> row(3);
+  for (int n = 0; n < 3; ++n) {
+    row[0] = n;
+    row[1] = 10 + n;
+    row[2] = 100 + n;
+    writer(row);
+  }
+  // The first block is full, the third row is still buffered
+  std::size_t buffered = ss.str().size();
+  writer("Adaptation terminated");
+  EXPECT_LT(buffered, ss.str().size());
+
+  read_file_header();
+  std::vector<double> block(6);
+  EXPECT_EQ(format::DRAWS, ss.get());
+  EXPECT_EQ(2U, format::read_uint(ss));
+  EXPECT_EQ(3U, format::read_uint(ss));
+  format::read_doubles(ss, &block[0], 6);
+  EXPECT_FLOAT_EQ(0, block[0]);
+  EXPECT_FLOAT_EQ(1, block[1]);
+  EXPECT_FLOAT_EQ(10, block[2]);
+  EXPECT_FLOAT_EQ(11, block[3]);
+  EXPECT_FLOAT_EQ(100, block[4]);
+  EXPECT_FLOAT_EQ(101, block[5]);
+
+  EXPECT_EQ(format::DRAWS, ss.get());
+  EXPECT_EQ(1U, format::read_uint(ss));
+  EXPECT_EQ(3U, format::read_uint(ss));
+  format::read_doubles(ss, &block[0], 3);
+  EXPECT_FLOAT_EQ(2, block[0]);
+  EXPECT_FLOAT_EQ(12, block[1]);
+  EXPECT_FLOAT_EQ(102, block[2]);
+
+  EXPECT_EQ(format::MESSAGE, ss.get());
+  EXPECT_EQ("Adaptation terminated", format::read_string(ss));
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, draws_from_row_block) {
+  const double x[] = { 0, 10, 1, 11, 2, 12 };
+  writer(x, 3, 2);
+  writer.flush();
+
+  read_file_header();
+  std::vector<double> block(4);
+  EXPECT_EQ(format::DRAWS, ss.get());
+  EXPECT_EQ(2U, format::read_uint(ss));
+  EXPECT_EQ(2U, format::read_uint(ss));
+  format::read_doubles(ss, &block[0], 4);
+  EXPECT_FLOAT_EQ(0, block[0]);
+  EXPECT_FLOAT_EQ(1, block[1]);
+  EXPECT_FLOAT_EQ(10, block[2]);
+  EXPECT_FLOAT_EQ(11, block[3]);
+
+  EXPECT_EQ(format::DRAWS, ss.get());
+  EXPECT_EQ(1U, format::read_uint(ss));
+  EXPECT_EQ(2U, format::read_uint(ss));
+  format::read_doubles(ss, &block[0], 2);
+  EXPECT_FLOAT_EQ(2, block[0]);
+  EXPECT_FLOAT_EQ(12, block[1]);
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, new_block_when_width_changes) {
+  writer(std::vector<double>(3, 1.0));
+  writer(std::vector<double>(2, 2.0));
+  writer(std::vector<double>());
+  writer.flush();
+
+  read_file_header();
+  std::vector<double> block(3);
+  EXPECT_EQ(format::DRAWS, ss.get());
+  EXPECT_EQ(1U, format::read_uint(ss));
+  EXPECT_EQ(3U, format::read_uint(ss));
+  format::read_doubles(ss, &block[0], 3);
+  EXPECT_EQ(format::DRAWS, ss.get());
+  EXPECT_EQ(1U, format::read_uint(ss));
+  EXPECT_EQ(2U, format::read_uint(ss));
+  format::read_doubles(ss, &block[0], 2);
+  EXPECT_FLOAT_EQ(2, block[1]);
+
+  ss.get();
+  EXPECT_TRUE(ss.eof());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, flushes_on_destruction) {
+  std::stringstream output;
+  {
+    stan::interface_callbacks::writer::binary_writer scoped(output);
+    scoped(std::vector<double>(2, 1.0));
+    EXPECT_EQ(12U, output.str().size());
+  }
+  EXPECT_EQ(12U + 1 + 8 + 2 * 8, output.str().size());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, invalid_chunk_rows) {
+  std::stringstream output;
+  EXPECT_THROW(stan::interface_callbacks::writer::binary_writer(output, 0),
+               std::invalid_argument);
+}
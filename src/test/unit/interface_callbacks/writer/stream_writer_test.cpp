@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <boost/lexical_cast.hpp>
 #include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <limits>
+#include <sstream>
 
 class StanInterfaceCallbacksStreamWriter: public ::testing::Test {
 public:
@@ -99,6 +101,114 @@ TEST_F(StanInterfaceCallbacksStreamWriter, double_vector) {
   EXPECT_EQ("0,1,2,3,4\n", ss.str());
 }
 
+// Writes a row the way operator<< formats each value
+std::string stream_row(const std::vector<double>& x, std::ostream& format) {
+  std::stringstream expected;
+  expected.copyfmt(format);
+  for (size_t n = 0; n < x.size(); ++n)
+    expected << (n > 0 ? "," : "") << x[n];
+  expected << "\n";
+  return expected.str();
+}
+
+TEST_F(StanInterfaceCallbacksStreamWriter, double_vector_formatting) {
+  std::vector<double> x;
+  x.push_back(0.1 + 0.2);
+  x.push_back(-0.0);
+  x.push_back(1e-300);
+  x.push_back(-123456789.0);
+  x.push_back(2.5e10);
+  x.push_back(std::numeric_limits<double>::infinity());
+  x.push_back(-std::numeric_limits<double>::infinity());
+  x.push_back(std::numeric_limits<double>::quiet_NaN());
+
+  writer(x);
+  EXPECT_EQ(stream_row(x, ss), ss.str());
+
+  ss.str(std::string());
+  ss.precision(17);
+  writer(x);
+  EXPECT_EQ(stream_row(x, ss), ss.str());
+
+  ss.str(std::string());
+  ss.setf(std::ios_base::scientific, std::ios_base::floatfield);
+  ss.precision(3);
+  writer(x);
+  EXPECT_EQ(stream_row(x, ss), ss.str());
+}
+
+class sync_counting_buf : public std::stringbuf {
+public:
+  sync_counting_buf() : syncs(0) {}
+
+  int sync() {
+    ++syncs;
+    return std::stringbuf::sync();
+  }
+
+  int syncs;
+};
+
+TEST_F(StanInterfaceCallbacksStreamWriter, double_vector_flush_rows) {
+  sync_counting_buf buf;
+  std::ostream output(&buf);
+  stan::interface_callbacks::writer::stream_writer every_third(output, "", 3);
+  std::vector<double> x(2, 1.0);
+
+  for (int n = 0; n < 7; ++n)
+    every_third(x);
+  EXPECT_EQ(2, buf.syncs);
+  EXPECT_EQ(7 * std::string("1,1\n").size(), buf.str().size());
+
+  every_third.flush();
+  EXPECT_EQ(3, buf.syncs);
+
+  buf.syncs = 0;
+  stan::interface_callbacks::writer::stream_writer unflushed(output);
+  for (int n = 0; n < 7; ++n)
+    unflushed(x);
+  EXPECT_EQ(0, buf.syncs);
+}
+
+TEST_F(StanInterfaceCallbacksStreamWriter, double_block) {
+  const double x[] = { 0, 1, 2, 3, 4, 5 };
+
+  EXPECT_NO_THROW(writer(x, 2, 3));
+  EXPECT_EQ("0,1,2\n3,4,5\n", ss.str());
+}
+
+// Writes only what base_writer requires
+class rows_writer : public stan::interface_callbacks::writer::base_writer {
+public:
+  void operator()(const std::string& key, double value) {}
+  void operator()(const std::string& key, int value) {}
+  void operator()(const std::string& key, const std::string& value) {}
+  void operator()(const std::string& key, const double* values,
+                  int n_values) {}
+  void operator()(const std::string& key, const double* values,
+                  int n_rows, int n_cols) {}
+  void operator()(const std::vector<std::string>& names) {}
+  void operator()(const std::vector<double>& state) {
+    rows.push_back(state);
+  }
+  void operator()() {}
+  void operator()(const std::string& message) {}
+
+  std::vector<std::vector<double> > rows;
+};
+
+TEST_F(StanInterfaceCallbacksStreamWriter, double_block_default) {
+  const double x[] = { 0, 1, 2, 3, 4, 5 };
+  rows_writer rows;
+  stan::interface_callbacks::writer::base_writer& base = rows;
+
+  base(x, 3, 2);
+  ASSERT_EQ(3U, rows.rows.size());
+  ASSERT_EQ(2U, rows.rows[2].size());
+  EXPECT_FLOAT_EQ(4, rows.rows[2][0]);
+  EXPECT_FLOAT_EQ(5, rows.rows[2][1]);
+}
+
 TEST_F(StanInterfaceCallbacksStreamWriter, string_vector) {
   const int N = 5;
   std::vector<std::string> x;
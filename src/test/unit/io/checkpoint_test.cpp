@@ -0,0 +1,77 @@
+#include <stan/io/checkpoint.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+TEST(ioCheckpoint, round_trip) {
+  std::stringstream ss;
+
+  Eigen::VectorXd v(3);
+  v << 1.5, -2.25, 1e-300;
+  Eigen::MatrixXd m(2, 2);
+  m << 1, 2, 3, 4;
+  boost::ecuyer1988 rng(17);
+  rng();
+
+  stan::io::checkpoint_writer writer(ss);
+  writer.begin_section("section");
+  writer.write(true);
+  writer.write(-3);
+  writer.write(0.1);
+  writer.write(std::string("text"));
+  writer.write(v);
+  writer.write(m);
+  writer.write_rng(rng);
+
+  stan::io::checkpoint_reader reader(ss);
+  reader.begin_section("section");
+  bool b = false;
+  int i = 0;
+  double d = 0;
+  std::string s;
+  Eigen::VectorXd v_read(3);
+  Eigen::MatrixXd m_read(2, 2);
+  boost::ecuyer1988 rng_read;
+  reader.read(b);
+  reader.read(i);
+  reader.read(d);
+  reader.read(s);
+  reader.read(v_read);
+  reader.read(m_read);
+  reader.read_rng(rng_read);
+
+  EXPECT_TRUE(b);
+  EXPECT_EQ(-3, i);
+  EXPECT_EQ(0.1, d);
+  EXPECT_EQ("text", s);
+  for (int n = 0; n < 3; ++n)
+    EXPECT_EQ(v(n), v_read(n));
+  for (int n = 0; n < 4; ++n)
+    EXPECT_EQ(m(n), m_read(n));
+  EXPECT_EQ(rng(), rng_read());
+}
+
+TEST(ioCheckpoint, errors) {
+  std::stringstream not_checkpoint("not a checkpoint");
+  EXPECT_THROW(stan::io::checkpoint_reader reader(not_checkpoint),
+               std::runtime_error);
+
+  std::stringstream ss;
+  stan::io::checkpoint_writer writer(ss);
+  writer.begin_section("nuts");
+  writer.write(Eigen::VectorXd::Zero(2).eval());
+
+  stan::io::checkpoint_reader reader(ss);
+  EXPECT_THROW(reader.begin_section("xhmc"), std::runtime_error);
+
+  Eigen::VectorXd wrong_size(3);
+  EXPECT_THROW(reader.read(wrong_size), std::runtime_error);
+
+  std::stringstream truncated;
+  stan::io::checkpoint_writer empty_writer(truncated);
+  stan::io::checkpoint_reader truncated_reader(truncated);
+  double x;
+  EXPECT_THROW(truncated_reader.read(x), std::runtime_error);
+}
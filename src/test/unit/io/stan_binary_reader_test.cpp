@@ -0,0 +1,155 @@
+#include <stan/io/stan_binary_reader.hpp>
+#include <stan/interface_callbacks/writer/binary_writer.hpp>
+#include <stan/mcmc/chains.hpp>
+#include <boost/lexical_cast.hpp>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Writes a Stan csv file through a binary_writer the way the sampler
+// would have written it
+void csv_to_binary(std::istream& csv,
+                   stan::interface_callbacks::writer::binary_writer& writer) {
+  std::string line;
+  while (std::getline(csv, line)) {
+    if (line.empty())
+      continue;
+    std::vector<std::string> tokens;
+    std::stringstream ss(line);
+    std::string token;
+    if (line[0] == '#') {
+      writer(line.substr(line.size() < 2 ? line.size() : 2));
+    } else if (line[0] == 'l') {
+      while (std::getline(ss, token, ','))
+        tokens.push_back(token);
+      writer(tokens);
+    } else {
+      std::vector<double> values;
+      while (std::getline(ss, token, ','))
+        values.push_back(boost::lexical_cast<double>(token));
+      writer(values);
+    }
+  }
+  writer.flush();
+}
+
+class StanIoStanBinaryReader : public testing::Test {
+public:
+  void SetUp() {
+    std::ifstream blocker0_stream
+      ("src/test/unit/io/test_csv_files/blocker.0.csv");
+    csv = stan::io::stan_csv_reader::parse(blocker0_stream, 0);
+    blocker0_stream.close();
+  }
+
+  void write_blocker0(int chunk_rows) {
+    std::ifstream blocker0_stream
+      ("src/test/unit/io/test_csv_files/blocker.0.csv");
+    stan::interface_callbacks::writer::binary_writer writer(binary,
+                                                            chunk_rows);
+    csv_to_binary(blocker0_stream, writer);
+    blocker0_stream.close();
+  }
+
+  stan::io::stan_csv csv;
+  std::stringstream binary;
+};
+
+TEST_F(StanIoStanBinaryReader, matches_csv) {
+  write_blocker0(37);
+  std::stringstream out;
+  stan::io::stan_csv data = stan::io::stan_binary_reader::parse(binary, &out);
+  EXPECT_EQ("", out.str());
+
+  EXPECT_EQ(2, data.metadata.stan_version_major);
+  EXPECT_EQ(9, data.metadata.stan_version_minor);
+  EXPECT_EQ(csv.metadata.model, data.metadata.model);
+  EXPECT_EQ(csv.metadata.seed, data.metadata.seed);
+  EXPECT_EQ(csv.metadata.num_samples, data.metadata.num_samples);
+  EXPECT_EQ(csv.metadata.thin, data.metadata.thin);
+  EXPECT_EQ(csv.metadata.algorithm, data.metadata.algorithm);
+  EXPECT_EQ(csv.metadata.engine, data.metadata.engine);
+
+  ASSERT_EQ(csv.header.size(), data.header.size());
+  for (int n = 0; n < csv.header.size(); ++n)
+    EXPECT_EQ(csv.header(n), data.header(n));
+  EXPECT_EQ("mu[1]", data.header(9));
+
+  EXPECT_FLOAT_EQ(csv.adaptation.step_size, data.adaptation.step_size);
+  ASSERT_EQ(csv.adaptation.metric.rows(), data.adaptation.metric.rows());
+  ASSERT_EQ(csv.adaptation.metric.cols(), data.adaptation.metric.cols());
+  for (int n = 0; n < csv.adaptation.metric.size(); ++n)
+    EXPECT_FLOAT_EQ(csv.adaptation.metric(n), data.adaptation.metric(n));
+
+  ASSERT_EQ(1000, data.samples.rows());
+  ASSERT_EQ(csv.samples.cols(), data.samples.cols());
+  for (int n = 0; n < csv.samples.size(); ++n)
+    ASSERT_EQ(csv.samples(n), data.samples(n));
+
+  EXPECT_FLOAT_EQ(0.391415, data.timing.warmup);
+  EXPECT_FLOAT_EQ(0.648336, data.timing.sampling);
+}
+
+TEST_F(StanIoStanBinaryReader, loads_into_chains) {
+  write_blocker0(1024);
+  stan::io::stan_csv data = stan::io::stan_binary_reader::parse(binary, 0);
+
+  stan::mcmc::chains<> from_csv(csv);
+  stan::mcmc::chains<> from_binary(data);
+  EXPECT_EQ(from_csv.num_params(), from_binary.num_params());
+  EXPECT_EQ(from_csv.num_samples(), from_binary.num_samples());
+  EXPECT_FLOAT_EQ(from_csv.mean("d"), from_binary.mean("d"));
+}
+
+TEST_F(StanIoStanBinaryReader, key_values_as_comments) {
+  stan::interface_callbacks::writer::binary_writer writer(binary);
+  writer("stan_version_major", 2);
+  writer("model", std::string("blocker_model"));
+  std::vector<std::string> names;
+  names.push_back("lp__");
+  names.push_back("x");
+  writer(names);
+  writer("Adaptation terminated");
+  writer("Step size", 0.5);
+  writer("Diagonal elements of inverse mass matrix:");
+  writer("2, 3");
+  writer(std::vector<double>(2, 1.0));
+  writer.flush();
+
+  stan::io::stan_csv data = stan::io::stan_binary_reader::parse(binary, 0);
+  EXPECT_EQ(2, data.metadata.stan_version_major);
+  EXPECT_EQ("blocker_model", data.metadata.model);
+  EXPECT_FLOAT_EQ(0.5, data.adaptation.step_size);
+  ASSERT_EQ(2, data.adaptation.metric.size());
+  EXPECT_FLOAT_EQ(3, data.adaptation.metric(1));
+  EXPECT_EQ(1, data.samples.rows());
+}
+
+TEST_F(StanIoStanBinaryReader, rejects_csv) {
+  std::ifstream blocker0_stream
+    ("src/test/unit/io/test_csv_files/blocker.0.csv");
+  EXPECT_THROW(stan::io::stan_binary_reader::parse(blocker0_stream, 0),
+               std::invalid_argument);
+}
+
+TEST_F(StanIoStanBinaryReader, missing_header) {
+  {
+    stan::interface_callbacks::writer::binary_writer writer(binary);
+    writer("message");
+  }
+  std::stringstream out;
+  EXPECT_THROW(stan::io::stan_binary_reader::parse(binary, &out),
+               std::invalid_argument);
+  EXPECT_NE(std::string::npos, out.str().find("error reading header"));
+}
+
+TEST_F(StanIoStanBinaryReader, truncated) {
+  write_blocker0(1024);
+  std::string bytes = binary.str();
+  std::stringstream truncated(bytes.substr(0, bytes.size() - 200));
+  EXPECT_THROW(stan::io::stan_binary_reader::parse(truncated, 0),
+               std::runtime_error);
+}
@@ -0,0 +1,269 @@
+#include <stan/mcmc/block_adaptation.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/io/checkpoint.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // Draws in which parameters 0 and 3 share a common factor, as do
+  // 1, 4 and 5, while 2 is independent
+  Eigen::VectorXd correlated_draw(
+    boost::variate_generator<boost::ecuyer1988&,
+                             boost::normal_distribution<> >& rand_gaus) {
+    Eigen::VectorXd q(6);
+    for (int i = 0; i < 6; ++i)
+      q(i) = 0.3 * rand_gaus();
+    double a = rand_gaus();
+    double b = rand_gaus();
+    q(0) += a;
+    q(3) += a;
+    q(1) += b;
+    q(4) -= b;
+    q(5) += b;
+    return q;
+  }
+
+}
+
+TEST(McmcBlockAdaptation, learn_metric) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 4;
+  const int n_learn = 10;
+
+  std::vector<std::vector<int> > groups(2);
+  groups[0].push_back(0);
+  groups[0].push_back(2);
+  groups[1].push_back(1);
+  groups[1].push_back(3);
+
+  stan::mcmc::block_adaptation adapter(n);
+  adapter.set_blocks(groups);
+  adapter.set_window_params(50, 0, 0, n_learn, writer);
+
+  std::vector<std::vector<int> > blocks;
+  std::vector<Eigen::MatrixXd> covar;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(n);
+  for (int i = 0; i < n_learn - 1; ++i)
+    EXPECT_FALSE(adapter.learn_metric(blocks, covar, q));
+  EXPECT_TRUE(adapter.learn_metric(blocks, covar, q));
+
+  EXPECT_TRUE(groups == blocks);
+  ASSERT_EQ(2U, covar.size());
+
+  Eigen::MatrixXd target_covar(Eigen::MatrixXd::Identity(2, 2));
+  target_covar *= 1e-3 * 5.0 / (n_learn + 5.0);
+  for (size_t b = 0; b < covar.size(); ++b)
+    for (int i = 0; i < 2; ++i)
+      for (int j = 0; j < 2; ++j)
+        EXPECT_EQ(target_covar(i, j), covar[b](i, j));
+  EXPECT_EQ("", ss.str());
+}
+
+TEST(McmcBlockAdaptation, default_blocks_are_diagonal) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n_learn = 50;
+
+  boost::ecuyer1988 rng(0);
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<> >
+    rand_gaus(rng, boost::normal_distribution<>());
+
+  // Every parameter in its own block, and a partition that mixes
+  // single parameters with a larger block
+  stan::mcmc::block_adaptation adapter(6);
+  adapter.set_window_params(100, 0, 0, n_learn, writer);
+
+  std::vector<std::vector<int> > groups(4);
+  groups[0].push_back(2);
+  groups[1].push_back(0);
+  groups[1].push_back(3);
+  groups[2].push_back(5);
+  groups[3].push_back(1);
+  groups[3].push_back(4);
+  stan::mcmc::block_adaptation mixed(6);
+  mixed.set_blocks(groups);
+  mixed.set_window_params(100, 0, 0, n_learn, writer);
+
+  stan::math::welford_covar_estimator estimator(6);
+  std::vector<std::vector<int> > blocks;
+  std::vector<Eigen::MatrixXd> covar;
+  std::vector<std::vector<int> > mixed_blocks;
+  std::vector<Eigen::MatrixXd> mixed_covar;
+  bool update = false;
+  for (int i = 0; i < n_learn; ++i) {
+    Eigen::VectorXd q = correlated_draw(rand_gaus);
+    estimator.add_sample(q);
+    update = adapter.learn_metric(blocks, covar, q);
+    EXPECT_EQ(update, mixed.learn_metric(mixed_blocks, mixed_covar, q));
+  }
+  ASSERT_TRUE(update);
+
+  Eigen::MatrixXd full_covar(6, 6);
+  estimator.sample_covariance(full_covar);
+  double n = n_learn;
+  full_covar = (n / (n + 5.0)) * full_covar
+    + 1e-3 * (5.0 / (n + 5.0)) * Eigen::MatrixXd::Identity(6, 6);
+
+  ASSERT_EQ(6U, covar.size());
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_EQ(1, covar[i].rows());
+    EXPECT_FLOAT_EQ(full_covar(i, i), covar[i](0, 0));
+  }
+
+  EXPECT_TRUE(groups == mixed_blocks);
+  ASSERT_EQ(4U, mixed_covar.size());
+  for (size_t b = 0; b < groups.size(); ++b)
+    for (size_t i = 0; i < groups[b].size(); ++i)
+      for (size_t j = 0; j < groups[b].size(); ++j)
+        EXPECT_FLOAT_EQ(full_covar(groups[b][i], groups[b][j]),
+                        mixed_covar[b](i, j));
+  EXPECT_EQ("", ss.str());
+}
+
+TEST(McmcBlockAdaptation, set_blocks) {
+  stan::mcmc::block_adaptation adapter(3);
+  EXPECT_EQ(3U, adapter.get_blocks().size());
+
+  std::vector<std::vector<int> > groups(1);
+  groups[0].push_back(0);
+  groups[0].push_back(1);
+  EXPECT_THROW(adapter.set_blocks(groups), std::invalid_argument);
+
+  groups[0].push_back(1);
+  EXPECT_THROW(adapter.set_blocks(groups), std::invalid_argument);
+
+  groups[0][2] = 2;
+  EXPECT_NO_THROW(adapter.set_blocks(groups));
+  EXPECT_EQ(1U, adapter.get_blocks().size());
+}
+
+TEST(McmcBlockAdaptation, detects_blocks) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n_learn = 200;
+
+  boost::ecuyer1988 rng(0);
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<> >
+    rand_gaus(rng, boost::normal_distribution<>());
+
+  stan::mcmc::block_adaptation adapter(6);
+  adapter.set_block_detection(0.5, 3);
+  adapter.set_window_params(1000, 0, 0, n_learn, writer);
+
+  std::vector<std::vector<int> > blocks;
+  std::vector<Eigen::MatrixXd> covar;
+  bool update = false;
+  for (int i = 0; i < n_learn; ++i)
+    update = adapter.learn_metric(blocks, covar, correlated_draw(rand_gaus));
+  ASSERT_TRUE(update);
+
+  // Blocks are listed in order of their smallest parameter
+  ASSERT_EQ(3U, blocks.size());
+  std::vector<int> expected;
+  expected.push_back(0);
+  expected.push_back(3);
+  EXPECT_TRUE(expected == blocks[0]);
+  expected.clear();
+  expected.push_back(1);
+  expected.push_back(4);
+  expected.push_back(5);
+  EXPECT_TRUE(expected == blocks[1]);
+  expected.clear();
+  expected.push_back(2);
+  EXPECT_TRUE(expected == blocks[2]);
+
+  ASSERT_EQ(3U, covar.size());
+  EXPECT_NEAR(1.0, covar[0](0, 1), 0.3);
+  EXPECT_NEAR(-1.0, covar[1](0, 1), 0.3);
+
+  // Later windows estimate each block separately; the second window
+  // runs to the end of warmup
+  for (int i = n_learn; i < 1000; ++i)
+    update = adapter.learn_metric(blocks, covar, correlated_draw(rand_gaus));
+  ASSERT_TRUE(update);
+  EXPECT_EQ(3U, blocks.size());
+  EXPECT_NEAR(1.0, covar[0](0, 1), 0.3);
+}
+
+TEST(McmcBlockAdaptation, max_block_size) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n_learn = 200;
+
+  boost::ecuyer1988 rng(0);
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<> >
+    rand_gaus(rng, boost::normal_distribution<>());
+
+  stan::mcmc::block_adaptation adapter(6);
+  adapter.set_block_detection(0.5, 2);
+  adapter.set_window_params(1000, 0, 0, n_learn, writer);
+
+  std::vector<std::vector<int> > blocks;
+  std::vector<Eigen::MatrixXd> covar;
+  for (int i = 0; i < n_learn; ++i)
+    adapter.learn_metric(blocks, covar, correlated_draw(rand_gaus));
+
+  for (size_t b = 0; b < blocks.size(); ++b)
+    EXPECT_LE(blocks[b].size(), 2U);
+  EXPECT_EQ(4U, blocks.size());
+}
+
+TEST(McmcBlockAdaptation, save_load_state) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n_learn = 20;
+
+  boost::ecuyer1988 rng(0);
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<> >
+    rand_gaus(rng, boost::normal_distribution<>());
+
+  std::vector<std::vector<int> > groups(2);
+  groups[0].push_back(5);
+  groups[0].push_back(0);
+  groups[0].push_back(3);
+  groups[1].push_back(1);
+  groups[1].push_back(2);
+  groups[1].push_back(4);
+
+  stan::mcmc::block_adaptation adapter(6);
+  adapter.set_blocks(groups);
+  adapter.set_window_params(100, 0, 0, n_learn, writer);
+
+  std::vector<std::vector<int> > blocks;
+  std::vector<Eigen::MatrixXd> covar;
+  for (int i = 0; i < n_learn / 2; ++i)
+    adapter.learn_metric(blocks, covar, correlated_draw(rand_gaus));
+
+  std::stringstream state;
+  {
+    stan::io::checkpoint_writer checkpoint(state);
+    adapter.save_state(checkpoint);
+  }
+  stan::mcmc::block_adaptation resumed(6);
+  stan::io::checkpoint_reader checkpoint(state);
+  resumed.load_state(checkpoint);
+  EXPECT_TRUE(groups == resumed.get_blocks());
+
+  std::vector<std::vector<int> > resumed_blocks;
+  std::vector<Eigen::MatrixXd> resumed_covar;
+  for (int i = n_learn / 2; i < n_learn; ++i) {
+    Eigen::VectorXd q = correlated_draw(rand_gaus);
+    EXPECT_EQ(adapter.learn_metric(blocks, covar, q),
+              resumed.learn_metric(resumed_blocks, resumed_covar, q));
+  }
+  ASSERT_EQ(covar.size(), resumed_covar.size());
+  for (size_t b = 0; b < covar.size(); ++b)
+    EXPECT_TRUE(covar[b] == resumed_covar[b]);
+}
@@ -0,0 +1,146 @@
+#include <stan/mcmc/convergence_monitor.hpp>
+#include <stan/mcmc/chains.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+
+class McmcConvergenceMonitor : public testing::Test {
+public:
+  McmcConvergenceMonitor()
+    : rng(0), rand_gaus(rng, boost::normal_distribution<>()) {}
+
+  Eigen::VectorXd draw(double shift) {
+    Eigen::VectorXd q(2);
+    q << rand_gaus() + shift, rand_gaus();
+    return q;
+  }
+
+  rng_t rng;
+  boost::variate_generator<rng_t&, boost::normal_distribution<> > rand_gaus;
+};
+
+TEST_F(McmcConvergenceMonitor, independent_draws_converge) {
+  stan::mcmc::convergence_monitor monitor(4, 2, 400, 1.05);
+
+  for (int m = 0; m < 1000 && !monitor.converged(); ++m)
+    for (int chain = 0; chain < 4; ++chain)
+      monitor.add(chain, draw(0));
+
+  EXPECT_LT(monitor.num_draws(), 1000);
+  EXPECT_GE(monitor.min_ess(), 400);
+  EXPECT_LE(monitor.max_rhat(), 1.05);
+}
+
+TEST_F(McmcConvergenceMonitor, separated_chains_do_not_converge) {
+  stan::mcmc::convergence_monitor monitor(4, 2, 400, 1.05);
+
+  for (int m = 0; m < 500; ++m)
+    for (int chain = 0; chain < 4; ++chain)
+      monitor.add(chain, draw(chain == 3 ? 5 : 0));
+
+  EXPECT_FALSE(monitor.converged());
+  EXPECT_GT(monitor.max_rhat(), 1.05);
+}
+
+TEST_F(McmcConvergenceMonitor, too_few_draws) {
+  stan::mcmc::convergence_monitor monitor(2, 2, 400, 1.05);
+
+  for (int m = 0; m < 100; ++m)
+    for (int chain = 0; chain < 2; ++chain)
+      monitor.add(chain, draw(0));
+
+  EXPECT_FALSE(monitor.converged());
+  EXPECT_EQ(0, monitor.min_ess());
+  EXPECT_EQ(100, monitor.num_draws());
+}
+
+TEST_F(McmcConvergenceMonitor, unequal_chains_are_not_checked) {
+  stan::mcmc::convergence_monitor monitor(2, 2, 10, 1.05);
+
+  for (int m = 0; m < 100; ++m)
+    monitor.add(0, draw(0));
+  for (int m = 0; m < 80; ++m)
+    monitor.add(1, draw(0));
+
+  EXPECT_FALSE(monitor.converged());
+  EXPECT_EQ(0, monitor.max_rhat());
+  EXPECT_EQ(80, monitor.num_draws());
+}
+
+// Until the batches are merged each holds one draw, so the split R
+// hat is the one computed from the draws
+TEST_F(McmcConvergenceMonitor, split_rhat_matches_chains) {
+  const int num_chains = 3;
+  const int num_draws = 40;
+  stan::mcmc::convergence_monitor monitor(num_chains, 2, 10, 1.05);
+
+  std::vector<std::string> names(2);
+  names[0] = "a";
+  names[1] = "b";
+  stan::mcmc::chains<> chains(names);
+  for (int chain = 0; chain < num_chains; ++chain) {
+    Eigen::MatrixXd draws(num_draws, 2);
+    for (int m = 0; m < num_draws; ++m) {
+      Eigen::VectorXd q = draw(0.3 * chain);
+      draws.row(m) = q;
+      monitor.add(chain, q);
+    }
+    chains.add(chain, draws);
+  }
+
+  monitor.converged();
+  double rhat = std::max(chains.split_potential_scale_reduction(0),
+                         chains.split_potential_scale_reduction(1));
+  EXPECT_FLOAT_EQ(rhat, monitor.max_rhat());
+}
+
+// Draws of an AR(1) process with coefficient rho have an effective
+// sample size of n (1 - rho) / (1 + rho)
+TEST_F(McmcConvergenceMonitor, batch_means_ess) {
+  const int num_chains = 4;
+  const int num_draws = 20000;
+  const double rho = 0.8;
+  stan::mcmc::convergence_monitor monitor(num_chains, 2, 10, 1.05);
+
+  for (int chain = 0; chain < num_chains; ++chain) {
+    Eigen::VectorXd q = draw(0);
+    for (int m = 0; m < num_draws; ++m) {
+      q = rho * q + std::sqrt(1 - rho * rho) * draw(0);
+      monitor.add(chain, q);
+    }
+  }
+
+  EXPECT_TRUE(monitor.converged());
+  double expected_ess = num_chains * num_draws * (1 - rho) / (1 + rho);
+  EXPECT_NEAR(expected_ess, monitor.min_ess(), 0.25 * expected_ess);
+  EXPECT_NEAR(1, monitor.max_rhat(), 0.01);
+}
+
+TEST_F(McmcConvergenceMonitor, constant_parameter) {
+  stan::mcmc::convergence_monitor monitor(2, 2, 100, 1.05);
+
+  for (int m = 0; m < 500; ++m)
+    for (int chain = 0; chain < 2; ++chain)
+      monitor.add(chain, Eigen::VectorXd::Zero(2));
+
+  EXPECT_FALSE(monitor.converged());
+}
+
+TEST_F(McmcConvergenceMonitor, invalid_arguments) {
+  EXPECT_THROW(stan::mcmc::convergence_monitor(0, 2, 100, 1.05),
+               std::invalid_argument);
+  EXPECT_THROW(stan::mcmc::convergence_monitor(2, 0, 100, 1.05),
+               std::invalid_argument);
+  EXPECT_THROW(stan::mcmc::convergence_monitor(2, 2, 0, 1.05),
+               std::invalid_argument);
+  EXPECT_THROW(stan::mcmc::convergence_monitor(2, 2, 100, 0),
+               std::invalid_argument);
+}
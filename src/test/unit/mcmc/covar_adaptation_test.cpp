@@ -28,3 +28,80 @@ TEST(McmcCovarAdaptation, learn_covariance) {
   }
   EXPECT_EQ("", ss.str());
 }
+
+TEST(McmcCovarAdaptation, learn_pooled_covariance) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 3;
+  const int n_learn = 10;
+  Eigen::MatrixXd covar_1(Eigen::MatrixXd::Zero(n, n));
+  Eigen::MatrixXd covar_2(Eigen::MatrixXd::Zero(n, n));
+
+  stan::mcmc::covar_adaptation_pool pool(n);
+  stan::mcmc::covar_adaptation adapter_1(n);
+  stan::mcmc::covar_adaptation adapter_2(n);
+  adapter_1.set_window_params(50, 0, 0, n_learn, writer);
+  adapter_2.set_window_params(50, 0, 0, n_learn, writer);
+  adapter_1.set_pool(&pool);
+  adapter_2.set_pool(&pool);
+
+  // Half of the pooled draws are zero and half are one
+  for (int i = 0; i < n_learn; ++i) {
+    EXPECT_FALSE(adapter_1.learn_covariance(covar_1,
+                                            Eigen::VectorXd::Zero(n)));
+    EXPECT_EQ(i == n_learn - 1,
+              adapter_2.learn_covariance(covar_2,
+                                         Eigen::VectorXd::Ones(n)));
+  }
+  EXPECT_TRUE(adapter_1.learn_covariance(covar_1,
+                                         Eigen::VectorXd::Zero(n)));
+
+  double num_draws = 2 * n_learn;
+  double target_covar = 0.25 * num_draws / (num_draws - 1);
+  target_covar *= num_draws / (num_draws + 5.0);
+  double target_var = target_covar + 1e-3 * (5.0 / (num_draws + 5.0));
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      EXPECT_FLOAT_EQ(i == j ? target_var : target_covar, covar_1(i, j));
+      EXPECT_EQ(covar_1(i, j), covar_2(i, j));
+    }
+  }
+}
+
+// With no terminal buffer the last window closes at the last warmup
+// iteration, so the first chain has no later call to pick the pooled
+// estimate up in
+TEST(McmcCovarAdaptation, pick_up_pooled_covariance_after_last_window) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 3;
+  const int num_warmup = 25;
+  const int init_buffer = 15;
+  Eigen::MatrixXd covar_1(Eigen::MatrixXd::Zero(n, n));
+  Eigen::MatrixXd covar_2(Eigen::MatrixXd::Zero(n, n));
+
+  stan::mcmc::covar_adaptation_pool pool(n);
+  stan::mcmc::covar_adaptation adapter_1(n);
+  stan::mcmc::covar_adaptation adapter_2(n);
+  adapter_1.set_window_params(num_warmup, init_buffer, 0,
+                              num_warmup - init_buffer, writer);
+  adapter_2.set_window_params(num_warmup, init_buffer, 0,
+                              num_warmup - init_buffer, writer);
+  adapter_1.set_pool(&pool);
+  adapter_2.set_pool(&pool);
+
+  for (int i = 0; i < num_warmup; ++i) {
+    adapter_1.learn_covariance(covar_1, Eigen::VectorXd::Zero(n));
+    adapter_2.learn_covariance(covar_2, Eigen::VectorXd::Ones(n));
+  }
+  EXPECT_FALSE(adapter_2.pick_up_pooled_covariance(covar_2));
+
+  EXPECT_TRUE(adapter_1.pick_up_pooled_covariance(covar_1));
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      EXPECT_EQ(covar_2(i, j), covar_1(i, j));
+  EXPECT_FALSE(adapter_1.pick_up_pooled_covariance(covar_1));
+  EXPECT_EQ("", ss.str());
+}
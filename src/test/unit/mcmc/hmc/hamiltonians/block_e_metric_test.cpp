@@ -0,0 +1,247 @@
+#include <boost/random/additive_combine.hpp>
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <stan/mcmc/hmc/hamiltonians/dense_e_metric.hpp>
+#include <stan/mcmc/hmc/hamiltonians/block_e_metric.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/interface_callbacks/writer/noop_writer.hpp>
+#include <stan/io/checkpoint.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+
+namespace {
+
+  // Parameters {0, 3} and {1, 2, 4} form two interleaved blocks
+  void set_test_metric(stan::mcmc::block_e_point& z) {
+    std::vector<std::vector<int> > blocks(2);
+    blocks[0].push_back(3);
+    blocks[0].push_back(0);
+    blocks[1].push_back(1);
+    blocks[1].push_back(4);
+    blocks[1].push_back(2);
+
+    std::vector<Eigen::MatrixXd> mInv(2);
+    mInv[0].resize(2, 2);
+    mInv[0] << 2, 0.8,
+               0.8, 1;
+    mInv[1].resize(3, 3);
+    mInv[1] << 1.5, -0.4, 0.2,
+               -0.4, 0.7, 0.1,
+               0.2, 0.1, 3;
+    z.set_metric(blocks, mInv);
+  }
+
+  Eigen::MatrixXd full_mInv(stan::mcmc::block_e_point& z) {
+    int n = z.q.size();
+    Eigen::MatrixXd mInv = Eigen::MatrixXd::Zero(n, n);
+    for (int b = 0; b < z.num_blocks(); ++b)
+      for (int i = 0; i < z.block_size(b); ++i)
+        for (int j = 0; j < z.block_size(b); ++j)
+          mInv(z.order()(z.block_start(b) + i),
+               z.order()(z.block_start(b) + j)) = z.mInv_block(b)(i, j);
+    return mInv;
+  }
+
+}
+
+TEST(McmcBlockEMetric, sample_p) {
+  rng_t base_rng(0);
+
+  Eigen::VectorXd q(5);
+  q << 5, 1, -2, 0, 3;
+
+  stan::mcmc::mock_model model(q.size());
+
+  stan::mcmc::block_e_metric<stan::mcmc::mock_model, rng_t> metric(model);
+  stan::mcmc::block_e_point z(q.size());
+  set_test_metric(z);
+
+  int n_samples = 1000;
+  double m = 0;
+  double m2 = 0;
+
+  for (int i = 0; i < n_samples; ++i) {
+    metric.sample_p(z, base_rng);
+    double tau = metric.tau(z);
+
+    double delta = tau - m;
+    m += delta / static_cast<double>(i + 1);
+    m2 += delta * (tau - m);
+  }
+
+  double var = m2 / (n_samples + 1.0);
+
+  // Mean within 5sigma of expected value (d / 2)
+  EXPECT_TRUE(std::fabs(m   - 0.5 * q.size()) < 5.0 * sqrt(var));
+
+  // Variance within 10% of expected value (d / 2)
+  EXPECT_TRUE(std::fabs(var - 0.5 * q.size()) < 0.1 * q.size());
+}
+
+TEST(McmcBlockEMetric, sample_p_covariance) {
+  rng_t base_rng(0);
+  int n = 5;
+
+  stan::mcmc::mock_model model(n);
+
+  stan::mcmc::block_e_metric<stan::mcmc::mock_model, rng_t> metric(model);
+  stan::mcmc::block_e_point z(n);
+  set_test_metric(z);
+
+  // Momenta are distributed with covariance equal to the metric
+  int n_samples = 20000;
+  Eigen::MatrixXd covar = Eigen::MatrixXd::Zero(n, n);
+  for (int i = 0; i < n_samples; ++i) {
+    metric.sample_p(z, base_rng);
+    covar += z.p * z.p.transpose();
+  }
+  covar /= n_samples;
+
+  Eigen::MatrixXd product = covar * full_mInv(z);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      EXPECT_NEAR(i == j ? 1 : 0, product(i, j), 0.1);
+}
+
+TEST(McmcBlockEMetric, matches_dense_metric) {
+  int n = 5;
+  stan::mcmc::mock_model model(n);
+
+  stan::mcmc::block_e_metric<stan::mcmc::mock_model, rng_t>
+    block_metric(model);
+  stan::mcmc::dense_e_metric<stan::mcmc::mock_model, rng_t>
+    dense_metric(model);
+
+  stan::mcmc::block_e_point z_block(n);
+  set_test_metric(z_block);
+
+  stan::mcmc::dense_e_point z_dense(n);
+  z_dense.set_mInv(full_mInv(z_block));
+
+  for (int i = 0; i < n; ++i)
+    z_block.p(i) = z_dense.p(i) = 0.3 * i - 1;
+
+  EXPECT_FLOAT_EQ(dense_metric.T(z_dense), block_metric.T(z_block));
+
+  Eigen::VectorXd dense_dtau_dp = dense_metric.dtau_dp(z_dense);
+  Eigen::VectorXd block_dtau_dp = block_metric.dtau_dp(z_block);
+  for (int i = 0; i < n; ++i)
+    EXPECT_FLOAT_EQ(dense_dtau_dp(i), block_dtau_dp(i));
+
+  Eigen::VectorXd full_diag = z_block.mInv_full_diag();
+  for (int i = 0; i < n; ++i)
+    EXPECT_FLOAT_EQ(z_dense.mInv()(i, i), full_diag(i));
+}
+
+TEST(McmcBlockEMetric, gradients) {
+  int n = 5;
+  stan::mcmc::mock_model model(n);
+
+  stan::mcmc::block_e_metric<stan::mcmc::mock_model, rng_t> metric(model);
+  stan::mcmc::block_e_point z(n);
+  set_test_metric(z);
+  z.p.setOnes();
+
+  double epsilon = 1e-6;
+
+  Eigen::VectorXd g = metric.dtau_dp(z);
+
+  for (int i = 0; i < z.p.size(); ++i) {
+
+    double delta = 0;
+
+    z.p(i) += epsilon;
+    delta += metric.tau(z);
+
+    z.p(i) -= 2 * epsilon;
+    delta -= metric.tau(z);
+
+    z.p(i) += epsilon;
+
+    delta /= 2 * epsilon;
+
+    EXPECT_NEAR(delta, g(i), epsilon);
+  }
+}
+
+TEST(McmcBlockEMetric, set_metric) {
+  stan::mcmc::block_e_point z(3);
+  EXPECT_EQ(3, z.num_blocks());
+
+  std::vector<std::vector<int> > blocks(2);
+  blocks[0].push_back(0);
+  blocks[0].push_back(2);
+  blocks[1].push_back(1);
+  std::vector<Eigen::MatrixXd> mInv(2);
+  mInv[0] = Eigen::MatrixXd::Identity(2, 2);
+  mInv[1] = Eigen::MatrixXd::Identity(1, 1);
+  EXPECT_NO_THROW(z.set_metric(blocks, mInv));
+  EXPECT_EQ(2, z.num_blocks());
+  EXPECT_TRUE(blocks == z.blocks());
+
+  // Not positive definite
+  mInv[0](0, 1) = mInv[0](1, 0) = 2;
+  EXPECT_THROW(z.set_metric(blocks, mInv), std::invalid_argument);
+  mInv[0] = Eigen::MatrixXd::Identity(2, 2);
+
+  // Parameter 1 in two blocks
+  blocks[0][1] = 1;
+  EXPECT_THROW(z.set_metric(blocks, mInv), std::invalid_argument);
+
+  // Parameter 2 in no block
+  blocks[0].pop_back();
+  mInv[0] = Eigen::MatrixXd::Identity(1, 1);
+  EXPECT_THROW(z.set_metric(blocks, mInv), std::invalid_argument);
+
+  // A failed update leaves the metric as it was
+  EXPECT_EQ(2, z.num_blocks());
+  EXPECT_EQ(2, z.block_size(0));
+}
+
+TEST(McmcBlockEMetric, save_load_state) {
+  stan::mcmc::block_e_point z(5);
+  set_test_metric(z);
+
+  std::stringstream state;
+  {
+    stan::io::checkpoint_writer checkpoint(state);
+    z.save_state(checkpoint);
+  }
+
+  stan::mcmc::block_e_point z_loaded(5);
+  stan::io::checkpoint_reader checkpoint(state);
+  z_loaded.load_state(checkpoint);
+
+  EXPECT_TRUE(z.blocks() == z_loaded.blocks());
+  for (int b = 0; b < z.num_blocks(); ++b) {
+    EXPECT_TRUE(z.mInv_block(b) == z_loaded.mInv_block(b));
+    EXPECT_TRUE(z.mInv_L_block(b) == z_loaded.mInv_L_block(b));
+  }
+}
+
+TEST(McmcBlockEMetric, streams) {
+  stan::test::capture_std_streams();
+
+  rng_t base_rng(0);
+
+  Eigen::VectorXd q(2);
+  q(0) = 5;
+  q(1) = 1;
+
+
+  stan::mcmc::mock_model model(q.size());
+  stan::interface_callbacks::writer::noop_writer writer;
+
+  // typedef to use within Google Test macros
+  typedef stan::mcmc::block_e_metric<stan::mcmc::mock_model, rng_t> block_e;
+
+  EXPECT_NO_THROW(block_e metric(model));
+
+  stan::test::reset_std_streams();
+  EXPECT_EQ("", stan::test::cout_ss.str());
+  EXPECT_EQ("", stan::test::cerr_ss.str());
+}
@@ -6,6 +6,7 @@
 #include <test/test-models/good/mcmc/hmc/hamiltonians/funnel.hpp>
 #include <stan/interface_callbacks/writer/stream_writer.hpp>
 #include <stan/interface_callbacks/writer/noop_writer.hpp>
+#include <stan/io/checkpoint.hpp>
 #include <test/unit/util.hpp>
 #include <gtest/gtest.h>
 
@@ -45,6 +46,51 @@ TEST(McmcDenseEMetric, sample_p) {
   EXPECT_TRUE(std::fabs(var - 0.5 * q.size()) < 0.1 * q.size());
 }
 
+TEST(McmcDenseEMetric, sample_p_cached_factor) {
+  rng_t base_rng(0);
+  int n = 3;
+
+  stan::mcmc::mock_model model(n);
+
+  stan::mcmc::dense_e_metric<stan::mcmc::mock_model, rng_t> metric(model);
+  stan::mcmc::dense_e_point z(n);
+  Eigen::MatrixXd mInv(n, n);
+  mInv << 2, 0.5, 0.1,
+          0.5, 1, -0.3,
+          0.1, -0.3, 0.8;
+  z.set_mInv(mInv);
+  EXPECT_TRUE(mInv == z.mInv());
+  EXPECT_TRUE(mInv.isApprox(z.mInv_L() * z.mInv_L().transpose()));
+
+  // Momenta are distributed with covariance equal to the metric
+  int n_samples = 20000;
+  Eigen::MatrixXd covar = Eigen::MatrixXd::Zero(n, n);
+  for (int i = 0; i < n_samples; ++i) {
+    metric.sample_p(z, base_rng);
+    covar += z.p * z.p.transpose();
+  }
+  covar /= n_samples;
+
+  Eigen::MatrixXd product = covar * z.mInv();
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      EXPECT_NEAR(i == j ? 1 : 0, product(i, j), 0.1);
+
+  // Copies and checkpoints carry the factor along
+  stan::mcmc::dense_e_point z_copy(z);
+  EXPECT_TRUE(z.mInv_L() == z_copy.mInv_L());
+
+  std::stringstream state;
+  {
+    stan::io::checkpoint_writer checkpoint(state);
+    z.save_state(checkpoint);
+  }
+  stan::mcmc::dense_e_point z_loaded(n);
+  stan::io::checkpoint_reader checkpoint(state);
+  z_loaded.load_state(checkpoint);
+  EXPECT_TRUE(z.mInv_L() == z_loaded.mInv_L());
+}
+
 TEST(McmcDenseEMetric, gradients) {
   rng_t base_rng(0);
 
@@ -0,0 +1,309 @@
+#include <stan/io/dump.hpp>
+#include <stan/io/checkpoint.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lanczos_softabs_metric.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/interface_callbacks/writer/noop_writer.hpp>
+
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <test/test-models/good/mcmc/hmc/hamiltonians/funnel.hpp>
+#include <test/unit/util.hpp>
+
+#include <boost/random/additive_combine.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+typedef boost::ecuyer1988 rng_t;
+
+namespace {
+
+  // Two Ritz pairs in five dimensions, the rest of the space taking
+  // the SoftAbs of a zero eigenvalue
+  void set_test_metric(stan::mcmc::lanczos_softabs_point& z) {
+    Eigen::MatrixXd B(5, 2);
+    B << 1, 0,
+         1, 1,
+         0, 1,
+         -1, 2,
+         0.5, 0;
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(B);
+    z.subspace = qr.householderQ() * Eigen::MatrixXd::Identity(5, 2);
+    z.basis = z.subspace;
+    z.lambda.resize(2);
+    z.lambda << -4, 9;
+    z.softabs_lambda = z.lambda.cwiseAbs();
+    z.softabs_lambda_inv = z.softabs_lambda.cwiseInverse();
+    z.softabs_zero = 1.0 / z.alpha;
+    z.log_det_metric = std::log(36.0) + 3 * std::log(z.softabs_zero);
+    z.pseudo_j = Eigen::MatrixXd::Identity(2, 2);
+  }
+
+}
+
+TEST(McmcLanczosSoftAbs, sample_p) {
+  rng_t base_rng(0);
+
+  Eigen::VectorXd q(2);
+  q(0) = 5;
+  q(1) = 1;
+
+  stan::mcmc::mock_model model(q.size());
+  stan::mcmc::lanczos_softabs_metric<stan::mcmc::mock_model, rng_t>
+    metric(model);
+  stan::mcmc::lanczos_softabs_point z(q.size());
+
+  int n_samples = 1000;
+  double m = 0;
+  double m2 = 0;
+
+  std::stringstream model_output, metric_output;
+  stan::interface_callbacks::writer::stream_writer writer(metric_output);
+
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  metric.update_metric(z, writer, error_writer);
+
+  for (int i = 0; i < n_samples; ++i) {
+    metric.sample_p(z, base_rng);
+    double tau = metric.tau(z);
+
+    double delta = tau - m;
+    m += delta / static_cast<double>(i + 1);
+    m2 += delta * (tau - m);
+  }
+
+  double var = m2 / (n_samples + 1.0);
+
+  // Mean within 5sigma of expected value (d / 2)
+  EXPECT_TRUE(std::fabs(m   - 0.5 * q.size()) < 5.0 * sqrt(var));
+
+  // Variance within 10% of expected value (d / 2)
+  EXPECT_TRUE(std::fabs(var - 0.5 * q.size()) < 0.1 * q.size());
+
+  EXPECT_EQ("", metric_output.str());
+}
+
+TEST(McmcLanczosSoftAbs, sample_p_covariance) {
+  rng_t base_rng(0);
+  int n = 5;
+
+  stan::mcmc::mock_model model(n);
+  stan::mcmc::lanczos_softabs_metric<stan::mcmc::mock_model, rng_t>
+    metric(model);
+  stan::mcmc::lanczos_softabs_point z(n);
+  z.alpha = 2;
+  set_test_metric(z);
+
+  // Momenta are distributed with covariance equal to the metric
+  int n_samples = 20000;
+  Eigen::MatrixXd covar = Eigen::MatrixXd::Zero(n, n);
+  for (int i = 0; i < n_samples; ++i) {
+    metric.sample_p(z, base_rng);
+    covar += z.p * z.p.transpose();
+  }
+  covar /= n_samples;
+
+  Eigen::MatrixXd projection = z.basis * z.basis.transpose();
+  Eigen::MatrixXd metric_inv
+    = z.basis * z.softabs_lambda_inv.asDiagonal() * z.basis.transpose()
+      + (Eigen::MatrixXd::Identity(n, n) - projection) / z.softabs_zero;
+  Eigen::MatrixXd product = covar * metric_inv;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      EXPECT_NEAR(i == j ? 1 : 0, product(i, j), 0.1);
+
+  // tau is the quadratic form of the inverse metric
+  EXPECT_FLOAT_EQ(0.5 * z.p.dot(metric_inv * z.p), metric.tau(z));
+}
+
+namespace {
+
+  // Checks the gradients of the metric against finite differences
+  // on the funnel with the specified number of Lanczos steps
+  void check_gradients(int max_rank) {
+    Eigen::VectorXd q = Eigen::VectorXd::Ones(11);
+
+    stan::mcmc::lanczos_softabs_point z(q.size());
+    z.max_rank = max_rank;
+    z.q = q;
+    z.p.setOnes();
+
+    std::fstream data_stream(std::string("").c_str(), std::fstream::in);
+    stan::io::dump data_var_context(data_stream);
+    data_stream.close();
+
+    std::stringstream model_output, metric_output;
+    stan::interface_callbacks::writer::stream_writer writer(metric_output);
+
+    std::stringstream error_stream;
+    stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+    funnel_model_namespace::funnel_model model(data_var_context, &model_output);
+
+    stan::mcmc::lanczos_softabs_metric<funnel_model_namespace::funnel_model,
+                                       rng_t> metric(model);
+
+    double epsilon = 1e-6;
+
+    metric.init(z, writer, error_writer);
+    EXPECT_LE(z.rank(), max_rank);
+    Eigen::VectorXd g1 = metric.dtau_dq(z, writer, error_writer);
+
+    for (int i = 0; i < z.q.size(); ++i) {
+
+      double delta = 0;
+
+      z.q(i) += epsilon;
+      metric.init(z, writer, error_writer);
+      delta += metric.tau(z);
+
+      z.q(i) -= 2 * epsilon;
+      metric.init(z, writer, error_writer);
+      delta -= metric.tau(z);
+
+      z.q(i) += epsilon;
+
+      delta /= 2 * epsilon;
+
+      EXPECT_NEAR(delta, g1(i), epsilon);
+    }
+
+    metric.init(z, writer, error_writer);
+    Eigen::VectorXd g2 = metric.dtau_dp(z);
+
+    for (int i = 0; i < z.q.size(); ++i) {
+
+      double delta = 0;
+
+      z.p(i) += epsilon;
+      delta += metric.tau(z);
+
+      z.p(i) -= 2 * epsilon;
+      delta -= metric.tau(z);
+
+      z.p(i) += epsilon;
+
+      delta /= 2 * epsilon;
+
+      EXPECT_NEAR(delta, g2(i), epsilon);
+    }
+
+    Eigen::VectorXd g3 = metric.dphi_dq(z, writer, error_writer);
+
+    for (int i = 0; i < z.q.size(); ++i) {
+      double delta = 0;
+
+      z.q(i) += epsilon;
+      metric.init(z, writer, error_writer);
+      delta += metric.phi(z);
+
+      z.q(i) -= 2 * epsilon;
+      metric.init(z, writer, error_writer);
+      delta -= metric.phi(z);
+
+      z.q(i) += epsilon;
+
+      delta /= 2 * epsilon;
+
+      EXPECT_NEAR(delta, g3(i), epsilon);
+    }
+
+    EXPECT_EQ("", model_output.str());
+    EXPECT_EQ("", metric_output.str());
+    EXPECT_EQ("", error_stream.str());
+  }
+
+}
+
+// The subspace is kept as the position moves, so the gradients are
+// exact for the truncated metric as well as for the full one
+TEST(McmcLanczosSoftAbs, gradients) {
+  check_gradients(11);
+}
+
+TEST(McmcLanczosSoftAbs, gradients_truncated) {
+  check_gradients(2);
+}
+
+TEST(McmcLanczosSoftAbs, subspace_kept) {
+  Eigen::VectorXd q = Eigen::VectorXd::Ones(11);
+
+  std::fstream data_stream(std::string("").c_str(), std::fstream::in);
+  stan::io::dump data_var_context(data_stream);
+  data_stream.close();
+
+  std::stringstream model_output;
+  stan::interface_callbacks::writer::noop_writer writer;
+  funnel_model_namespace::funnel_model model(data_var_context, &model_output);
+  stan::mcmc::lanczos_softabs_metric<funnel_model_namespace::funnel_model,
+                                     rng_t> metric(model);
+
+  stan::mcmc::lanczos_softabs_point z(q.size());
+  z.max_rank = 3;
+  z.q = q;
+  metric.init(z, writer, writer);
+  Eigen::MatrixXd subspace = z.subspace;
+  Eigen::MatrixXd basis = z.basis;
+  EXPECT_EQ(3, subspace.cols());
+
+  z.q(0) = -1;
+  z.q(4) = 2;
+  metric.init(z, writer, writer);
+  EXPECT_TRUE(subspace == z.subspace);
+  EXPECT_FALSE(basis == z.basis);
+
+  z.clear_subspace();
+  EXPECT_EQ(0, z.subspace.cols());
+  metric.init(z, writer, writer);
+  EXPECT_EQ(3, z.subspace.cols());
+  EXPECT_FALSE(subspace == z.subspace);
+}
+
+TEST(McmcLanczosSoftAbs, save_load_state) {
+  stan::mcmc::lanczos_softabs_point z(5);
+  set_test_metric(z);
+  z.max_rank = 3;
+
+  std::stringstream state;
+  {
+    stan::io::checkpoint_writer checkpoint(state);
+    z.save_state(checkpoint);
+  }
+
+  stan::mcmc::lanczos_softabs_point z_loaded(5);
+  stan::io::checkpoint_reader checkpoint(state);
+  z_loaded.load_state(checkpoint);
+
+  EXPECT_EQ(3, z_loaded.max_rank);
+  EXPECT_EQ(2, z_loaded.rank());
+  EXPECT_TRUE(z.subspace == z_loaded.subspace);
+  EXPECT_TRUE(z.basis == z_loaded.basis);
+  EXPECT_TRUE(z.lambda == z_loaded.lambda);
+  EXPECT_TRUE(z.softabs_lambda == z_loaded.softabs_lambda);
+  EXPECT_TRUE(z.pseudo_j == z_loaded.pseudo_j);
+  EXPECT_EQ(z.log_det_metric, z_loaded.log_det_metric);
+}
+
+TEST(McmcLanczosSoftAbs, streams) {
+  stan::test::capture_std_streams();
+  rng_t base_rng(0);
+
+  Eigen::VectorXd q(2);
+  q(0) = 5;
+  q(1) = 1;
+  stan::mcmc::mock_model model(q.size());
+
+  // for use in Google Test macros below
+  typedef stan::mcmc::lanczos_softabs_metric<stan::mcmc::mock_model, rng_t>
+    lanczos_softabs;
+
+  EXPECT_NO_THROW(lanczos_softabs metric(model));
+
+  stan::test::reset_std_streams();
+  EXPECT_EQ("", stan::test::cout_ss.str());
+  EXPECT_EQ("", stan::test::cerr_ss.str());
+}
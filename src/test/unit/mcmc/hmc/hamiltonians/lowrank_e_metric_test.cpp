@@ -0,0 +1,219 @@
+#include <boost/random/additive_combine.hpp>
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <stan/mcmc/hmc/hamiltonians/dense_e_metric.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_metric.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/interface_callbacks/writer/noop_writer.hpp>
+#include <stan/io/checkpoint.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+typedef boost::ecuyer1988 rng_t;
+
+namespace {
+
+  void set_test_metric(stan::mcmc::lowrank_e_point& z) {
+    int n = z.q.size();
+    Eigen::VectorXd diag(n);
+    Eigen::MatrixXd factor(n, 2);
+    for (int i = 0; i < n; ++i) {
+      diag(i) = 0.5 + i;
+      factor(i, 0) = 1.0;
+      factor(i, 1) = (i % 2 == 0) ? 2.0 : -0.5;
+    }
+    z.set_metric(diag, factor);
+  }
+
+}
+
+TEST(McmcLowrankEMetric, sample_p) {
+  rng_t base_rng(0);
+
+  Eigen::VectorXd q(4);
+  q << 5, 1, -2, 0;
+
+  stan::mcmc::mock_model model(q.size());
+
+  stan::mcmc::lowrank_e_metric<stan::mcmc::mock_model, rng_t> metric(model);
+  stan::mcmc::lowrank_e_point z(q.size());
+  set_test_metric(z);
+
+  int n_samples = 1000;
+  double m = 0;
+  double m2 = 0;
+
+  for (int i = 0; i < n_samples; ++i) {
+    metric.sample_p(z, base_rng);
+    double tau = metric.tau(z);
+
+    double delta = tau - m;
+    m += delta / static_cast<double>(i + 1);
+    m2 += delta * (tau - m);
+  }
+
+  double var = m2 / (n_samples + 1.0);
+
+  // Mean within 5sigma of expected value (d / 2)
+  EXPECT_TRUE(std::fabs(m   - 0.5 * q.size()) < 5.0 * sqrt(var));
+
+  // Variance within 10% of expected value (d / 2)
+  EXPECT_TRUE(std::fabs(var - 0.5 * q.size()) < 0.1 * q.size());
+}
+
+TEST(McmcLowrankEMetric, sample_p_covariance) {
+  rng_t base_rng(0);
+  int n = 3;
+
+  stan::mcmc::mock_model model(n);
+
+  stan::mcmc::lowrank_e_metric<stan::mcmc::mock_model, rng_t> metric(model);
+  stan::mcmc::lowrank_e_point z(n);
+  set_test_metric(z);
+
+  Eigen::MatrixXd mInv = Eigen::MatrixXd(z.mInv_diag().asDiagonal())
+    + z.mInv_factor() * z.mInv_factor().transpose();
+
+  // Momenta are distributed with covariance equal to the metric
+  int n_samples = 20000;
+  Eigen::MatrixXd covar = Eigen::MatrixXd::Zero(n, n);
+  for (int i = 0; i < n_samples; ++i) {
+    metric.sample_p(z, base_rng);
+    covar += z.p * z.p.transpose();
+  }
+  covar /= n_samples;
+
+  Eigen::MatrixXd product = covar * mInv;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      EXPECT_NEAR(i == j ? 1 : 0, product(i, j), 0.1);
+}
+
+TEST(McmcLowrankEMetric, matches_dense_metric) {
+  int n = 5;
+  stan::mcmc::mock_model model(n);
+
+  stan::mcmc::lowrank_e_metric<stan::mcmc::mock_model, rng_t>
+    lowrank_metric(model);
+  stan::mcmc::dense_e_metric<stan::mcmc::mock_model, rng_t>
+    dense_metric(model);
+
+  stan::mcmc::lowrank_e_point z_lowrank(n);
+  set_test_metric(z_lowrank);
+
+  stan::mcmc::dense_e_point z_dense(n);
+  z_dense.set_mInv(Eigen::MatrixXd(z_lowrank.mInv_diag().asDiagonal())
+                   + z_lowrank.mInv_factor()
+                   * z_lowrank.mInv_factor().transpose());
+
+  for (int i = 0; i < n; ++i)
+    z_lowrank.p(i) = z_dense.p(i) = 0.3 * i - 1;
+
+  EXPECT_FLOAT_EQ(dense_metric.T(z_dense), lowrank_metric.T(z_lowrank));
+
+  Eigen::VectorXd dense_dtau_dp = dense_metric.dtau_dp(z_dense);
+  Eigen::VectorXd lowrank_dtau_dp = lowrank_metric.dtau_dp(z_lowrank);
+  for (int i = 0; i < n; ++i)
+    EXPECT_FLOAT_EQ(dense_dtau_dp(i), lowrank_dtau_dp(i));
+
+  Eigen::VectorXd full_diag = z_lowrank.mInv_full_diag();
+  for (int i = 0; i < n; ++i)
+    EXPECT_FLOAT_EQ(z_dense.mInv()(i, i), full_diag(i));
+}
+
+TEST(McmcLowrankEMetric, gradients) {
+  int n = 3;
+  stan::mcmc::mock_model model(n);
+
+  stan::mcmc::lowrank_e_metric<stan::mcmc::mock_model, rng_t> metric(model);
+  stan::mcmc::lowrank_e_point z(n);
+  set_test_metric(z);
+  z.p.setOnes();
+
+  double epsilon = 1e-6;
+
+  Eigen::VectorXd g = metric.dtau_dp(z);
+
+  for (int i = 0; i < z.p.size(); ++i) {
+
+    double delta = 0;
+
+    z.p(i) += epsilon;
+    delta += metric.tau(z);
+
+    z.p(i) -= 2 * epsilon;
+    delta -= metric.tau(z);
+
+    z.p(i) += epsilon;
+
+    delta /= 2 * epsilon;
+
+    EXPECT_NEAR(delta, g(i), epsilon);
+  }
+}
+
+TEST(McmcLowrankEMetric, set_metric) {
+  stan::mcmc::lowrank_e_point z(3);
+  EXPECT_EQ(0, z.rank());
+
+  EXPECT_THROW(z.set_metric(Eigen::VectorXd::Ones(2),
+                            Eigen::MatrixXd::Zero(3, 1)),
+               std::invalid_argument);
+  EXPECT_THROW(z.set_metric(Eigen::VectorXd::Ones(3),
+                            Eigen::MatrixXd::Zero(2, 1)),
+               std::invalid_argument);
+  EXPECT_THROW(z.set_metric(Eigen::VectorXd::Zero(3),
+                            Eigen::MatrixXd::Zero(3, 1)),
+               std::invalid_argument);
+
+  // A zero column contributes nothing to the metric
+  EXPECT_NO_THROW(z.set_metric(Eigen::VectorXd::Ones(3),
+                               Eigen::MatrixXd::Zero(3, 1)));
+  EXPECT_EQ(1, z.rank());
+  EXPECT_FLOAT_EQ(0, z.sample_scale()(0));
+}
+
+TEST(McmcLowrankEMetric, save_load_state) {
+  stan::mcmc::lowrank_e_point z(4);
+  set_test_metric(z);
+
+  std::stringstream state;
+  {
+    stan::io::checkpoint_writer checkpoint(state);
+    z.save_state(checkpoint);
+  }
+
+  stan::mcmc::lowrank_e_point z_loaded(4);
+  stan::io::checkpoint_reader checkpoint(state);
+  z_loaded.load_state(checkpoint);
+
+  EXPECT_EQ(z.rank(), z_loaded.rank());
+  EXPECT_TRUE(z.mInv_diag() == z_loaded.mInv_diag());
+  EXPECT_TRUE(z.mInv_factor() == z_loaded.mInv_factor());
+  EXPECT_TRUE(z.sample_basis() == z_loaded.sample_basis());
+}
+
+TEST(McmcLowrankEMetric, streams) {
+  stan::test::capture_std_streams();
+
+  rng_t base_rng(0);
+
+  Eigen::VectorXd q(2);
+  q(0) = 5;
+  q(1) = 1;
+
+
+  stan::mcmc::mock_model model(q.size());
+  stan::interface_callbacks::writer::noop_writer writer;
+
+  // typedef to use within Google Test macros
+  typedef stan::mcmc::lowrank_e_metric<stan::mcmc::mock_model, rng_t>
+    lowrank_e;
+
+  EXPECT_NO_THROW(lowrank_e metric(model));
+
+  stan::test::reset_std_streams();
+  EXPECT_EQ("", stan::test::cout_ss.str());
+  EXPECT_EQ("", stan::test::cerr_ss.str());
+}
@@ -59,6 +59,39 @@ namespace stan {
       ps_point_test::fast_matrix_copy();
     }
 
+    TEST(psPoint, swap) {
+      ps_point z1(3);
+      z1.q << 1, 2, 3;
+      z1.p << 4, 5, 6;
+      z1.g << 7, 8, 9;
+      z1.V = -1;
+
+      ps_point z2(3);
+      z2.q << -1, -2, -3;
+      z2.p << -4, -5, -6;
+      z2.g << -7, -8, -9;
+      z2.V = 1;
+
+      const double* q1_data = z1.q.data();
+      const double* q2_data = z2.q.data();
+
+      z1.swap(z2);
+
+      EXPECT_EQ(q2_data, z1.q.data());
+      EXPECT_EQ(q1_data, z2.q.data());
+
+      for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(-(i + 1), z1.q(i));
+        EXPECT_EQ(-(i + 4), z1.p(i));
+        EXPECT_EQ(-(i + 7), z1.g(i));
+        EXPECT_EQ(i + 1, z2.q(i));
+        EXPECT_EQ(i + 4, z2.p(i));
+        EXPECT_EQ(i + 7, z2.g(i));
+      }
+      EXPECT_EQ(1, z1.V);
+      EXPECT_EQ(-1, z2.V);
+    }
+
     TEST(psPoint, write_metric_streams) {
       stan::test::capture_std_streams();
 
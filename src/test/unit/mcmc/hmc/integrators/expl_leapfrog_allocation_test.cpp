@@ -0,0 +1,132 @@
+// Every Eigen heap allocation made while allocations are disallowed
+// trips eigen_assert, which is redirected here to a counter.
+#define EIGEN_RUNTIME_NO_MALLOC
+static int eigen_malloc_count = 0;
+#define eigen_assert(x) do { if (!(x)) ++eigen_malloc_count; } while (false)
+
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/mcmc/hmc/integrators/expl_leapfrog.hpp>
+#include <stan/mcmc/hmc/integrators/expl_two_stage.hpp>
+#include <stan/mcmc/hmc/hamiltonians/unit_e_metric.hpp>
+#include <stan/mcmc/hmc/hamiltonians/diag_e_metric.hpp>
+#include <stan/mcmc/hmc/hamiltonians/dense_e_metric.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_metric.hpp>
+#include <stan/mcmc/hmc/hamiltonians/block_e_metric.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+
+namespace stan {
+  namespace mcmc {
+
+    // Standard normal potential evaluated in closed form, so that the
+    // only work left in a step is the metric's and the integrator's.
+    template <template <class, class> class Metric>
+    class analytic_gauss : public Metric<mock_model, rng_t> {
+    public:
+      explicit analytic_gauss(const mock_model& model)
+        : Metric<mock_model, rng_t>(model) {}
+
+      void update_potential_gradient(
+        typename Metric<mock_model, rng_t>::PointType& z,
+        interface_callbacks::writer::base_writer& info_writer,
+        interface_callbacks::writer::base_writer& error_writer) {
+        z.V = 0.5 * z.q.squaredNorm();
+        z.g = z.q;
+      }
+    };
+
+  }
+}
+
+// Takes one step to size the buffers, then checks that further steps,
+// the Hamiltonian and the sharp momentum do not allocate.
+template <template <class> class Integrator, class Hamiltonian>
+void expect_allocation_free_steps(Hamiltonian& metric,
+                                  typename Hamiltonian::PointType& z) {
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  Integrator<Hamiltonian> integrator;
+
+  z.q.setLinSpaced(1, 2);
+  z.p.setLinSpaced(-1, 1);
+  metric.update_potential_gradient(z, writer, error_writer);
+  integrator.evolve(z, metric, 0.1, writer, error_writer);
+  metric.H(z);
+  Eigen::VectorXd p_sharp(z.p.size());
+
+  eigen_malloc_count = 0;
+  Eigen::internal::set_is_malloc_allowed(false);
+  for (int n = 0; n < 10; ++n)
+    integrator.evolve(z, metric, 0.1, writer, error_writer);
+  double H = metric.H(z);
+  metric.dtau_dp_into(z, p_sharp);
+  Eigen::internal::set_is_malloc_allowed(true);
+
+  EXPECT_EQ(0, eigen_malloc_count);
+  EXPECT_FALSE(H != H);
+  EXPECT_FLOAT_EQ(0.5 * z.p.dot(p_sharp), metric.T(z));
+  EXPECT_EQ("", output_stream.str());
+  EXPECT_EQ("", error_stream.str());
+}
+
+template <template <class> class Integrator>
+void expect_allocation_free_metrics() {
+  stan::mcmc::mock_model model(3);
+
+  stan::mcmc::analytic_gauss<stan::mcmc::unit_e_metric> unit_e(model);
+  stan::mcmc::unit_e_point z_unit(3);
+  expect_allocation_free_steps<Integrator>(unit_e, z_unit);
+
+  stan::mcmc::analytic_gauss<stan::mcmc::diag_e_metric> diag_e(model);
+  stan::mcmc::diag_e_point z_diag(3);
+  z_diag.mInv << 0.5, 1, 2;
+  expect_allocation_free_steps<Integrator>(diag_e, z_diag);
+
+  stan::mcmc::analytic_gauss<stan::mcmc::dense_e_metric> dense_e(model);
+  stan::mcmc::dense_e_point z_dense(3);
+  Eigen::MatrixXd mInv_dense(3, 3);
+  mInv_dense << 2, 0.5, 0,
+                0.5, 1, 0.25,
+                0, 0.25, 1.5;
+  z_dense.set_mInv(mInv_dense);
+  expect_allocation_free_steps<Integrator>(dense_e, z_dense);
+
+  stan::mcmc::analytic_gauss<stan::mcmc::lowrank_e_metric> lowrank_e(model);
+  stan::mcmc::lowrank_e_point z_lowrank(3);
+  Eigen::MatrixXd factor(3, 2);
+  factor << 1, 0,
+            0.5, 0.5,
+            0, 1;
+  z_lowrank.set_metric(Eigen::VectorXd::Constant(3, 0.5), factor);
+  expect_allocation_free_steps<Integrator>(lowrank_e, z_lowrank);
+
+  stan::mcmc::analytic_gauss<stan::mcmc::block_e_metric> block_e(model);
+  stan::mcmc::block_e_point z_block(3);
+  std::vector<std::vector<int> > blocks(2);
+  blocks[0].push_back(2);
+  blocks[0].push_back(0);
+  blocks[1].push_back(1);
+  std::vector<Eigen::MatrixXd> mInv(2);
+  mInv[0].resize(2, 2);
+  mInv[0] << 1, 0.5,
+             0.5, 2;
+  mInv[1] = Eigen::MatrixXd::Constant(1, 1, 3);
+  z_block.set_metric(blocks, mInv);
+  expect_allocation_free_steps<Integrator>(block_e, z_block);
+}
+
+TEST(McmcHmcIntegratorsExplLeapfrog, step_does_not_allocate) {
+  expect_allocation_free_metrics<stan::mcmc::expl_leapfrog>();
+}
+
+TEST(McmcHmcIntegratorsExplTwoStage, step_does_not_allocate) {
+  expect_allocation_free_metrics<stan::mcmc::expl_two_stage>();
+}
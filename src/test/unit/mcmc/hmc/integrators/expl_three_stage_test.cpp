@@ -0,0 +1,162 @@
+#include <stan/mcmc/hmc/integrators/expl_three_stage.hpp>
+#include <stan/mcmc/hmc/integrators/expl_leapfrog.hpp>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <test/test-models/good/mcmc/hmc/integrators/gauss.hpp>
+#include <test/test-models/good/mcmc/hmc/common/gauss3D.hpp>
+
+#include <stan/io/dump.hpp>
+
+#include <stan/mcmc/hmc/hamiltonians/unit_e_metric.hpp>
+#include <stan/mcmc/hmc/hamiltonians/diag_e_metric.hpp>
+#include <boost/random/additive_combine.hpp> // L'Ecuyer RNG
+
+typedef boost::ecuyer1988 rng_t;
+
+TEST(McmcHmcIntegratorsExplThreeStage, energy_conservation) {
+  std::fstream data_stream(std::string("").c_str(), std::fstream::in);
+  stan::io::dump data_var_context(data_stream);
+  data_stream.close();
+
+  std::stringstream model_output;
+  std::stringstream metric_output;
+  stan::interface_callbacks::writer::stream_writer writer(metric_output);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  gauss_model_namespace::gauss_model model(data_var_context, &model_output);
+
+  stan::mcmc::expl_three_stage<
+    stan::mcmc::unit_e_metric<gauss_model_namespace::gauss_model, rng_t> >
+    integrator;
+
+  stan::mcmc::unit_e_metric<gauss_model_namespace::gauss_model, rng_t> metric(model);
+
+  EXPECT_EQ(3, integrator.num_stages());
+
+  stan::mcmc::unit_e_point z(1);
+  z.q(0) = 1;
+  z.p(0) = 1;
+
+  metric.init(z, writer, error_writer);
+  double H0 = metric.H(z);
+  double aveDeltaH = 0;
+
+  double epsilon = 1e-3;
+  double tau = 6.28318530717959;
+  size_t L = tau / epsilon;
+
+  for (size_t n = 0; n < L; ++n) {
+    integrator.evolve(z, metric, epsilon, writer, error_writer);
+
+    double deltaH = metric.H(z) - H0;
+    aveDeltaH += (deltaH - aveDeltaH) / double(n + 1);
+  }
+
+  // Average error in Hamiltonian should be O(epsilon^{2})
+  EXPECT_NEAR(aveDeltaH, 0, epsilon * epsilon);
+
+  EXPECT_EQ("", model_output.str());
+  EXPECT_EQ("", metric_output.str());
+  EXPECT_EQ("", error_stream.str());
+}
+
+TEST(McmcHmcIntegratorsExplThreeStage, reversibility) {
+  std::fstream data_stream(std::string("").c_str(), std::fstream::in);
+  stan::io::dump data_var_context(data_stream);
+  data_stream.close();
+
+  std::stringstream model_output;
+  std::stringstream metric_output;
+  stan::interface_callbacks::writer::stream_writer writer(metric_output);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  gauss3D_model_namespace::gauss3D_model model(data_var_context, &model_output);
+
+  stan::mcmc::expl_three_stage<
+    stan::mcmc::unit_e_metric<gauss3D_model_namespace::gauss3D_model, rng_t> >
+    integrator;
+
+  stan::mcmc::unit_e_metric<gauss3D_model_namespace::gauss3D_model, rng_t>
+    metric(model);
+
+  stan::mcmc::unit_e_point z(3);
+  z.q << 1, -0.5, 0.25;
+  z.p << 0.3, 1.2, -0.7;
+  Eigen::VectorXd q0 = z.q;
+  Eigen::VectorXd p0 = z.p;
+
+  metric.init(z, writer, error_writer);
+
+  double epsilon = 0.4;
+  for (int n = 0; n < 20; ++n)
+    integrator.evolve(z, metric, epsilon, writer, error_writer);
+  z.p = -z.p;
+  for (int n = 0; n < 20; ++n)
+    integrator.evolve(z, metric, epsilon, writer, error_writer);
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(q0(i), z.q(i), 1e-10);
+    EXPECT_NEAR(p0(i), -z.p(i), 1e-10);
+  }
+
+  EXPECT_EQ("", model_output.str());
+  EXPECT_EQ("", metric_output.str());
+  EXPECT_EQ("", error_stream.str());
+}
+
+TEST(McmcHmcIntegratorsExplThreeStage, energy_error_vs_leapfrog) {
+  std::fstream data_stream(std::string("").c_str(), std::fstream::in);
+  stan::io::dump data_var_context(data_stream);
+  data_stream.close();
+
+  std::stringstream model_output;
+  std::stringstream metric_output;
+  stan::interface_callbacks::writer::stream_writer writer(metric_output);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  typedef stan::mcmc::diag_e_metric<gauss3D_model_namespace::gauss3D_model,
+                                    rng_t> metric_t;
+
+  gauss3D_model_namespace::gauss3D_model model(data_var_context, &model_output);
+  metric_t metric(model);
+
+  stan::mcmc::expl_three_stage<metric_t> three_stage;
+  stan::mcmc::expl_leapfrog<metric_t> leapfrog;
+
+  // An ill-matched metric spreads the frequencies over (0.5, 1.5)
+  stan::mcmc::diag_e_point z0(3);
+  z0.mInv << 0.25, 1, 2.25;
+  z0.q << 1, -0.5, 0.25;
+  z0.p << 0.3, 1.2, -0.7;
+  metric.init(z0, writer, error_writer);
+  double H0 = metric.H(z0);
+
+  // Same number of gradients: three leapfrog steps of a third the
+  // size for every three stage step
+  double epsilon = 2.4;
+  double max_three_stage = 0;
+  double max_leapfrog = 0;
+
+  stan::mcmc::diag_e_point z1(z0);
+  stan::mcmc::diag_e_point z2(z0);
+  for (int n = 0; n < 50; ++n) {
+    three_stage.evolve(z1, metric, epsilon, writer, error_writer);
+    max_three_stage = std::max(max_three_stage, std::fabs(metric.H(z1) - H0));
+
+    for (int m = 0; m < 3; ++m)
+      leapfrog.evolve(z2, metric, epsilon / 3, writer, error_writer);
+    max_leapfrog = std::max(max_leapfrog, std::fabs(metric.H(z2) - H0));
+  }
+
+  EXPECT_LT(max_three_stage, 0.5 * max_leapfrog);
+
+  EXPECT_EQ("", model_output.str());
+  EXPECT_EQ("", metric_output.str());
+  EXPECT_EQ("", error_stream.str());
+}
@@ -0,0 +1,137 @@
+// Every Eigen heap allocation made while allocations are disallowed
+// trips eigen_assert, which is redirected here to a counter.
+#define EIGEN_RUNTIME_NO_MALLOC
+static int eigen_malloc_count = 0;
+#define eigen_assert(x) do { if (!(x)) ++eigen_malloc_count; } while (false)
+
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/mcmc/hmc/nuts/base_nuts.hpp>
+#include <stan/mcmc/hmc/nuts_classic/base_nuts_classic.hpp>
+#include <stan/mcmc/hmc/xhmc/base_xhmc.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+
+typedef boost::ecuyer1988 rng_t;
+
+namespace stan {
+  namespace mcmc {
+
+    static int by_value_returns = 0;
+
+    // Mock Hamiltonian that counts the vectors it returns by value,
+    // which the samplers should no longer ask for, and does not touch
+    // the model's gradient.
+    template <typename Model, typename BaseRNG>
+    class counting_hamiltonian
+      : public mock_hamiltonian<Model, BaseRNG> {
+    public:
+      explicit counting_hamiltonian(const Model& model)
+        : mock_hamiltonian<Model, BaseRNG>(model) {}
+
+      double dG_dt(ps_point& z,
+                   interface_callbacks::writer::base_writer& info_writer,
+                   interface_callbacks::writer::base_writer& error_writer) {
+        return 1;
+      }
+
+      Eigen::VectorXd dtau_dp(ps_point& z) {
+        ++by_value_returns;
+        return Eigen::VectorXd::Ones(this->model_.num_params_r());
+      }
+
+      void dtau_dp_into(ps_point& z, Eigen::VectorXd& out) {
+        out.setOnes(this->model_.num_params_r());
+      }
+
+      void init(ps_point& z,
+                interface_callbacks::writer::base_writer& info_writer,
+                interface_callbacks::writer::base_writer& error_writer) {}
+    };
+
+    class counting_nuts
+      : public base_nuts<mock_model, counting_hamiltonian,
+                         mock_integrator, rng_t> {
+    public:
+      counting_nuts(const mock_model& m, rng_t& rng)
+        : base_nuts<mock_model, counting_hamiltonian,
+                    mock_integrator, rng_t>(m, rng) {}
+    };
+
+    class counting_nuts_classic
+      : public base_nuts_classic<mock_model, counting_hamiltonian,
+                                 mock_integrator, rng_t> {
+    public:
+      counting_nuts_classic(const mock_model& m, rng_t& rng)
+        : base_nuts_classic<mock_model, counting_hamiltonian,
+                            mock_integrator, rng_t>(m, rng) {}
+
+      bool compute_criterion(ps_point& start, ps_point& finish,
+                             Eigen::VectorXd& rho) {
+        return true;
+      }
+    };
+
+    class counting_xhmc
+      : public base_xhmc<mock_model, counting_hamiltonian,
+                         mock_integrator, rng_t> {
+    public:
+      counting_xhmc(const mock_model& m, rng_t& rng)
+        : base_xhmc<mock_model, counting_hamiltonian,
+                    mock_integrator, rng_t>(m, rng) {}
+    };
+
+  }
+}
+
+// Runs one transition to warm up the sampler's buffers, then checks
+// that a second transition allocates only for the returned sample.
+template <class Sampler>
+void expect_allocation_free_transition(Sampler& sampler, int model_size) {
+  sampler.set_nominal_stepsize(0.1);
+  sampler.set_stepsize_jitter(0);
+  sampler.sample_stepsize();
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(model_size);
+  stan::mcmc::sample init_sample(q, 0, 0);
+  sampler.z().p.setOnes();
+  sampler.transition(init_sample, writer, error_writer);
+
+  eigen_malloc_count = 0;
+  stan::mcmc::by_value_returns = 0;
+  Eigen::internal::set_is_malloc_allowed(false);
+  sampler.transition(init_sample, writer, error_writer);
+  Eigen::internal::set_is_malloc_allowed(true);
+
+  EXPECT_EQ(0, stan::mcmc::by_value_returns);
+  EXPECT_EQ(1, eigen_malloc_count);
+  EXPECT_EQ("", output_stream.str());
+  EXPECT_EQ("", error_stream.str());
+}
+
+TEST(McmcNutsBaseNuts, transition_reuses_workspace) {
+  rng_t base_rng(0);
+  stan::mcmc::mock_model model(3);
+  stan::mcmc::counting_nuts sampler(model, base_rng);
+  expect_allocation_free_transition(sampler, 3);
+}
+
+TEST(McmcNutsBaseNuts, classic_transition_reuses_workspace) {
+  rng_t base_rng(0);
+  stan::mcmc::mock_model model(3);
+  stan::mcmc::counting_nuts_classic sampler(model, base_rng);
+  expect_allocation_free_transition(sampler, 3);
+}
+
+TEST(McmcNutsBaseNuts, xhmc_transition_reuses_workspace) {
+  rng_t base_rng(0);
+  stan::mcmc::mock_model model(3);
+  stan::mcmc::counting_xhmc sampler(model, base_rng);
+  expect_allocation_free_transition(sampler, 3);
+}
@@ -117,8 +117,8 @@ TEST(McmcNutsDerivedNuts, compute_criterion_dense_e) {
   finish.q(0) = 2;
   finish.p(0) = 1;
 
-  p_sharp_start = start.mInv * start.p;
-  p_sharp_finish = finish.mInv * finish.p;
+  p_sharp_start = start.mInv() * start.p;
+  p_sharp_finish = finish.mInv() * finish.p;
   rho = start.p + finish.p;
 
   EXPECT_TRUE(sampler.compute_criterion(p_sharp_start, p_sharp_finish, rho));
@@ -129,8 +129,8 @@ TEST(McmcNutsDerivedNuts, compute_criterion_dense_e) {
   finish.q(0) = 2;
   finish.p(0) = -1;
 
-  p_sharp_start = start.mInv * start.p;
-  p_sharp_finish = finish.mInv * finish.p;
+  p_sharp_start = start.mInv() * start.p;
+  p_sharp_finish = finish.mInv() * finish.p;
   rho = start.p + finish.p;
 
   EXPECT_FALSE(sampler.compute_criterion(p_sharp_start, p_sharp_finish, rho));
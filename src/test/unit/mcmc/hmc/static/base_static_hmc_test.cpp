@@ -4,6 +4,7 @@
 #include <stan/interface_callbacks/writer/stream_writer.hpp>
 #include <boost/random/additive_combine.hpp>
 #include <gtest/gtest.h>
+#include <string>
 
 typedef boost::ecuyer1988 rng_t;
 
@@ -24,6 +25,114 @@ namespace stan {
 
     };
 
+    static int n_init = 0;
+
+    // Mock Hamiltonian that counts how often it is initialized
+    template <typename Model, typename BaseRNG>
+    class init_counting_hamiltonian
+      : public mock_hamiltonian<Model, BaseRNG> {
+    public:
+      explicit init_counting_hamiltonian(const Model& model)
+        : mock_hamiltonian<Model, BaseRNG>(model) {}
+
+      void init(ps_point& z,
+                interface_callbacks::writer::base_writer& info_writer,
+                interface_callbacks::writer::base_writer& error_writer) {
+        ++n_init;
+        z.V = 0;
+        z.g.setZero();
+      }
+    };
+
+    // Mock Hamiltonian whose state cannot be carried across transitions
+    template <typename Model, typename BaseRNG>
+    class stateless_hamiltonian
+      : public init_counting_hamiltonian<Model, BaseRNG> {
+    public:
+      explicit stateless_hamiltonian(const Model& model)
+        : init_counting_hamiltonian<Model, BaseRNG>(model) {}
+
+      bool reuses_point_state() {
+        return false;
+      }
+    };
+
+    static std::string call_order;
+
+    // Mock Hamiltonian that records the order of init and sample_p
+    template <typename Model, typename BaseRNG>
+    class order_recording_hamiltonian
+      : public mock_hamiltonian<Model, BaseRNG> {
+    public:
+      explicit order_recording_hamiltonian(const Model& model)
+        : mock_hamiltonian<Model, BaseRNG>(model) {}
+
+      void init(ps_point& z,
+                interface_callbacks::writer::base_writer& info_writer,
+                interface_callbacks::writer::base_writer& error_writer) {
+        call_order += "init,";
+        z.V = 0;
+        z.g.setZero();
+      }
+
+      void sample_p(ps_point& z, BaseRNG& rng) {
+        call_order += "sample_p,";
+      }
+
+      bool reuses_point_state() {
+        return false;
+      }
+    };
+
+    // Mock Hamiltonian whose momentum depends on the position
+    template <typename Model, typename BaseRNG>
+    class position_dependent_hamiltonian
+      : public order_recording_hamiltonian<Model, BaseRNG> {
+    public:
+      explicit position_dependent_hamiltonian(const Model& model)
+        : order_recording_hamiltonian<Model, BaseRNG>(model) {}
+
+      bool samples_p_after_init() {
+        return true;
+      }
+    };
+
+    class order_recording_static_hmc
+      : public base_static_hmc<mock_model, order_recording_hamiltonian,
+                               mock_integrator, rng_t> {
+    public:
+      order_recording_static_hmc(const mock_model &m, rng_t& rng)
+        : base_static_hmc<mock_model, order_recording_hamiltonian,
+                          mock_integrator, rng_t>(m, rng) {}
+    };
+
+    class position_dependent_static_hmc
+      : public base_static_hmc<mock_model, position_dependent_hamiltonian,
+                               mock_integrator, rng_t> {
+    public:
+      position_dependent_static_hmc(const mock_model &m, rng_t& rng)
+        : base_static_hmc<mock_model, position_dependent_hamiltonian,
+                          mock_integrator, rng_t>(m, rng) {}
+    };
+
+    class counting_static_hmc
+      : public base_static_hmc<mock_model, init_counting_hamiltonian,
+                               mock_integrator, rng_t> {
+    public:
+      counting_static_hmc(const mock_model &m, rng_t& rng)
+        : base_static_hmc<mock_model, init_counting_hamiltonian,
+                          mock_integrator, rng_t>(m, rng) {}
+    };
+
+    class stateless_static_hmc
+      : public base_static_hmc<mock_model, stateless_hamiltonian,
+                               mock_integrator, rng_t> {
+    public:
+      stateless_static_hmc(const mock_model &m, rng_t& rng)
+        : base_static_hmc<mock_model, stateless_hamiltonian,
+                          mock_integrator, rng_t>(m, rng) {}
+    };
+
   }
 }
 
@@ -123,3 +232,91 @@ TEST(McmcStaticBaseStaticHMC, set_nominal_stepsize_and_L) {
   EXPECT_EQ(old_epsilon, sampler.get_nominal_stepsize());
   EXPECT_EQ(old_L, sampler.get_L());
 }
+
+TEST(McmcStaticBaseStaticHMC, transition_reuses_state) {
+  rng_t base_rng(0);
+
+  stan::mcmc::mock_model model(2);
+  stan::mcmc::counting_static_hmc sampler(model, base_rng);
+  sampler.set_nominal_stepsize_and_L(0.1, 3);
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  stan::mcmc::n_init = 0;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(2);
+  stan::mcmc::sample s(q, 0, 0);
+
+  s = sampler.transition(s, writer, error_writer);
+  EXPECT_EQ(1, stan::mcmc::n_init);
+
+  // Continuing from the returned sample reuses the stored gradient
+  s = sampler.transition(s, writer, error_writer);
+  s = sampler.transition(s, writer, error_writer);
+  EXPECT_EQ(1, stan::mcmc::n_init);
+
+  // A new position is initialized
+  stan::mcmc::sample moved(Eigen::VectorXd::Ones(2), 0, 0);
+  s = sampler.transition(moved, writer, error_writer);
+  EXPECT_EQ(2, stan::mcmc::n_init);
+
+  // Touching the point from outside forces initialization
+  sampler.z();
+  s = sampler.transition(s, writer, error_writer);
+  EXPECT_EQ(3, stan::mcmc::n_init);
+
+  sampler.seed(s.cont_params());
+  s = sampler.transition(s, writer, error_writer);
+  EXPECT_EQ(4, stan::mcmc::n_init);
+
+  EXPECT_EQ("", output_stream.str());
+  EXPECT_EQ("", error_stream.str());
+}
+
+TEST(McmcStaticBaseStaticHMC, transition_without_reusable_state) {
+  rng_t base_rng(0);
+
+  stan::mcmc::mock_model model(2);
+  stan::mcmc::stateless_static_hmc sampler(model, base_rng);
+  sampler.set_nominal_stepsize_and_L(0.1, 3);
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  stan::mcmc::n_init = 0;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(2);
+  stan::mcmc::sample s(q, 0, 0);
+
+  for (int n = 0; n < 3; ++n)
+    s = sampler.transition(s, writer, error_writer);
+  EXPECT_EQ(3, stan::mcmc::n_init);
+}
+
+TEST(McmcStaticBaseStaticHMC, momentum_drawn_before_or_after_init) {
+  rng_t base_rng(0);
+
+  stan::mcmc::mock_model model(2);
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+  stan::mcmc::sample s(Eigen::VectorXd::Zero(2), 0, 0);
+
+  // The momentum is drawn first, as it always was
+  stan::mcmc::order_recording_static_hmc sampler(model, base_rng);
+  sampler.set_nominal_stepsize_and_L(0.1, 3);
+  stan::mcmc::call_order.clear();
+  sampler.transition(s, writer, error_writer);
+  EXPECT_EQ("sample_p,init,", stan::mcmc::call_order);
+
+  // unless the Hamiltonian asks for the metric at the position first
+  stan::mcmc::position_dependent_static_hmc dependent(model, base_rng);
+  dependent.set_nominal_stepsize_and_L(0.1, 3);
+  stan::mcmc::call_order.clear();
+  dependent.transition(s, writer, error_writer);
+  EXPECT_EQ("init,sample_p,", stan::mcmc::call_order);
+}
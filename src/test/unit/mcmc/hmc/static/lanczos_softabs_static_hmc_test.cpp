@@ -0,0 +1,65 @@
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/mcmc/hmc/static/lanczos_softabs_static_hmc.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <test/test-models/good/mcmc/hmc/hamiltonians/quartic.hpp>
+#include <stan/io/dump.hpp>
+#include <fstream>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+typedef boost::ecuyer1988 rng_t;
+
+// Six independent components with density proportional to
+// exp(-x^2 / 2 - x^4 / 4), sampled with a metric truncated to two
+// directions
+TEST(McmcLanczosSoftAbsStaticHMC, truncated_metric_moments) {
+  rng_t base_rng(0);
+
+  std::stringstream output;
+  stan::interface_callbacks::writer::stream_writer writer(output);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  std::fstream empty_stream("", std::fstream::in);
+  stan::io::dump data_var_context(empty_stream);
+  quartic_model_namespace::quartic_model model(data_var_context);
+
+  stan::mcmc::lanczos_softabs_static_hmc<quartic_model_namespace::quartic_model,
+                                         rng_t> sampler(model, base_rng);
+  sampler.z().max_rank = 2;
+  sampler.set_nominal_stepsize_and_T(0.3, 1.5);
+  sampler.set_stepsize_jitter(0.5);
+
+  // Second moment of one component by quadrature
+  double num = 0;
+  double den = 0;
+  for (int k = -8000; k <= 8000; ++k) {
+    double x = 1e-3 * k;
+    double w = std::exp(-0.5 * x * x - 0.25 * x * x * x * x);
+    num += x * x * w;
+    den += w;
+  }
+  double target_m2 = num / den;
+
+  const int n = 6;
+  const int n_transitions = 4000;
+  // Unequal starting values so that the subspace is not invariant
+  // after the first Lanczos step
+  stan::mcmc::sample s(Eigen::VectorXd::LinSpaced(n, -0.7, 0.8), 0, 0);
+  double m1 = 0;
+  double m2 = 0;
+  for (int t = 0; t < n_transitions; ++t) {
+    s = sampler.transition(s, writer, error_writer);
+    m1 += s.cont_params().sum();
+    m2 += s.cont_params().squaredNorm();
+  }
+  m1 /= n * n_transitions;
+  m2 /= n * n_transitions;
+
+  EXPECT_EQ(2, sampler.z().rank());
+  EXPECT_NEAR(0, m1, 0.03);
+  EXPECT_NEAR(target_m2, m2, 0.03);
+  EXPECT_EQ("", output.str());
+  EXPECT_EQ("", error_stream.str());
+}
@@ -0,0 +1,175 @@
+#include <stan/mcmc/lowrank_adaptation.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_point.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+
+TEST(McmcLowrankAdaptation, learn_metric) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 10;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd diag = Eigen::VectorXd::Zero(n);
+  Eigen::MatrixXd factor(n, 0);
+
+  const int n_learn = 10;
+
+  stan::mcmc::lowrank_adaptation adapter(n);
+  adapter.set_window_params(50, 0, 0, n_learn, writer);
+
+  for (int i = 0; i < n_learn - 1; ++i)
+    EXPECT_FALSE(adapter.learn_metric(diag, factor, q));
+  EXPECT_TRUE(adapter.learn_metric(diag, factor, q));
+
+  // Constant draws have no variance to standardize by and so no
+  // correlated directions
+  double target_var = 1.0 * n_learn / (n_learn + 5.0)
+    + 1e-3 * 5.0 / (n_learn + 5.0);
+  for (int i = 0; i < n; ++i)
+    EXPECT_FLOAT_EQ(target_var, diag(i));
+  EXPECT_EQ(n, factor.rows());
+  EXPECT_EQ(0, factor.cols());
+  EXPECT_EQ("", ss.str());
+}
+
+TEST(McmcLowrankAdaptation, recovers_correlated_direction) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 20;
+  const int n_learn = 200;
+
+  boost::ecuyer1988 rng(0);
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<> >
+    rand_gaus(rng, boost::normal_distribution<>());
+
+  // Unit variance in every direction plus variance 25 along u
+  Eigen::VectorXd u = Eigen::VectorXd::Ones(n) / std::sqrt(n);
+
+  stan::mcmc::lowrank_adaptation adapter(n);
+  adapter.set_max_rank(2);
+  adapter.set_num_draws(n_learn);
+  adapter.set_window_params(1000, 0, 0, n_learn, writer);
+
+  Eigen::VectorXd diag(n);
+  Eigen::MatrixXd factor(n, 0);
+  Eigen::VectorXd q(n);
+  bool update = false;
+  for (int i = 0; i < n_learn; ++i) {
+    for (int j = 0; j < n; ++j)
+      q(j) = rand_gaus();
+    q += std::sqrt(24.0) * rand_gaus() * u;
+    update = adapter.learn_metric(diag, factor, q);
+  }
+  ASSERT_TRUE(update);
+  ASSERT_GE(factor.cols(), 1);
+  EXPECT_LE(factor.cols(), 2);
+
+  Eigen::MatrixXd mInv = Eigen::MatrixXd(diag.asDiagonal())
+    + factor * factor.transpose();
+
+  // The strong direction dominates the estimated metric
+  double along_u = u.dot(mInv * u);
+  EXPECT_NEAR(25.0, along_u, 7.5);
+
+  Eigen::VectorXd v = Eigen::VectorXd::Zero(n);
+  v(0) = 1;
+  v(1) = -1;
+  v /= std::sqrt(2.0);
+  EXPECT_LT(v.dot(mInv * v), 5.0);
+}
+
+TEST(McmcLowrankAdaptation, max_rank_zero) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 3;
+  const int n_learn = 10;
+
+  stan::mcmc::lowrank_adaptation adapter(n);
+  adapter.set_max_rank(0);
+  adapter.set_window_params(50, 0, 0, n_learn, writer);
+
+  Eigen::VectorXd diag(n);
+  Eigen::MatrixXd factor(n, 0);
+  for (int i = 0; i < n_learn; ++i)
+    adapter.learn_metric(diag, factor, Eigen::VectorXd::Constant(n, i));
+
+  EXPECT_EQ(0, factor.cols());
+}
+
+TEST(McmcLowrankAdaptation, ignores_noise_with_few_draws) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 500;
+  const int n_learn = 50;
+
+  boost::ecuyer1988 rng(0);
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<> >
+    rand_gaus(rng, boost::normal_distribution<>());
+
+  stan::mcmc::lowrank_adaptation adapter(n);
+  adapter.set_num_draws(n_learn);
+  adapter.set_window_params(1000, 0, 0, n_learn, writer);
+
+  // Independent standard normal draws in many more dimensions than
+  // draws have sample eigenvalues near n / n_learn, none of which is
+  // a correlated direction
+  Eigen::VectorXd diag(n);
+  Eigen::MatrixXd factor(n, 0);
+  Eigen::VectorXd q(n);
+  bool update = false;
+  for (int i = 0; i < n_learn; ++i) {
+    for (int j = 0; j < n; ++j)
+      q(j) = rand_gaus();
+    update = adapter.learn_metric(diag, factor, q);
+  }
+  ASSERT_TRUE(update);
+  EXPECT_EQ(n, factor.rows());
+  EXPECT_EQ(0, factor.cols());
+}
+
+TEST(McmcLowrankAdaptation, full_diagonal_is_sample_variance) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 20;
+  const int n_learn = 200;
+
+  boost::ecuyer1988 rng(1);
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<> >
+    rand_gaus(rng, boost::normal_distribution<>());
+
+  // A common factor with loadings of different sizes
+  Eigen::VectorXd u = Eigen::VectorXd::LinSpaced(n, 1, 3);
+
+  stan::mcmc::lowrank_adaptation adapter(n);
+  adapter.set_num_draws(n_learn);
+  adapter.set_window_params(1000, 0, 0, n_learn, writer);
+
+  Eigen::VectorXd diag(n);
+  Eigen::MatrixXd factor(n, 0);
+  Eigen::MatrixXd draws(n, n_learn);
+  for (int i = 0; i < n_learn; ++i) {
+    for (int j = 0; j < n; ++j)
+      draws(j, i) = rand_gaus();
+    draws.col(i) += rand_gaus() * u;
+    adapter.learn_metric(diag, factor, draws.col(i));
+  }
+  ASSERT_GE(factor.cols(), 1);
+
+  Eigen::MatrixXd centered = draws.colwise() - draws.rowwise().mean();
+  Eigen::VectorXd var = centered.rowwise().squaredNorm() / (n_learn - 1.0);
+  double w = n_learn / (n_learn + 5.0);
+
+  stan::mcmc::lowrank_e_point z(n);
+  z.set_metric(diag, factor);
+  Eigen::VectorXd full_diag = z.mInv_full_diag();
+  for (int i = 0; i < n; ++i)
+    EXPECT_NEAR(w * var(i) + 1e-3 * (1 - w), full_diag(i), 1e-8 * var(i));
+}
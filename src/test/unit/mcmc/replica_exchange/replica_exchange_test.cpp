@@ -0,0 +1,338 @@
+#include <stan/mcmc/replica_exchange/replica_exchange.hpp>
+#include <stan/mcmc/hmc/nuts/diag_e_nuts.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/model/prob_grad.hpp>
+#include <stan/model/tempered_model.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+
+namespace stan {
+  namespace mcmc {
+
+    // Equal mixture of unit normals centred at -5 and 5, whose modes
+    // are separated by a barrier 12.5 units of log density high.
+    class bimodal_model : public model::prob_grad {
+    public:
+      bimodal_model()
+        : model::prob_grad(1) {}
+
+      template <bool propto, bool jacobian_adjust_transforms, typename T>
+      T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+                 std::ostream* output_stream = 0) const {
+        using std::exp;
+        using std::log;
+        T x = params_r(0);
+        T d = x < 0 ? x + 5 : x - 5;
+        T d_other = x < 0 ? x - 5 : x + 5;
+        return -0.5 * d * d
+          + log(1 + exp(-0.5 * d_other * d_other + 0.5 * d * d));
+      }
+    };
+
+    // Standard normal
+    class gauss_model : public model::prob_grad {
+    public:
+      gauss_model()
+        : model::prob_grad(1) {}
+
+      template <bool propto, bool jacobian_adjust_transforms, typename T>
+      T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+                 std::ostream* output_stream = 0) const {
+        return -0.5 * params_r(0) * params_r(0);
+      }
+    };
+
+    typedef model::tempered_model<bimodal_model> tempered_bimodal;
+    typedef diag_e_nuts<tempered_bimodal, rng_t> replica_sampler;
+
+    // Owns a ladder of tempered models and NUTS samplers
+    template <class Model = bimodal_model>
+    class replica_ladder {
+    public:
+      typedef model::tempered_model<Model> tempered_t;
+      typedef diag_e_nuts<tempered_t, rng_t> sampler_t;
+
+      replica_ladder(const Model& model, rng_t& rng, int n) {
+        for (int k = 0; k < n; ++k) {
+          models.push_back(new tempered_t(model));
+          samplers.push_back(new sampler_t(*models.back(), rng));
+          samplers.back()->set_max_depth(10);
+        }
+      }
+
+      ~replica_ladder() {
+        for (size_t k = 0; k < models.size(); ++k) {
+          delete samplers[k];
+          delete models[k];
+        }
+      }
+
+      std::vector<tempered_t*> models;
+      std::vector<sampler_t*> samplers;
+    };
+
+  }
+}
+
+typedef stan::mcmc::replica_exchange<stan::mcmc::bimodal_model,
+                                     stan::mcmc::replica_sampler,
+                                     rng_t> exchange_t;
+
+TEST(McmcReplicaExchange, tempered_model) {
+  stan::mcmc::bimodal_model model;
+  stan::model::tempered_model<stan::mcmc::bimodal_model> tempered(model, 0.25);
+
+  EXPECT_EQ(1U, tempered.num_params_r());
+  EXPECT_EQ(0.25, tempered.get_inverse_temperature());
+
+  Eigen::VectorXd q(1);
+  q << 1.5;
+  double lp = model.log_prob<false, true>(q);
+  double lp_tempered = tempered.log_prob<false, true>(q);
+  EXPECT_FLOAT_EQ(0.25 * lp, lp_tempered);
+
+  tempered.set_inverse_temperature(1);
+  lp_tempered = tempered.log_prob<false, true>(q);
+  EXPECT_FLOAT_EQ(lp, lp_tempered);
+}
+
+TEST(McmcReplicaExchange, geometric_ladder) {
+  rng_t base_rng(0);
+  stan::mcmc::bimodal_model model;
+  stan::mcmc::replica_ladder<> ladder(model, base_rng, 4);
+  exchange_t sampler(ladder.models, ladder.samplers, base_rng, 8);
+
+  EXPECT_EQ(4, sampler.num_replicas());
+  std::vector<double> betas = sampler.get_inverse_temperatures();
+  ASSERT_EQ(4U, betas.size());
+  EXPECT_FLOAT_EQ(1, betas[0]);
+  EXPECT_FLOAT_EQ(0.5, betas[1]);
+  EXPECT_FLOAT_EQ(0.25, betas[2]);
+  EXPECT_FLOAT_EQ(0.125, betas[3]);
+  EXPECT_FLOAT_EQ(0.5, ladder.models[1]->get_inverse_temperature());
+}
+
+TEST(McmcReplicaExchange, invalid_arguments) {
+  rng_t base_rng(0);
+  stan::mcmc::bimodal_model model;
+  stan::mcmc::replica_ladder<> ladder(model, base_rng, 3);
+
+  std::vector<stan::mcmc::replica_sampler*> too_few(ladder.samplers);
+  too_few.pop_back();
+  EXPECT_THROW(exchange_t(ladder.models, too_few, base_rng, 8),
+               std::invalid_argument);
+  EXPECT_THROW(exchange_t(ladder.models, ladder.samplers, base_rng, 0.5),
+               std::invalid_argument);
+
+  std::vector<stan::mcmc::tempered_bimodal*> no_models;
+  std::vector<stan::mcmc::replica_sampler*> no_samplers;
+  EXPECT_THROW(exchange_t(no_models, no_samplers, base_rng, 8),
+               std::invalid_argument);
+}
+
+TEST(McmcReplicaExchange, mixes_between_modes) {
+  rng_t base_rng(3);
+  stan::mcmc::bimodal_model model;
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+
+  Eigen::VectorXd q(1);
+  q << 5;
+
+  // A single chain stays in the mode it starts in
+  stan::mcmc::tempered_bimodal cold_model(model);
+  stan::mcmc::replica_sampler single(cold_model, base_rng);
+  stan::mcmc::sample s(q, 0, 0);
+  int N = 2000;
+  int single_right = 0;
+  for (int n = 0; n < N; ++n) {
+    s = single.transition(s, writer, writer);
+    single_right += s.cont_params()(0) > 0;
+  }
+  EXPECT_EQ(N, single_right);
+
+  stan::mcmc::replica_ladder<> ladder(model, base_rng, 4);
+  exchange_t sampler(ladder.models, ladder.samplers, base_rng, 64);
+
+  s = stan::mcmc::sample(q, 0, 0);
+  double right = 0;
+  double mean_abs = 0;
+  for (int n = 0; n < N; ++n) {
+    s = sampler.transition(s, writer, writer);
+    right += (s.cont_params()(0) > 0) / double(N);
+    mean_abs += std::fabs(s.cont_params()(0)) / N;
+  }
+  EXPECT_NEAR(0.5, right, 0.1);
+  EXPECT_NEAR(5, mean_abs, 0.25);
+
+  // The cold replica's log density is untempered
+  Eigen::VectorXd q_s = s.cont_params();
+  double lp = model.log_prob<false, true>(q_s);
+  EXPECT_FLOAT_EQ(lp, s.log_prob());
+
+  Eigen::VectorXd rates = sampler.get_exchange_rates();
+  ASSERT_EQ(3, rates.size());
+  for (int i = 0; i < rates.size(); ++i) {
+    EXPECT_GT(rates(i), 0.1);
+    EXPECT_LE(rates(i), 1);
+  }
+}
+
+TEST(McmcReplicaExchange, adapts_temperatures) {
+  rng_t base_rng(0);
+  stan::mcmc::gauss_model model;
+  typedef stan::mcmc::replica_ladder<stan::mcmc::gauss_model> gauss_ladder;
+  gauss_ladder ladder(model, base_rng, 4);
+  stan::mcmc::replica_exchange<stan::mcmc::gauss_model,
+                               gauss_ladder::sampler_t, rng_t>
+    sampler(ladder.models, ladder.samplers, base_rng, 64);
+
+  // Start from a ladder whose last gap is far too wide
+  std::vector<double> betas;
+  betas.push_back(1);
+  betas.push_back(0.9);
+  betas.push_back(0.8);
+  betas.push_back(1.0 / 64);
+  sampler.set_inverse_temperatures(betas);
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(1);
+  stan::mcmc::sample s(q, 0, 0);
+
+  for (int n = 0; n < 1000; ++n)
+    s = sampler.transition(s, writer, writer);
+  Eigen::VectorXd rates = sampler.get_exchange_rates();
+  double spread_initial = rates.maxCoeff() - rates.minCoeff();
+
+  sampler.restart();
+  sampler.engage_adaptation();
+  for (int n = 0; n < 3000; ++n)
+    s = sampler.transition(s, writer, writer);
+  sampler.disengage_adaptation();
+
+  // For a normal target equal exchange rates need a geometric ladder
+  betas = sampler.get_inverse_temperatures();
+  EXPECT_FLOAT_EQ(1, betas[0]);
+  EXPECT_NEAR(std::log(0.25), std::log(betas[1]), 0.4);
+  EXPECT_NEAR(std::log(0.0625), std::log(betas[2]), 0.4);
+  EXPECT_FLOAT_EQ(1.0 / 64, betas[3]);
+
+  sampler.restart();
+  for (int n = 0; n < 2000; ++n)
+    s = sampler.transition(s, writer, writer);
+  rates = sampler.get_exchange_rates();
+  double spread_adapted = rates.maxCoeff() - rates.minCoeff();
+
+  EXPECT_GT(spread_initial, 0.5);
+  EXPECT_LT(spread_adapted, 0.1);
+  EXPECT_EQ(betas, sampler.get_inverse_temperatures());
+}
+
+TEST(McmcReplicaExchange, set_inverse_temperatures) {
+  rng_t base_rng(0);
+  stan::mcmc::bimodal_model model;
+  stan::mcmc::replica_ladder<> ladder(model, base_rng, 3);
+  exchange_t sampler(ladder.models, ladder.samplers, base_rng, 4);
+
+  std::vector<double> betas;
+  betas.push_back(1);
+  betas.push_back(0.1);
+  betas.push_back(0.05);
+  sampler.set_inverse_temperatures(betas);
+  std::vector<double> ladder_betas = sampler.get_inverse_temperatures();
+  for (int k = 0; k < 3; ++k) {
+    EXPECT_FLOAT_EQ(betas[k], ladder_betas[k]);
+    EXPECT_FLOAT_EQ(betas[k], ladder.models[k]->get_inverse_temperature());
+  }
+
+  betas[2] = 0.2;
+  EXPECT_THROW(sampler.set_inverse_temperatures(betas),
+               std::invalid_argument);
+  betas[2] = 0.05;
+  betas[0] = 0.5;
+  EXPECT_THROW(sampler.set_inverse_temperatures(betas),
+               std::invalid_argument);
+  betas.pop_back();
+  EXPECT_THROW(sampler.set_inverse_temperatures(betas),
+               std::invalid_argument);
+}
+
+TEST(McmcReplicaExchange, reports_cold_sampler) {
+  rng_t base_rng(0);
+  stan::mcmc::bimodal_model model;
+  stan::mcmc::replica_ladder<> ladder(model, base_rng, 3);
+  exchange_t sampler(ladder.models, ladder.samplers, base_rng, 4);
+
+  std::vector<std::string> names;
+  std::vector<std::string> cold_names;
+  sampler.get_sampler_param_names(names);
+  ladder.samplers[0]->get_sampler_param_names(cold_names);
+  EXPECT_EQ(cold_names, names);
+
+  ladder.samplers[0]->set_nominal_stepsize(0.5);
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+  sampler.write_sampler_state(writer);
+  EXPECT_EQ("Step size = 0.5\n"
+            "Diagonal elements of inverse mass matrix:\n"
+            "1\n"
+            "Inverse temperatures of the replicas:\n"
+            "1, 0.5, 0.25\n", output_stream.str());
+}
+
+TEST(McmcReplicaExchange, save_load_state) {
+  rng_t base_rng(0);
+  stan::mcmc::bimodal_model model;
+  stan::mcmc::replica_ladder<> ladder(model, base_rng, 3);
+  exchange_t sampler(ladder.models, ladder.samplers, base_rng, 100);
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+
+  Eigen::VectorXd q(1);
+  q << 5;
+  stan::mcmc::sample s(q, 0, 0);
+  sampler.engage_adaptation();
+  for (int n = 0; n < 50; ++n)
+    s = sampler.transition(s, writer, writer);
+  sampler.disengage_adaptation();
+
+  std::stringstream state;
+  {
+    stan::io::checkpoint_writer checkpoint(state);
+    sampler.save_state(checkpoint);
+  }
+  rng_t saved_rng = base_rng;
+  stan::mcmc::sample s_loaded(s);
+
+  std::vector<double> draws;
+  for (int n = 0; n < 20; ++n) {
+    s = sampler.transition(s, writer, writer);
+    draws.push_back(s.cont_params()(0));
+  }
+
+  stan::mcmc::replica_ladder<> loaded_ladder(model, saved_rng, 3);
+  exchange_t loaded(loaded_ladder.models, loaded_ladder.samplers,
+                    saved_rng, 100);
+  {
+    stan::io::checkpoint_reader checkpoint(state);
+    loaded.load_state(checkpoint);
+  }
+
+  for (int n = 0; n < 20; ++n) {
+    s_loaded = loaded.transition(s_loaded, writer, writer);
+    EXPECT_FLOAT_EQ(draws[n], s_loaded.cont_params()(0));
+  }
+  EXPECT_EQ("", output_stream.str());
+}
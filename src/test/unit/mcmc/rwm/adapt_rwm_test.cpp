@@ -0,0 +1,77 @@
+#include <stan/mcmc/rwm/adapt_rwm.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/model/prob_grad.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+
+typedef boost::ecuyer1988 rng_t;
+
+namespace stan {
+  namespace mcmc {
+
+    // Correlated normal whose scales differ by two orders of
+    // magnitude, so that a fixed isotropic proposal mixes poorly.
+    class correlated_gauss_model : public model::prob_grad {
+    public:
+      correlated_gauss_model()
+        : model::prob_grad(3), covar_(3, 3) {
+        covar_ << 1, 4, 0,
+                  4, 100, 0,
+                  0, 0, 0.01;
+        precision_ = covar_.inverse();
+      }
+
+      template <bool propto, bool jacobian_adjust_transforms, typename T>
+      T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+                 std::ostream* output_stream = 0) const {
+        return -0.5 * params_r.dot(precision_ * params_r);
+      }
+
+      Eigen::MatrixXd covar_;
+      Eigen::MatrixXd precision_;
+    };
+
+  }
+}
+
+TEST(McmcRwm, adapt_proposal_covariance) {
+  rng_t base_rng(0);
+  stan::mcmc::correlated_gauss_model model;
+  stan::mcmc::adapt_rwm<stan::mcmc::correlated_gauss_model, rng_t>
+    sampler(model, base_rng);
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(3);
+  sampler.seed(q);
+  sampler.get_stepsize_adaptation().set_mu(log(10 * 1.0));
+  sampler.get_stepsize_adaptation().set_gamma(0.05);
+  sampler.get_stepsize_adaptation().set_kappa(0.75);
+  sampler.get_stepsize_adaptation().set_t0(10);
+  sampler.set_window_params(5000, 75, 50, 25, writer);
+  sampler.engage_adaptation();
+  sampler.init_stepsize(writer, error_writer);
+
+  stan::mcmc::sample s(q, 0, 0);
+  for (int n = 0; n < 5000; ++n)
+    s = sampler.transition(s, writer, error_writer);
+  sampler.disengage_adaptation();
+
+  const Eigen::MatrixXd& covar = sampler.get_proposal_covariance();
+  for (int i = 0; i < 3; ++i)
+    EXPECT_NEAR(1, covar(i, i) / model.covar_(i, i), 0.3);
+  EXPECT_NEAR(0.4, covar(0, 1) / std::sqrt(covar(0, 0) * covar(1, 1)), 0.15);
+
+  double accept = 0;
+  for (int n = 0; n < 2000; ++n) {
+    s = sampler.transition(s, writer, error_writer);
+    accept += s.accept_stat() / 2000;
+  }
+  EXPECT_NEAR(0.234, accept, 0.1);
+
+  EXPECT_EQ("", error_stream.str());
+}
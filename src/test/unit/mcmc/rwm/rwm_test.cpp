@@ -0,0 +1,215 @@
+#include <stan/mcmc/rwm/rwm.hpp>
+#include <stan/io/checkpoint.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/model/prob_grad.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+
+namespace stan {
+  namespace mcmc {
+
+    // Independent normals with scales 1, 10 and 0.1 that count how
+    // often their log density is evaluated.
+    class scaled_gauss_model : public model::prob_grad {
+    public:
+      scaled_gauss_model()
+        : model::prob_grad(3), sigma_(3), num_evals_(0) {
+        sigma_ << 1, 10, 0.1;
+      }
+
+      template <bool propto, bool jacobian_adjust_transforms, typename T>
+      T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+                 std::ostream* output_stream = 0) const {
+        ++num_evals_;
+        T lp = 0;
+        for (int i = 0; i < params_r.size(); ++i)
+          lp -= 0.5 * (params_r(i) / sigma_(i)) * (params_r(i) / sigma_(i));
+        return lp;
+      }
+
+      Eigen::VectorXd sigma_;
+      mutable int num_evals_;
+    };
+
+  }
+}
+
+TEST(McmcRwm, transition_evaluates_log_density_once) {
+  rng_t base_rng(0);
+  stan::mcmc::scaled_gauss_model model;
+  stan::mcmc::rwm<stan::mcmc::scaled_gauss_model, rng_t>
+    sampler(model, base_rng);
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+  std::stringstream error_stream;
+  stan::interface_callbacks::writer::stream_writer error_writer(error_stream);
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(3);
+  stan::mcmc::sample s(q, 0, 0);
+
+  // The first transition also evaluates the initial point
+  s = sampler.transition(s, writer, error_writer);
+  EXPECT_EQ(2, model.num_evals_);
+
+  for (int n = 0; n < 10; ++n)
+    s = sampler.transition(s, writer, error_writer);
+  EXPECT_EQ(12, model.num_evals_);
+
+  Eigen::VectorXd q_s = s.cont_params();
+  double lp = model.log_prob<false, true>(q_s);
+  EXPECT_FLOAT_EQ(lp, s.log_prob());
+  EXPECT_GE(s.accept_stat(), 0);
+  EXPECT_LE(s.accept_stat(), 1);
+
+  EXPECT_EQ("", output_stream.str());
+  EXPECT_EQ("", error_stream.str());
+}
+
+TEST(McmcRwm, moments) {
+  rng_t base_rng(4);
+  stan::mcmc::scaled_gauss_model model;
+  stan::mcmc::rwm<stan::mcmc::scaled_gauss_model, rng_t>
+    sampler(model, base_rng);
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+
+  Eigen::VectorXd sigma = model.sigma_;
+  sampler.set_proposal_covariance(
+    sigma.cwiseProduct(sigma).asDiagonal().toDenseMatrix());
+  sampler.set_nominal_stepsize(2.38 / std::sqrt(3.0));
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(3);
+  stan::mcmc::sample s(q, 0, 0);
+
+  int N = 50000;
+  Eigen::VectorXd mean = Eigen::VectorXd::Zero(3);
+  Eigen::VectorXd second = Eigen::VectorXd::Zero(3);
+  double accept = 0;
+  for (int n = 0; n < N; ++n) {
+    s = sampler.transition(s, writer, writer);
+    Eigen::VectorXd z = s.cont_params().cwiseQuotient(sigma);
+    mean += z / N;
+    second += z.cwiseProduct(z) / N;
+    accept += s.accept_stat() / N;
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(0, mean(i), 0.1);
+    EXPECT_NEAR(1, second(i), 0.15);
+  }
+  EXPECT_GT(accept, 0.2);
+  EXPECT_LT(accept, 0.6);
+  EXPECT_EQ("", output_stream.str());
+}
+
+TEST(McmcRwm, set_proposal_covariance) {
+  rng_t base_rng(0);
+  stan::mcmc::scaled_gauss_model model;
+  stan::mcmc::rwm<stan::mcmc::scaled_gauss_model, rng_t>
+    sampler(model, base_rng);
+
+  EXPECT_TRUE(sampler.get_proposal_covariance()
+              == Eigen::MatrixXd::Identity(3, 3));
+
+  Eigen::MatrixXd covar(3, 3);
+  covar << 2, 0.5, 0,
+           0.5, 1, 0,
+           0, 0, 3;
+  sampler.set_proposal_covariance(covar);
+  EXPECT_TRUE(sampler.get_proposal_covariance() == covar);
+
+  Eigen::MatrixXd wrong_size = Eigen::MatrixXd::Identity(2, 2);
+  EXPECT_THROW(sampler.set_proposal_covariance(wrong_size),
+               std::invalid_argument);
+  covar(2, 2) = -1;
+  EXPECT_THROW(sampler.set_proposal_covariance(covar),
+               std::invalid_argument);
+}
+
+TEST(McmcRwm, save_load_state) {
+  rng_t base_rng(0);
+  stan::mcmc::scaled_gauss_model model;
+  stan::mcmc::rwm<stan::mcmc::scaled_gauss_model, rng_t>
+    sampler(model, base_rng);
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+
+  Eigen::MatrixXd covar = Eigen::MatrixXd::Identity(3, 3);
+  covar(1, 1) = 4;
+  sampler.set_proposal_covariance(covar);
+  sampler.set_nominal_stepsize(0.7);
+  sampler.set_stepsize_jitter(0.2);
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(3);
+  stan::mcmc::sample s(q, 0, 0);
+  for (int n = 0; n < 10; ++n)
+    s = sampler.transition(s, writer, writer);
+
+  std::stringstream state;
+  {
+    stan::io::checkpoint_writer checkpoint(state);
+    sampler.save_state(checkpoint);
+  }
+  rng_t saved_rng = base_rng;
+  stan::mcmc::sample s_loaded(s);
+
+  std::vector<Eigen::VectorXd> draws;
+  for (int n = 0; n < 10; ++n) {
+    s = sampler.transition(s, writer, writer);
+    draws.push_back(s.cont_params());
+  }
+
+  stan::mcmc::scaled_gauss_model loaded_model;
+  stan::mcmc::rwm<stan::mcmc::scaled_gauss_model, rng_t>
+    loaded(loaded_model, saved_rng);
+  {
+    stan::io::checkpoint_reader checkpoint(state);
+    loaded.load_state(checkpoint);
+  }
+
+  EXPECT_EQ(0.7, loaded.get_nominal_stepsize());
+  EXPECT_EQ(0.2, loaded.get_stepsize_jitter());
+  EXPECT_TRUE(covar == loaded.get_proposal_covariance());
+
+  // The restored sampler reuses the stored log density and reproduces
+  // the draws of the original one
+  int evals = loaded_model.num_evals_;
+  for (int n = 0; n < 10; ++n) {
+    s_loaded = loaded.transition(s_loaded, writer, writer);
+    for (int i = 0; i < 3; ++i)
+      EXPECT_FLOAT_EQ(draws[n](i), s_loaded.cont_params()(i));
+  }
+  EXPECT_EQ(evals + 10, loaded_model.num_evals_);
+  EXPECT_EQ("", output_stream.str());
+}
+
+TEST(McmcRwm, write_sampler_state) {
+  rng_t base_rng(0);
+  stan::mcmc::scaled_gauss_model model;
+  stan::mcmc::rwm<stan::mcmc::scaled_gauss_model, rng_t>
+    sampler(model, base_rng);
+  sampler.set_nominal_stepsize(0.5);
+
+  std::stringstream output_stream;
+  stan::interface_callbacks::writer::stream_writer writer(output_stream);
+  sampler.write_sampler_state(writer);
+
+  EXPECT_EQ("Step size = 0.5\n"
+            "Elements of proposal covariance:\n"
+            "1, 0, 0\n"
+            "0, 1, 0\n"
+            "0, 0, 1\n", output_stream.str());
+
+  std::vector<std::string> names;
+  sampler.get_sampler_param_names(names);
+  ASSERT_EQ(1U, names.size());
+  EXPECT_EQ("stepsize__", names[0]);
+}
@@ -170,3 +170,21 @@ TEST(McmcStepsizeAdaptation, learn_stepsize_3) {
   EXPECT_NEAR(0.75, adaptation.kappa(), 1e-14);
   EXPECT_NEAR(10, adaptation.t0(), 1e-14);
 }
+
+// Without warmup iterations the step size keeps its initial value
+// rather than becoming exp(0) = 1
+TEST(McmcStepsizeAdaptation, complete_adaptation_without_learning) {
+  stan::mcmc::stepsize_adaptation adaptation;
+
+  double epsilon = 0.3;
+  adaptation.complete_adaptation(epsilon);
+  EXPECT_EQ(0.3, epsilon);
+
+  adaptation.restart();
+  adaptation.complete_adaptation(epsilon);
+  EXPECT_EQ(0.3, epsilon);
+
+  adaptation.learn_stepsize(epsilon, 0.9);
+  adaptation.complete_adaptation(epsilon);
+  EXPECT_NE(0.3, epsilon);
+}
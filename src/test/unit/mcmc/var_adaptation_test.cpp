@@ -1,4 +1,5 @@
 #include <stan/mcmc/var_adaptation.hpp>
+#include <stan/io/checkpoint.hpp>
 #include <stan/interface_callbacks/writer/stream_writer.hpp>
 #include <gtest/gtest.h>
 
@@ -26,3 +27,249 @@ TEST(McmcVarAdaptation, learn_variance) {
 
   EXPECT_EQ("", ss.str());
 }
+
+TEST(McmcVarAdaptation, learn_pooled_variance) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 3;
+  const int n_learn = 10;
+  Eigen::VectorXd var_1(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd var_2(Eigen::VectorXd::Zero(n));
+
+  stan::mcmc::var_adaptation_pool pool(n);
+  stan::mcmc::var_adaptation adapter_1(n);
+  stan::mcmc::var_adaptation adapter_2(n);
+  adapter_1.set_window_params(50, 0, 0, n_learn, writer);
+  adapter_2.set_window_params(50, 0, 0, n_learn, writer);
+  adapter_1.set_pool(&pool);
+  adapter_2.set_pool(&pool);
+  EXPECT_EQ(2, pool.num_chains());
+
+  // Half of the pooled draws are zero and half are one
+  for (int i = 0; i < n_learn; ++i) {
+    EXPECT_FALSE(adapter_1.learn_variance(var_1,
+                                          Eigen::VectorXd::Zero(n)));
+    EXPECT_EQ(i == n_learn - 1,
+              adapter_2.learn_variance(var_2, Eigen::VectorXd::Ones(n)));
+  }
+  EXPECT_TRUE(adapter_1.learn_variance(var_1, Eigen::VectorXd::Zero(n)));
+
+  double num_draws = 2 * n_learn;
+  double target_var = 0.25 * num_draws / (num_draws - 1);
+  target_var = (num_draws / (num_draws + 5.0)) * target_var
+    + 1e-3 * (5.0 / (num_draws + 5.0));
+  for (int i = 0; i < n; ++i) {
+    EXPECT_FLOAT_EQ(target_var, var_1(i));
+    EXPECT_EQ(var_1(i), var_2(i));
+  }
+}
+
+// With no terminal buffer the last window closes at the last warmup
+// iteration, so the first chain has no later call to pick the pooled
+// estimate up in
+TEST(McmcVarAdaptation, pick_up_pooled_variance_after_last_window) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 3;
+  const int num_warmup = 25;
+  const int init_buffer = 15;
+  Eigen::VectorXd var_1(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd var_2(Eigen::VectorXd::Zero(n));
+
+  stan::mcmc::var_adaptation_pool pool(n);
+  stan::mcmc::var_adaptation adapter_1(n);
+  stan::mcmc::var_adaptation adapter_2(n);
+  adapter_1.set_window_params(num_warmup, init_buffer, 0,
+                              num_warmup - init_buffer, writer);
+  adapter_2.set_window_params(num_warmup, init_buffer, 0,
+                              num_warmup - init_buffer, writer);
+  adapter_1.set_pool(&pool);
+  adapter_2.set_pool(&pool);
+
+  for (int i = 0; i < num_warmup; ++i) {
+    adapter_1.learn_variance(var_1, Eigen::VectorXd::Zero(n));
+    adapter_2.learn_variance(var_2, Eigen::VectorXd::Ones(n));
+  }
+  EXPECT_FALSE(adapter_2.pick_up_pooled_variance(var_2));
+
+  EXPECT_TRUE(adapter_1.pick_up_pooled_variance(var_1));
+  for (int i = 0; i < n; ++i)
+    EXPECT_EQ(var_2(i), var_1(i));
+  EXPECT_FALSE(adapter_1.pick_up_pooled_variance(var_1));
+  EXPECT_EQ("", ss.str());
+}
+
+TEST(McmcVarAdaptation, pick_up_pooled_variance_without_pool) {
+  const int n = 3;
+  Eigen::VectorXd var(Eigen::VectorXd::Zero(n));
+  stan::mcmc::var_adaptation adapter(n);
+  EXPECT_FALSE(adapter.pick_up_pooled_variance(var));
+  EXPECT_EQ(0, var.sum());
+}
+
+TEST(McmcVarAdaptation, learn_pooled_variance_requires_lockstep) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 3;
+  Eigen::VectorXd var(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd q(Eigen::VectorXd::Zero(n));
+
+  stan::mcmc::var_adaptation_pool pool(n);
+  stan::mcmc::var_adaptation adapter_1(n);
+  stan::mcmc::var_adaptation adapter_2(n);
+  adapter_1.set_window_params(50, 0, 0, 10, writer);
+  adapter_2.set_window_params(50, 0, 0, 10, writer);
+  adapter_1.set_pool(&pool);
+  adapter_2.set_pool(&pool);
+
+  for (int i = 0; i < 10; ++i)
+    adapter_1.learn_variance(var, q);
+  EXPECT_THROW(adapter_1.learn_variance(var, q), std::logic_error);
+}
+
+TEST(McmcVarAdaptation, resume_pooled_variance) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 3;
+  const int n_learn = 10;
+  Eigen::VectorXd var_1(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd var_2(Eigen::VectorXd::Zero(n));
+
+  stan::mcmc::var_adaptation_pool pool(n);
+  stan::mcmc::var_adaptation adapter_1(n);
+  stan::mcmc::var_adaptation adapter_2(n);
+  adapter_1.set_window_params(50, 0, 0, n_learn, writer);
+  adapter_2.set_window_params(50, 0, 0, n_learn, writer);
+  adapter_1.set_pool(&pool);
+  adapter_2.set_pool(&pool);
+
+  // The first chain has closed its window and waits for the second
+  for (int i = 0; i < n_learn; ++i) {
+    adapter_1.learn_variance(var_1, Eigen::VectorXd::Zero(n));
+    if (i < n_learn - 1)
+      adapter_2.learn_variance(var_2, Eigen::VectorXd::Ones(n));
+  }
+
+  std::stringstream state;
+  {
+    stan::io::checkpoint_writer checkpoint(state);
+    pool.save_state(checkpoint);
+    adapter_1.save_state(checkpoint);
+    adapter_2.save_state(checkpoint);
+  }
+
+  stan::mcmc::var_adaptation_pool resumed_pool(n);
+  stan::mcmc::var_adaptation resumed_1(n);
+  stan::mcmc::var_adaptation resumed_2(n);
+  resumed_1.set_pool(&resumed_pool);
+  resumed_2.set_pool(&resumed_pool);
+  stan::io::checkpoint_reader checkpoint(state);
+  resumed_pool.load_state(checkpoint);
+  resumed_1.load_state(checkpoint);
+  resumed_2.load_state(checkpoint);
+
+  // The waiting chain must not add draws before the pooled update
+  EXPECT_THROW(resumed_1.learn_variance(var_1, Eigen::VectorXd::Zero(n)),
+               std::logic_error);
+
+  Eigen::VectorXd resumed_var_1(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd resumed_var_2(Eigen::VectorXd::Zero(n));
+  EXPECT_EQ(adapter_2.learn_variance(var_2, Eigen::VectorXd::Ones(n)),
+            resumed_2.learn_variance(resumed_var_2,
+                                     Eigen::VectorXd::Ones(n)));
+  EXPECT_EQ(pool.generation(), resumed_pool.generation());
+  for (int i = 0; i < n; ++i)
+    EXPECT_EQ(var_2(i), resumed_var_2(i));
+}
+
+TEST(McmcVarAdaptation, adaptive_schedule_ends_early) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 2;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd var(Eigen::VectorXd::Ones(n));
+
+  // Windows end at iterations 20, 40 and 90 of 100
+  stan::mcmc::var_adaptation adapter(n);
+  adapter.set_window_params(100, 10, 10, 10, writer);
+  adapter.set_adaptive_schedule(0.1, 200);
+  EXPECT_TRUE(adapter.adaptive_schedule());
+
+  int num_windows = 0;
+  int m = 0;
+  for (; !adapter.schedule_complete(); ++m) {
+    if (adapter.learn_variance(var, q)) {
+      ++num_windows;
+      adapter.adapt_schedule(num_windows == 1 ? 1 : 0.01, 0.01, writer);
+    }
+  }
+
+  EXPECT_EQ(2, num_windows);
+  EXPECT_EQ(50, m);
+  EXPECT_EQ(50U, adapter.get_num_warmup());
+  EXPECT_NE(std::string::npos,
+            ss.str().find("Warmup shortened to 50 iterations"));
+}
+
+TEST(McmcVarAdaptation, adaptive_schedule_extends) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  const int n = 2;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd var(Eigen::VectorXd::Ones(n));
+
+  stan::mcmc::var_adaptation adapter(n);
+  adapter.set_window_params(100, 10, 10, 10, writer);
+  adapter.set_adaptive_schedule(0.1, 150);
+
+  // The metric never settles, so windows of 40 and then 10 iterations
+  // are added until warmup reaches the maximum
+  int num_windows = 0;
+  int m = 0;
+  for (; !adapter.schedule_complete() && m < 1000; ++m) {
+    if (adapter.learn_variance(var, q)) {
+      ++num_windows;
+      adapter.adapt_schedule(1, 1, writer);
+    }
+  }
+
+  EXPECT_EQ(150, m);
+  EXPECT_EQ(150U, adapter.get_num_warmup());
+  EXPECT_EQ(5, num_windows);
+  EXPECT_NE(std::string::npos,
+            ss.str().find("Warmup extended to 150 iterations"));
+}
+
+TEST(McmcVarAdaptation, fixed_schedule) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  stan::mcmc::var_adaptation adapter(2);
+  adapter.set_window_params(100, 10, 10, 10, writer);
+  adapter.adapt_schedule(0, 0, writer);
+
+  EXPECT_FALSE(adapter.adaptive_schedule());
+  EXPECT_FALSE(adapter.schedule_complete());
+  EXPECT_EQ(100U, adapter.get_num_warmup());
+  EXPECT_EQ("", ss.str());
+}
+
+TEST(McmcVarAdaptation, adaptive_schedule_without_windows) {
+  std::stringstream ss;
+  stan::interface_callbacks::writer::stream_writer writer(ss);
+
+  // Too few warmup iterations for any window, so there is no schedule
+  // to adapt
+  stan::mcmc::var_adaptation adapter(2);
+  adapter.set_window_params(10, 1, 1, 5, writer);
+  adapter.set_adaptive_schedule(0.1, 200);
+
+  EXPECT_FALSE(adapter.adaptive_schedule());
+  EXPECT_FALSE(adapter.schedule_complete());
+}
@@ -0,0 +1,69 @@
+#include <stan/mcmc/welford_checkpoint.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+TEST(McmcWelfordCheckpoint, var_estimator) {
+  std::stringstream ss;
+
+  stan::math::welford_var_estimator estimator(2);
+  Eigen::VectorXd q(2);
+  for (int n = 0; n < 5; ++n) {
+    q << n, n * n;
+    estimator.add_sample(q);
+  }
+
+  stan::io::checkpoint_writer writer(ss);
+  stan::mcmc::write_estimator(writer, estimator);
+
+  stan::math::welford_var_estimator restored(2);
+  stan::io::checkpoint_reader reader(ss);
+  stan::mcmc::read_estimator(reader, restored);
+
+  EXPECT_EQ(5, restored.num_samples());
+  Eigen::VectorXd expected(2);
+  Eigen::VectorXd var(2);
+  estimator.sample_variance(expected);
+  restored.sample_variance(var);
+  for (int i = 0; i < 2; ++i)
+    EXPECT_FLOAT_EQ(expected(i), var(i));
+}
+
+TEST(McmcWelfordCheckpoint, covar_estimator) {
+  std::stringstream ss;
+
+  stan::math::welford_covar_estimator estimator(2);
+  Eigen::VectorXd q(2);
+  for (int n = 0; n < 5; ++n) {
+    q << n, -2 * n + (n % 2);
+    estimator.add_sample(q);
+  }
+
+  stan::io::checkpoint_writer writer(ss);
+  stan::mcmc::write_estimator(writer, estimator);
+
+  stan::math::welford_covar_estimator restored(2);
+  stan::io::checkpoint_reader reader(ss);
+  stan::mcmc::read_estimator(reader, restored);
+
+  EXPECT_EQ(5, restored.num_samples());
+  Eigen::MatrixXd expected(2, 2);
+  Eigen::MatrixXd covar(2, 2);
+  estimator.sample_covariance(expected);
+  restored.sample_covariance(covar);
+  for (int i = 0; i < 4; ++i)
+    EXPECT_FLOAT_EQ(expected(i), covar(i));
+}
+
+TEST(McmcWelfordCheckpoint, size_mismatch) {
+  std::stringstream ss;
+
+  stan::math::welford_var_estimator estimator(2);
+  stan::io::checkpoint_writer writer(ss);
+  stan::mcmc::write_estimator(writer, estimator);
+
+  stan::math::welford_var_estimator restored(3);
+  stan::io::checkpoint_reader reader(ss);
+  EXPECT_THROW(stan::mcmc::read_estimator(reader, restored),
+               std::runtime_error);
+}
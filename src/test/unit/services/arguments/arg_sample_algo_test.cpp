@@ -0,0 +1,14 @@
+#include <gtest/gtest.h>
+#include <stan/services/arguments/arg_sample_algo.hpp>
+
+TEST(StanServicesArguments, arg_sample_algo) {
+  stan::services::arg_sample_algo arg;
+
+  EXPECT_EQ("algorithm", arg.name());
+  EXPECT_EQ("Sampling algorithm", arg.description());
+
+  ASSERT_EQ(3U, arg.values().size());
+  EXPECT_EQ("hmc", arg.values()[0]->name());
+  EXPECT_EQ("rwm", arg.values()[1]->name());
+  EXPECT_EQ("fixed_param", arg.values()[2]->name());
+}
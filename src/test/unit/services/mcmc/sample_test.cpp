@@ -132,3 +132,46 @@ TEST_F(StanServices, sample) {
   EXPECT_EQ("", error_output.str());
 }
 
+
+TEST_F(StanServices, sample_multiple_chains) {
+  int num_warmup = 30;
+  int num_samples = 50;
+  int num_thin = 2;
+  int refresh = 0;
+  bool save = false;
+  std::string prefix = "";
+  std::string suffix = "\n";
+  std::stringstream ss;
+  mock_callback callback;
+
+  mock_sampler other_sampler;
+  std::vector<stan::mcmc::base_mcmc*> samplers;
+  samplers.push_back(sampler);
+  samplers.push_back(&other_sampler);
+  std::vector<stan::services::sample::mcmc_writer<stan_model,
+                                                  writer_t,
+                                                  writer_t,
+                                                  writer_t>*>
+    writers(2, writer);
+  std::vector<stan::mcmc::sample> samples(2,
+                                          stan::mcmc::sample(q, log_prob,
+                                                             stat));
+  rng_t other_rng;
+  std::vector<rng_t*> rngs;
+  rngs.push_back(&base_rng);
+  rngs.push_back(&other_rng);
+
+  stan::services::mcmc::sample(samplers,
+                               num_warmup, num_samples,
+                               num_thin, refresh, save,
+                               writers, samples, *model, rngs,
+                               prefix, suffix, ss,
+                               callback,
+                               message_writer,
+                               error_writer);
+
+  EXPECT_EQ(num_samples, sampler->n_transition_called);
+  EXPECT_EQ(num_samples, other_sampler.n_transition_called);
+  EXPECT_EQ(num_samples, callback.n);
+  EXPECT_EQ("", ss.str());
+}
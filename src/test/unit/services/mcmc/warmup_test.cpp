@@ -24,6 +24,35 @@ public:
   int n_transition_called;
 };
 
+// Reports that its adaptation is complete after a fixed number of
+// transitions
+class mock_adapting_sampler : public stan::mcmc::base_mcmc,
+                              public stan::mcmc::base_adapter {
+public:
+  explicit mock_adapting_sampler(int num_adapt, unsigned int max_warmup = 0)
+    : base_mcmc(), num_adapt(num_adapt), max_warmup(max_warmup),
+      n_transition_called(0) { }
+
+  stan::mcmc::sample transition(stan::mcmc::sample& init_sample,
+                                stan::interface_callbacks::writer::base_writer& info_writer,
+                                stan::interface_callbacks::writer::base_writer& error_writer) {
+    n_transition_called++;
+    return init_sample;
+  }
+
+  bool adaptation_complete() {
+    return n_transition_called >= num_adapt;
+  }
+
+  unsigned int max_num_warmup() {
+    return max_warmup;
+  }
+
+  int num_adapt;
+  unsigned int max_warmup;
+  int n_transition_called;
+};
+
 struct mock_callback {
   int n;
   mock_callback() : n(0) { }
@@ -132,3 +161,102 @@ TEST_F(StanServices, warmup) {
 }
 
 
+
+TEST_F(StanServices, adaptive_warmup) {
+  stan::mcmc::sample s(q, log_prob, stat);
+  std::stringstream ss;
+  mock_callback callback;
+
+  mock_adapting_sampler adapting_sampler(12);
+  int num_run = stan::services::mcmc::adaptive_warmup(&adapting_sampler,
+                                                      30, 50, 1, 0, false,
+                                                      *writer, s, *model,
+                                                      base_rng, "", "\n", ss,
+                                                      callback,
+                                                      message_writer,
+                                                      error_writer);
+  EXPECT_EQ(12, num_run);
+  EXPECT_EQ(12, adapting_sampler.n_transition_called);
+  EXPECT_EQ(12, callback.n);
+
+  // A sampler without an adaptive schedule runs every iteration
+  num_run = stan::services::mcmc::adaptive_warmup(sampler,
+                                                  30, 50, 1, 0, false,
+                                                  *writer, s, *model,
+                                                  base_rng, "", "\n", ss,
+                                                  callback,
+                                                  message_writer,
+                                                  error_writer);
+  EXPECT_EQ(30, num_run);
+  EXPECT_EQ(30, sampler->n_transition_called);
+  EXPECT_EQ("", message_output.str());
+}
+
+TEST_F(StanServices, warmup_follows_adaptive_schedule) {
+  stan::mcmc::sample s(q, log_prob, stat);
+  std::stringstream ss;
+  mock_callback callback;
+
+  // A shortened schedule ends warmup early
+  mock_adapting_sampler shortened(12, 60);
+  shortened.engage_adaptation();
+  int num_run
+    = stan::services::mcmc::warmup(&shortened, 30, 50, 1, 0, false,
+                                   *writer, s, *model, base_rng, "", "\n",
+                                   ss, callback, message_writer, error_writer);
+  EXPECT_EQ(12, num_run);
+  EXPECT_EQ(12, shortened.n_transition_called);
+
+  // An extended schedule runs past num_warmup until it completes
+  mock_adapting_sampler extended(45, 60);
+  extended.engage_adaptation();
+  num_run
+    = stan::services::mcmc::warmup(&extended, 30, 50, 1, 0, false,
+                                   *writer, s, *model, base_rng, "", "\n",
+                                   ss, callback, message_writer, error_writer);
+  EXPECT_EQ(45, num_run);
+  EXPECT_EQ(45, extended.n_transition_called);
+
+  // Without adaptation the fixed number of iterations is run
+  mock_adapting_sampler not_adapting(12, 60);
+  num_run
+    = stan::services::mcmc::warmup(&not_adapting, 30, 50, 1, 0, false,
+                                   *writer, s, *model, base_rng, "", "\n",
+                                   ss, callback, message_writer, error_writer);
+  EXPECT_EQ(30, num_run);
+  EXPECT_EQ(30, not_adapting.n_transition_called);
+  EXPECT_EQ(12 + 45 + 30, callback.n);
+}
+
+TEST_F(StanServices, multi_chain_warmup_follows_adaptive_schedule) {
+  std::stringstream ss;
+  mock_callback callback;
+
+  mock_adapting_sampler shortened(12, 60);
+  shortened.engage_adaptation();
+  mock_adapting_sampler extended(45, 60);
+  extended.engage_adaptation();
+  std::vector<stan::mcmc::base_mcmc*> samplers;
+  samplers.push_back(&shortened);
+  samplers.push_back(&extended);
+  samplers.push_back(sampler);
+
+  std::vector<stan::services::sample::mcmc_writer<stan_model, writer_t,
+                                                  writer_t, writer_t>*>
+    writers(3, writer);
+  std::vector<stan::mcmc::sample> s(3, stan::mcmc::sample(q, log_prob, stat));
+  std::vector<rng_t*> rngs(3, &base_rng);
+
+  std::vector<int> num_run
+    = stan::services::mcmc::warmup(samplers, 30, 50, 1, 0, false,
+                                   writers, s, *model, rngs, "", "\n", ss,
+                                   callback, message_writer, error_writer);
+  ASSERT_EQ(3U, num_run.size());
+  EXPECT_EQ(12, num_run[0]);
+  EXPECT_EQ(45, num_run[1]);
+  EXPECT_EQ(30, num_run[2]);
+  EXPECT_EQ(12, shortened.n_transition_called);
+  EXPECT_EQ(45, extended.n_transition_called);
+  EXPECT_EQ(30, sampler->n_transition_called);
+  EXPECT_EQ(45, callback.n);
+}
@@ -0,0 +1,118 @@
+#include <stan/services/sample/checkpoint.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/diag_e_nuts.hpp>
+#include <stan/mcmc/hmc/static/adapt_diag_e_static_hmc.hpp>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+typedef stan::mcmc::adapt_diag_e_nuts<stan_model, rng_t> sampler_t;
+
+class ServicesSampleCheckpoint : public testing::Test {
+public:
+  ServicesSampleCheckpoint()
+    : writer(output), error_writer(error) {}
+
+  void SetUp() {
+    std::fstream empty_data_stream(std::string("").c_str());
+    stan::io::dump empty_data_context(empty_data_stream);
+    empty_data_stream.close();
+    model = new stan_model(empty_data_context, &output);
+  }
+
+  void TearDown() {
+    delete model;
+  }
+
+  void configure(sampler_t& sampler) {
+    sampler.set_nominal_stepsize(1);
+    sampler.set_stepsize_jitter(0.1);
+    sampler.set_max_depth(5);
+    sampler.get_stepsize_adaptation().set_mu(std::log(10.0));
+    sampler.get_stepsize_adaptation().set_delta(0.8);
+    sampler.set_window_params(100, 15, 10, 25, writer);
+    sampler.engage_adaptation();
+  }
+
+  std::vector<stan::mcmc::sample> run(sampler_t& sampler,
+                                      stan::mcmc::sample& s,
+                                      int num_iterations) {
+    std::vector<stan::mcmc::sample> samples;
+    for (int m = 0; m < num_iterations; ++m) {
+      s = sampler.transition(s, writer, error_writer);
+      samples.push_back(s);
+    }
+    return samples;
+  }
+
+  std::stringstream output;
+  std::stringstream error;
+  stan::interface_callbacks::writer::stream_writer writer;
+  stan::interface_callbacks::writer::stream_writer error_writer;
+  stan_model* model;
+};
+
+TEST_F(ServicesSampleCheckpoint, resume_matches_uninterrupted_run) {
+  rng_t rng(123);
+  sampler_t sampler(*model, rng);
+  configure(sampler);
+
+  Eigen::VectorXd q(2);
+  q << 1.5, -0.5;
+  stan::mcmc::sample s(q, 0, 0);
+  sampler.z().q = q;
+  sampler.init_stepsize(writer, error_writer);
+
+  run(sampler, s, 30);
+
+  std::stringstream checkpoint;
+  stan::services::sample::write_checkpoint(checkpoint, sampler, s, rng);
+
+  std::vector<stan::mcmc::sample> expected = run(sampler, s, 40);
+
+  rng_t resumed_rng(0);
+  sampler_t resumed(*model, resumed_rng);
+  stan::mcmc::sample resumed_s(Eigen::VectorXd::Zero(2), 0, 0);
+  stan::services::sample::read_checkpoint(checkpoint, resumed, resumed_s,
+                                          resumed_rng);
+
+  std::vector<stan::mcmc::sample> found = run(resumed, resumed_s, 40);
+
+  ASSERT_EQ(expected.size(), found.size());
+  for (size_t m = 0; m < expected.size(); ++m) {
+    for (int d = 0; d < 2; ++d)
+      EXPECT_EQ(expected[m].cont_params(d), found[m].cont_params(d));
+    EXPECT_EQ(expected[m].log_prob(), found[m].log_prob());
+    EXPECT_EQ(expected[m].accept_stat(), found[m].accept_stat());
+  }
+  EXPECT_EQ(sampler.get_nominal_stepsize(), resumed.get_nominal_stepsize());
+  for (int d = 0; d < 2; ++d)
+    EXPECT_EQ(sampler.z().mInv(d), resumed.z().mInv(d));
+}
+
+TEST_F(ServicesSampleCheckpoint, wrong_sampler) {
+  rng_t rng(123);
+  sampler_t sampler(*model, rng);
+  configure(sampler);
+  stan::mcmc::sample s(Eigen::VectorXd::Zero(2), 0, 0);
+
+  std::stringstream checkpoint;
+  stan::services::sample::write_checkpoint(checkpoint, sampler, s, rng);
+
+  stan::mcmc::adapt_diag_e_static_hmc<stan_model, rng_t> other(*model, rng);
+  EXPECT_THROW(stan::services::sample::read_checkpoint(checkpoint, other,
+                                                       s, rng),
+               std::runtime_error);
+
+  checkpoint.clear();
+  checkpoint.seekg(0);
+  stan::mcmc::diag_e_nuts<stan_model, rng_t> unadapted(*model, rng);
+  EXPECT_THROW(stan::services::sample::read_checkpoint(checkpoint, unadapted,
+                                                       s, rng),
+               std::runtime_error);
+}
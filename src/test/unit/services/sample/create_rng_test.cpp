@@ -0,0 +1,34 @@
+#include <stan/services/sample/create_rng.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+
+typedef boost::ecuyer1988 rng_t;
+
+TEST(StanServicesSample, create_rng_reproducible) {
+  rng_t rng1 = stan::services::sample::create_rng<rng_t>(123, 2);
+  rng_t rng2 = stan::services::sample::create_rng<rng_t>(123, 2);
+
+  for (int n = 0; n < 10; ++n)
+    EXPECT_EQ(rng1(), rng2());
+}
+
+TEST(StanServicesSample, create_rng_independent_chains) {
+  rng_t rng1 = stan::services::sample::create_rng<rng_t>(123, 1);
+  rng_t rng2 = stan::services::sample::create_rng<rng_t>(123, 2);
+
+  int num_equal = 0;
+  for (int n = 0; n < 10; ++n)
+    if (rng1() == rng2())
+      ++num_equal;
+  EXPECT_LT(num_equal, 10);
+}
+
+TEST(StanServicesSample, seed_chain_rng) {
+  rng_t rng1 = stan::services::sample::create_rng<rng_t>(123, 0);
+  rng_t rng2;
+  rng2.seed(123);
+  EXPECT_EQ(rng1, rng2);
+
+  stan::services::sample::seed_chain_rng(rng2, 123, 3);
+  EXPECT_EQ(stan::services::sample::create_rng<rng_t>(123, 3), rng2);
+}
@@ -0,0 +1,135 @@
+#include <stan/services/sample/fork_chains.hpp>
+#include <stan/services/sample/create_rng.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/diag_e_nuts.hpp>
+#include <stan/mcmc/hmc/static/diag_e_static_hmc.hpp>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+typedef stan::mcmc::adapt_diag_e_nuts<stan_model, rng_t> warmup_sampler_t;
+typedef stan::mcmc::diag_e_nuts<stan_model, rng_t> chain_sampler_t;
+
+class ServicesSampleForkChains : public testing::Test {
+public:
+  ServicesSampleForkChains()
+    : writer(output), error_writer(error) {}
+
+  void SetUp() {
+    std::fstream empty_data_stream(std::string("").c_str());
+    stan::io::dump empty_data_context(empty_data_stream);
+    empty_data_stream.close();
+    model = new stan_model(empty_data_context, &output);
+  }
+
+  void TearDown() {
+    delete model;
+  }
+
+  // Runs a short warmup and leaves the sample it finished at in s
+  void warmup(warmup_sampler_t& sampler, stan::mcmc::sample& s) {
+    sampler.set_nominal_stepsize(1);
+    sampler.set_max_depth(5);
+    sampler.get_stepsize_adaptation().set_mu(std::log(10.0));
+    sampler.get_stepsize_adaptation().set_delta(0.8);
+    sampler.set_window_params(100, 15, 10, 25, writer);
+    sampler.engage_adaptation();
+    sampler.z().q = s.cont_params();
+    sampler.init_stepsize(writer, error_writer);
+
+    for (int m = 0; m < 100; ++m)
+      s = sampler.transition(s, writer, error_writer);
+    sampler.disengage_adaptation();
+  }
+
+  std::stringstream output;
+  std::stringstream error;
+  stan::interface_callbacks::writer::stream_writer writer;
+  stan::interface_callbacks::writer::stream_writer error_writer;
+  stan_model* model;
+};
+
+TEST_F(ServicesSampleForkChains, chains_share_adaptation) {
+  rng_t warmup_rng = stan::services::sample::create_rng<rng_t>(123, 0);
+  warmup_sampler_t warmed(*model, warmup_rng);
+  Eigen::VectorXd q(2);
+  q << 1.5, -0.5;
+  stan::mcmc::sample s(q, 0, 0);
+  warmup(warmed, s);
+
+  std::vector<rng_t> rngs;
+  for (int n = 0; n < 3; ++n)
+    rngs.push_back(stan::services::sample::create_rng<rng_t>(123, n + 1));
+  std::vector<chain_sampler_t*> owned;
+  std::vector<stan::mcmc::base_mcmc*> chains;
+  for (int n = 0; n < 3; ++n) {
+    owned.push_back(new chain_sampler_t(*model, rngs[n]));
+    chains.push_back(owned.back());
+  }
+
+  std::vector<stan::mcmc::sample> init_s;
+  stan::services::sample::fork_chains(warmed, s, chains, init_s);
+
+  ASSERT_EQ(3U, init_s.size());
+  for (int n = 0; n < 3; ++n) {
+    EXPECT_EQ(warmed.get_nominal_stepsize(),
+              owned[n]->get_nominal_stepsize());
+    EXPECT_EQ(warmed.get_max_depth(), owned[n]->get_max_depth());
+    for (int d = 0; d < 2; ++d) {
+      EXPECT_EQ(warmed.z().mInv(d), owned[n]->z().mInv(d));
+      EXPECT_EQ(warmed.z().q(d), owned[n]->z().q(d));
+      EXPECT_EQ(s.cont_params(d), init_s[n].cont_params(d));
+    }
+  }
+
+  for (int m = 0; m < 5; ++m)
+    for (int n = 0; n < 3; ++n)
+      init_s[n] = owned[n]->transition(init_s[n], writer, error_writer);
+  EXPECT_NE(init_s[0].cont_params(0), init_s[1].cont_params(0));
+  EXPECT_NE(init_s[1].cont_params(0), init_s[2].cont_params(0));
+  EXPECT_EQ("", error.str());
+
+  for (int n = 0; n < 3; ++n)
+    delete owned[n];
+}
+
+TEST_F(ServicesSampleForkChains, chain_continues_warmed_sampler) {
+  rng_t warmup_rng(123);
+  warmup_sampler_t warmed(*model, warmup_rng);
+  Eigen::VectorXd q(2);
+  q << 1.5, -0.5;
+  stan::mcmc::sample s(q, 0, 0);
+  warmup(warmed, s);
+
+  rng_t chain_rng = warmup_rng;
+  chain_sampler_t chain(*model, chain_rng);
+  std::vector<stan::mcmc::base_mcmc*> chains(1, &chain);
+  std::vector<stan::mcmc::sample> init_s;
+  stan::services::sample::fork_chains(warmed, s, chains, init_s);
+
+  stan::mcmc::sample expected = s;
+  for (int m = 0; m < 20; ++m) {
+    expected = warmed.transition(expected, writer, error_writer);
+    init_s[0] = chain.transition(init_s[0], writer, error_writer);
+    for (int d = 0; d < 2; ++d)
+      EXPECT_EQ(expected.cont_params(d), init_s[0].cont_params(d));
+    EXPECT_EQ(expected.accept_stat(), init_s[0].accept_stat());
+  }
+}
+
+TEST_F(ServicesSampleForkChains, wrong_sampler) {
+  rng_t rng(123);
+  warmup_sampler_t warmed(*model, rng);
+  stan::mcmc::sample s(Eigen::VectorXd::Zero(2), 0, 0);
+
+  stan::mcmc::diag_e_static_hmc<stan_model, rng_t> other(*model, rng);
+  std::vector<stan::mcmc::base_mcmc*> chains(1, &other);
+  std::vector<stan::mcmc::sample> init_s;
+  EXPECT_THROW(stan::services::sample::fork_chains(warmed, s, chains, init_s),
+               std::runtime_error);
+}
@@ -4,7 +4,12 @@
 #include <stan/interface_callbacks/writer/base_writer.hpp>
 #include <stan/interface_callbacks/writer/stream_writer.hpp>
 #include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <algorithm>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 
 typedef boost::ecuyer1988 rng_t;
 typedef stan::interface_callbacks::writer::stream_writer writer_t;
@@ -25,6 +30,28 @@ public:
   int n_transition_called;
 };
 
+// Draws independent standard normal samples
+class iid_sampler : public stan::mcmc::base_mcmc {
+public:
+  explicit iid_sampler(unsigned int seed)
+    : base_mcmc(), rng(seed), n_transition_called(0) { }
+
+  stan::mcmc::sample transition(stan::mcmc::sample& init_sample,
+                                stan::interface_callbacks::writer::base_writer& info_writer,
+                                stan::interface_callbacks::writer::base_writer& error_writer) {
+    boost::variate_generator<rng_t&, boost::normal_distribution<> >
+      rand_gaus(rng, boost::normal_distribution<>());
+    Eigen::VectorXd q(init_sample.cont_params().size());
+    for (int i = 0; i < q.size(); ++i)
+      q(i) = rand_gaus();
+    n_transition_called++;
+    return stan::mcmc::sample(q, 0, 1);
+  }
+
+  rng_t rng;
+  int n_transition_called;
+};
+
 struct mock_callback {
   int n;
   mock_callback() : n(0) { }
@@ -135,3 +162,357 @@ TEST_F(StanServices, generate_transitions) {
   EXPECT_EQ("", error_output.str());
 }
 
+
+TEST_F(StanServices, generate_transitions_multiple_chains) {
+  typedef stan::services::sample::mcmc_writer<stan_model, writer_t,
+                                              writer_t, writer_t>
+    mcmc_writer_t;
+  const int num_chains = 3;
+
+  int num_iterations = 10;
+  int start = 0;
+  int finish = 10;
+  int num_thin = 2;
+  int refresh = 0;
+  bool save = true;
+  bool warmup = false;
+  std::string prefix = "";
+  std::string suffix = "\n";
+  std::stringstream ss;
+  mock_callback callback;
+
+  std::vector<mock_sampler> mock_samplers(num_chains);
+  std::vector<stan::mcmc::base_mcmc*> samplers;
+  std::vector<std::stringstream*> outputs;
+  std::vector<writer_t*> sample_writers;
+  std::vector<mcmc_writer_t*> writers;
+  std::vector<stan::mcmc::sample> samples;
+  std::vector<rng_t> rngs(num_chains);
+  std::vector<rng_t*> rng_ptrs;
+
+  Eigen::VectorXd q0(2);
+  q0 << 1, 2;
+  for (int k = 0; k < num_chains; ++k) {
+    samplers.push_back(&mock_samplers[k]);
+    outputs.push_back(new std::stringstream());
+    sample_writers.push_back(new writer_t(*outputs[k]));
+    writers.push_back(new mcmc_writer_t(*sample_writers[k],
+                                        *sample_writers[k],
+                                        message_writer));
+    samples.push_back(stan::mcmc::sample(q0, log_prob, stat));
+    rng_ptrs.push_back(&rngs[k]);
+  }
+
+  stan::services::sample::generate_transitions(samplers,
+                                               num_iterations, start, finish,
+                                               num_thin, refresh, save, warmup,
+                                               writers, samples, *model,
+                                               rng_ptrs,
+                                               prefix, suffix, ss,
+                                               callback,
+                                               message_writer,
+                                               error_writer);
+
+  EXPECT_EQ(num_iterations, callback.n);
+  EXPECT_EQ("", ss.str());
+  for (int k = 0; k < num_chains; ++k) {
+    EXPECT_EQ(num_iterations, mock_samplers[k].n_transition_called);
+    std::string line;
+    int num_lines = 0;
+    while (std::getline(*outputs[k], line))
+      ++num_lines;
+    // Each saved iteration writes one sample row and one diagnostic row
+    EXPECT_EQ(2 * num_iterations / num_thin, num_lines);
+    delete writers[k];
+    delete sample_writers[k];
+    delete outputs[k];
+  }
+}
+
+TEST_F(StanServices, generate_transitions_multiple_chains_size_mismatch) {
+  std::vector<stan::mcmc::base_mcmc*> samplers(2, sampler);
+  std::vector<stan::services::sample::mcmc_writer<stan_model, writer_t,
+                                                  writer_t, writer_t>*>
+    writers(1, writer);
+  std::vector<stan::mcmc::sample> samples(2,
+                                          stan::mcmc::sample(q, log_prob,
+                                                             stat));
+  std::vector<rng_t*> rngs(2, &base_rng);
+  std::stringstream ss;
+  mock_callback callback;
+
+  EXPECT_THROW(stan::services::sample::generate_transitions(samplers,
+                                                            1, 0, 1, 1, 0,
+                                                            false, false,
+                                                            writers, samples,
+                                                            *model, rngs,
+                                                            "", "", ss,
+                                                            callback,
+                                                            message_writer,
+                                                            error_writer),
+               std::invalid_argument);
+  EXPECT_EQ(0, sampler->n_transition_called);
+}
+
+TEST_F(StanServices, generate_transitions_until_converged) {
+  typedef stan::services::sample::mcmc_writer<stan_model, writer_t,
+                                              writer_t, writer_t>
+    mcmc_writer_t;
+  const int num_chains = 4;
+  const int num_iterations = 1000;
+  std::stringstream ss;
+  mock_callback callback;
+
+  std::vector<iid_sampler*> iid_samplers;
+  std::vector<stan::mcmc::base_mcmc*> samplers;
+  std::vector<mcmc_writer_t*> writers(num_chains, writer);
+  std::vector<stan::mcmc::sample> samples;
+  std::vector<rng_t> rngs(num_chains);
+  std::vector<rng_t*> rng_ptrs;
+  for (int k = 0; k < num_chains; ++k) {
+    iid_samplers.push_back(new iid_sampler(k + 1));
+    samplers.push_back(iid_samplers[k]);
+    samples.push_back(stan::mcmc::sample(Eigen::VectorXd::Zero(2),
+                                         log_prob, stat));
+    rng_ptrs.push_back(&rngs[k]);
+  }
+
+  stan::mcmc::convergence_monitor monitor(num_chains, 2, 400, 1.05);
+  int num_run
+    = stan::services::sample::generate_transitions_until_converged(
+      samplers, num_iterations, 0, num_iterations, 1, 0, false, 50, monitor,
+      writers, samples, *model, rng_ptrs, "", "\n", ss, callback,
+      message_writer, error_writer);
+
+  EXPECT_LT(num_run, num_iterations);
+  EXPECT_EQ(0, num_run % 50);
+  EXPECT_EQ(num_run, callback.n);
+  EXPECT_EQ(num_run, monitor.num_draws());
+  for (int k = 0; k < num_chains; ++k) {
+    EXPECT_EQ(num_run, iid_samplers[k]->n_transition_called);
+    delete iid_samplers[k];
+  }
+  EXPECT_NE(std::string::npos, message_output.str().find("Converged after"));
+  EXPECT_EQ("", error_output.str());
+}
+
+TEST_F(StanServices, generate_transitions_until_converged_runs_to_end) {
+  typedef stan::services::sample::mcmc_writer<stan_model, writer_t,
+                                              writer_t, writer_t>
+    mcmc_writer_t;
+  const int num_chains = 2;
+  const int num_iterations = 100;
+  std::stringstream ss;
+  mock_callback callback;
+
+  // The mock sampler never moves, so the draws never converge
+  std::vector<mock_sampler> mock_samplers(num_chains);
+  std::vector<stan::mcmc::base_mcmc*> samplers;
+  std::vector<mcmc_writer_t*> writers(num_chains, writer);
+  std::vector<stan::mcmc::sample> samples(num_chains,
+    stan::mcmc::sample(Eigen::VectorXd::Zero(2), log_prob, stat));
+  std::vector<rng_t> rngs(num_chains);
+  std::vector<rng_t*> rng_ptrs;
+  for (int k = 0; k < num_chains; ++k) {
+    samplers.push_back(&mock_samplers[k]);
+    rng_ptrs.push_back(&rngs[k]);
+  }
+
+  stan::mcmc::convergence_monitor monitor(num_chains, 2, 10, 1.05);
+  int num_run
+    = stan::services::sample::generate_transitions_until_converged(
+      samplers, num_iterations, 0, num_iterations, 1, 0, false, 10, monitor,
+      writers, samples, *model, rng_ptrs, "", "\n", ss, callback,
+      message_writer, error_writer);
+
+  EXPECT_EQ(num_iterations, num_run);
+  EXPECT_EQ(num_iterations, mock_samplers[0].n_transition_called);
+  EXPECT_EQ("", message_output.str());
+
+  stan::mcmc::convergence_monitor wrong_monitor(num_chains + 1, 2, 10, 1.05);
+  EXPECT_THROW(stan::services::sample::generate_transitions_until_converged(
+                 samplers, num_iterations, 0, num_iterations, 1, 0, false, 10,
+                 wrong_monitor, writers, samples, *model, rng_ptrs, "", "\n",
+                 ss, callback, message_writer, error_writer),
+               std::invalid_argument);
+  EXPECT_EQ(num_iterations, mock_samplers[0].n_transition_called);
+}
+
+struct interrupt_callback {
+  int n;
+  int interrupt_at;
+  explicit interrupt_callback(int k) : n(0), interrupt_at(k) { }
+
+  void operator()() {
+    if (n == interrupt_at)
+      throw std::domain_error("interrupted");
+    n++;
+  }
+};
+
+// Records the number of rows in each block it is handed
+class block_counting_writer : public writer_t {
+public:
+  explicit block_counting_writer(std::ostream& output)
+    : writer_t(output) { }
+
+  using writer_t::operator();
+
+  void operator()(const double* values, int n_rows, int n_cols) {
+    block_rows.push_back(n_rows);
+    writer_t::operator()(values, n_rows, n_cols);
+  }
+
+  std::vector<int> block_rows;
+};
+
+TEST_F(StanServices, generate_transitions_in_blocks) {
+  typedef stan::services::sample::mcmc_writer<stan_model, writer_t,
+                                              writer_t, writer_t>
+    mcmc_writer_t;
+  typedef stan::services::sample::mcmc_writer<stan_model,
+                                              block_counting_writer,
+                                              block_counting_writer,
+                                              writer_t>
+    blocked_writer_t;
+  std::stringstream ss;
+  mock_callback callback;
+
+  std::stringstream direct_output;
+  writer_t direct_writer(direct_output);
+  mcmc_writer_t direct(direct_writer, direct_writer, message_writer);
+  iid_sampler direct_sampler(1);
+  rng_t direct_rng(1);
+  stan::mcmc::sample s(Eigen::VectorXd::Zero(2), log_prob, stat);
+  stan::services::sample::generate_transitions(&direct_sampler,
+                                               25, 0, 25, 2, 0, true, false,
+                                               direct, s, *model, direct_rng,
+                                               "", "", ss, callback,
+                                               message_writer, error_writer);
+
+  std::stringstream blocked_output;
+  block_counting_writer sample_writer(blocked_output);
+  block_counting_writer diagnostic_writer(blocked_output);
+  blocked_writer_t blocked(sample_writer, diagnostic_writer,
+                           message_writer, 4);
+  iid_sampler blocked_sampler(1);
+  rng_t blocked_rng(1);
+  s = stan::mcmc::sample(Eigen::VectorXd::Zero(2), log_prob, stat);
+  stan::services::sample::generate_transitions(&blocked_sampler,
+                                               25, 0, 25, 2, 0, true, false,
+                                               blocked, s, *model,
+                                               blocked_rng,
+                                               "", "", ss, callback,
+                                               message_writer, error_writer);
+
+  // The sample rows and diagnostic rows are interleaved a block at a
+  // time instead of a row at a time
+  std::string direct_rows = direct_output.str();
+  std::string blocked_rows = blocked_output.str();
+  EXPECT_EQ(26, std::count(blocked_rows.begin(), blocked_rows.end(), '\n'));
+  std::vector<std::string> direct_lines;
+  std::vector<std::string> blocked_lines;
+  std::stringstream direct_stream(direct_rows);
+  std::stringstream blocked_stream(blocked_rows);
+  std::string line;
+  while (std::getline(direct_stream, line))
+    direct_lines.push_back(line);
+  while (std::getline(blocked_stream, line))
+    blocked_lines.push_back(line);
+  std::sort(direct_lines.begin(), direct_lines.end());
+  std::sort(blocked_lines.begin(), blocked_lines.end());
+  EXPECT_TRUE(direct_lines == blocked_lines);
+
+  ASSERT_EQ(4U, sample_writer.block_rows.size());
+  EXPECT_EQ(4, sample_writer.block_rows[0]);
+  EXPECT_EQ(4, sample_writer.block_rows[2]);
+  EXPECT_EQ(1, sample_writer.block_rows[3]);
+  EXPECT_TRUE(sample_writer.block_rows == diagnostic_writer.block_rows);
+}
+
+TEST_F(StanServices, generate_transitions_in_blocks_flushes_on_interrupt) {
+  typedef stan::services::sample::mcmc_writer<stan_model, writer_t,
+                                              writer_t, writer_t>
+    mcmc_writer_t;
+  std::stringstream ss;
+  interrupt_callback callback(7);
+
+  std::stringstream sample_output;
+  std::stringstream diagnostic_output;
+  writer_t sample_writer(sample_output);
+  writer_t diagnostic_writer(diagnostic_output);
+  mcmc_writer_t writer(sample_writer, diagnostic_writer, message_writer,
+                       100);
+
+  iid_sampler sampler(1);
+  stan::mcmc::sample s(Eigen::VectorXd::Zero(2), log_prob, stat);
+  EXPECT_THROW(stan::services::sample::generate_transitions(&sampler,
+                                                            20, 0, 20, 1, 0,
+                                                            true, false,
+                                                            writer, s,
+                                                            *model, base_rng,
+                                                            "", "", ss,
+                                                            callback,
+                                                            message_writer,
+                                                            error_writer),
+               std::domain_error);
+
+  std::string rows = sample_output.str();
+  EXPECT_EQ(7, std::count(rows.begin(), rows.end(), '\n'));
+  rows = diagnostic_output.str();
+  EXPECT_EQ(7, std::count(rows.begin(), rows.end(), '\n'));
+}
+
+// Written before writers took blocks of rows: overrides the per-row
+// overload only, which hides the overload for blocks
+class row_counting_writer : public writer_t {
+public:
+  explicit row_counting_writer(std::ostream& output)
+    : writer_t(output), num_rows(0) { }
+
+  void operator()(const std::vector<double>& state) {
+    ++num_rows;
+    writer_t::operator()(state);
+  }
+
+  int num_rows;
+};
+
+TEST_F(StanServices, generate_transitions_with_row_writer) {
+  typedef stan::services::sample::mcmc_writer<stan_model,
+                                              row_counting_writer,
+                                              row_counting_writer,
+                                              writer_t>
+    mcmc_writer_t;
+  std::stringstream ss;
+  mock_callback callback;
+
+  std::stringstream output;
+  row_counting_writer sample_writer(output);
+  row_counting_writer diagnostic_writer(output);
+  mcmc_writer_t writer(sample_writer, diagnostic_writer, message_writer);
+  iid_sampler sampler(1);
+  stan::mcmc::sample s(Eigen::VectorXd::Zero(2), log_prob, stat);
+  stan::services::sample::generate_transitions(&sampler,
+                                               10, 0, 10, 1, 0, true, false,
+                                               writer, s, *model, base_rng,
+                                               "", "", ss, callback,
+                                               message_writer, error_writer);
+  EXPECT_EQ(10, sample_writer.num_rows);
+  EXPECT_EQ(10, diagnostic_writer.num_rows);
+
+  // Blocks reach the writer through base_writer, so the writer still
+  // compiles and receives every row
+  std::stringstream blocked_output;
+  row_counting_writer blocked_sample_writer(blocked_output);
+  row_counting_writer blocked_diagnostic_writer(blocked_output);
+  mcmc_writer_t blocked(blocked_sample_writer, blocked_diagnostic_writer,
+                        message_writer, 4);
+  stan::services::sample::generate_transitions(&sampler,
+                                               10, 0, 10, 1, 0, true, false,
+                                               blocked, s, *model, base_rng,
+                                               "", "", ss, callback,
+                                               message_writer, error_writer);
+  std::string rows = blocked_output.str();
+  EXPECT_EQ(20, std::count(rows.begin(), rows.end(), '\n'));
+}
@@ -0,0 +1,34 @@
+#include <stan/services/sample/init_rwm.hpp>
+#include <stan/services/arguments/arg_sample_algo.hpp>
+#include <stan/interface_callbacks/writer/noop_writer.hpp>
+#include <stan/mcmc/rwm/rwm.hpp>
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+typedef stan::mcmc::rwm<stan::mcmc::mock_model, rng_t> sampler_t;
+
+TEST(StanServicesSample, init_rwm) {
+  stan::services::arg_sample_algo algorithm;
+  stan::interface_callbacks::writer::noop_writer writer;
+
+  // Arguments are consumed from the back
+  std::vector<std::string> args;
+  args.push_back("stepsize_jitter=0.25");
+  args.push_back("stepsize=0.5");
+  args.push_back("algorithm=rwm");
+  bool help_flag = false;
+  EXPECT_TRUE(algorithm.parse_args(args, writer, writer, help_flag));
+
+  rng_t base_rng(0);
+  stan::mcmc::mock_model model(3);
+  sampler_t sampler(model, base_rng);
+
+  EXPECT_TRUE(stan::services::sample::init_rwm<sampler_t>(&sampler,
+                                                          &algorithm));
+  EXPECT_EQ(0.5, sampler.get_nominal_stepsize());
+  EXPECT_EQ(0.25, sampler.get_stepsize_jitter());
+}
@@ -0,0 +1,127 @@
+#include <stan/services/sample/init_warm_start.hpp>
+#include <stan/services/sample/init_adapt.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/dense_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/unit_e_nuts.hpp>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+
+typedef boost::ecuyer1988 rng_t;
+
+class ServicesSampleInitWarmStart : public testing::Test {
+public:
+  ServicesSampleInitWarmStart()
+    : rng(0), writer(output), error_writer(error) {}
+
+  void SetUp() {
+    std::fstream empty_data_stream(std::string("").c_str());
+    stan::io::dump empty_data_context(empty_data_stream);
+    empty_data_stream.close();
+    model = new stan_model(empty_data_context, &output);
+  }
+
+  void TearDown() {
+    delete model;
+  }
+
+  rng_t rng;
+  std::stringstream output;
+  std::stringstream error;
+  stan::interface_callbacks::writer::stream_writer writer;
+  stan::interface_callbacks::writer::stream_writer error_writer;
+  stan_model* model;
+};
+
+TEST_F(ServicesSampleInitWarmStart, diag_e_from_csv) {
+  typedef stan::mcmc::adapt_diag_e_nuts<stan_model, rng_t> sampler_t;
+  sampler_t sampler(*model, rng);
+
+  std::stringstream csv("# Adaptation terminated\n"
+                        "# Step size = 0.25\n"
+                        "# Diagonal elements of inverse mass matrix:\n"
+                        "# 1.5, 2\n");
+  stan::io::stan_csv_adaptation adaptation;
+  ASSERT_TRUE(stan::io::stan_csv_reader::read_adaptation(csv, adaptation, 0));
+
+  EXPECT_TRUE(stan::services::sample::init_warm_start<sampler_t>
+              (&sampler, adaptation, error_writer));
+  EXPECT_EQ(0.25, sampler.get_nominal_stepsize());
+  EXPECT_EQ(1.5, sampler.z().mInv(0));
+  EXPECT_EQ(2, sampler.z().mInv(1));
+
+  // Warmup continues from the loaded step size
+  EXPECT_TRUE(stan::services::sample::init_adapt<sampler_t>
+              (&sampler, 0.8, 0.05, 0.75, 10, Eigen::VectorXd::Zero(2),
+               writer, error_writer, false));
+  EXPECT_EQ(0.25, sampler.get_nominal_stepsize());
+  EXPECT_FLOAT_EQ(std::log(2.5), sampler.get_stepsize_adaptation().get_mu());
+
+  // and with no warmup iterations the step size is kept
+  sampler.disengage_adaptation();
+  EXPECT_EQ(0.25, sampler.get_nominal_stepsize());
+
+  EXPECT_EQ("", error.str());
+}
+
+TEST_F(ServicesSampleInitWarmStart, dense_e_round_trip) {
+  typedef stan::mcmc::dense_e_nuts<stan_model, rng_t> sampler_t;
+  sampler_t sampler(*model, rng);
+  sampler.set_nominal_stepsize(0.7);
+  Eigen::MatrixXd metric(2, 2);
+  metric << 2, 0.5, 0.5, 1;
+  sampler.z().set_mInv(metric);
+
+  stan::io::stan_csv_adaptation adaptation;
+  stan::services::sample::get_adaptation<sampler_t>(&sampler, adaptation);
+
+  std::stringstream binary;
+  stan::services::sample::write_adaptation(binary, adaptation);
+  stan::io::stan_csv_adaptation loaded;
+  stan::services::sample::read_adaptation(binary, loaded);
+
+  sampler_t warm(*model, rng);
+  EXPECT_TRUE(stan::services::sample::init_warm_start<sampler_t>
+              (&warm, loaded, error_writer));
+  EXPECT_EQ(0.7, warm.get_nominal_stepsize());
+  for (int n = 0; n < 4; ++n)
+    EXPECT_EQ(sampler.z().mInv()(n), warm.z().mInv()(n));
+
+  Eigen::MatrixXd mInv = warm.z().mInv_L() * warm.z().mInv_L().transpose();
+  for (int n = 0; n < 4; ++n)
+    EXPECT_FLOAT_EQ(sampler.z().mInv()(n), mInv(n));
+
+  EXPECT_EQ("", error.str());
+}
+
+TEST_F(ServicesSampleInitWarmStart, mismatched_adaptation) {
+  typedef stan::mcmc::dense_e_nuts<stan_model, rng_t> dense_t;
+  typedef stan::mcmc::unit_e_nuts<stan_model, rng_t> unit_t;
+  dense_t dense(*model, rng);
+  unit_t unit(*model, rng);
+
+  stan::io::stan_csv_adaptation adaptation;
+  adaptation.step_size = 0.5;
+  adaptation.metric = Eigen::MatrixXd::Ones(3, 3);
+  EXPECT_FALSE(stan::services::sample::init_warm_start<dense_t>
+               (&dense, adaptation, error_writer));
+
+  adaptation.metric = Eigen::MatrixXd::Ones(2, 2);
+  EXPECT_FALSE(stan::services::sample::init_warm_start<dense_t>
+               (&dense, adaptation, error_writer));
+  EXPECT_FALSE(stan::services::sample::init_warm_start<unit_t>
+               (&unit, adaptation, error_writer));
+
+  adaptation.metric.resize(0, 0);
+  EXPECT_TRUE(stan::services::sample::init_warm_start<unit_t>
+              (&unit, adaptation, error_writer));
+  EXPECT_EQ(0.5, unit.get_nominal_stepsize());
+
+  adaptation.step_size = 0;
+  EXPECT_FALSE(stan::services::sample::init_warm_start<unit_t>
+               (&unit, adaptation, error_writer));
+
+  EXPECT_NE("", error.str());
+}
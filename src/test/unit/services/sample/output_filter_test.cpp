@@ -0,0 +1,168 @@
+#include <stan/services/sample/output_filter.hpp>
+#include <stan/services/sample/mcmc_writer.hpp>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <stan/interface_callbacks/writer/stream_writer.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+typedef stan::interface_callbacks::writer::stream_writer writer_t;
+
+class no_params_sampler : public stan::mcmc::base_mcmc {
+public:
+  stan::mcmc::sample
+  transition(stan::mcmc::sample& init_sample,
+             stan::interface_callbacks::writer::base_writer& info_writer,
+             stan::interface_callbacks::writer::base_writer& error_writer) {
+    return init_sample;
+  }
+};
+
+class ServicesSampleOutputFilter : public testing::Test {
+public:
+  ServicesSampleOutputFilter()
+    : rng(0) {
+    std::fstream empty_data_stream(std::string("").c_str());
+    stan::io::dump empty_data_context(empty_data_stream);
+    model = new stan_model(empty_data_context);
+
+    model->constrained_param_names(names, true, true);
+  }
+
+  ~ServicesSampleOutputFilter() {
+    delete model;
+  }
+
+  std::vector<std::string> selected_names(const std::vector<std::string>&
+                                          patterns) {
+    stan::services::sample::output_filter filter(patterns, *model);
+    std::vector<std::string> selected;
+    filter.append(names, selected);
+    return selected;
+  }
+
+  stan_model* model;
+  std::vector<std::string> names;
+  rng_t rng;
+};
+
+TEST_F(ServicesSampleOutputFilter, selects_everything_by_default) {
+  stan::services::sample::output_filter filter;
+  EXPECT_TRUE(filter.include_tparams());
+  EXPECT_TRUE(filter.include_gqs());
+
+  std::vector<std::string> selected;
+  filter.append(names, selected);
+  EXPECT_TRUE(names == selected);
+
+  EXPECT_TRUE(names == selected_names(std::vector<std::string>()));
+}
+
+TEST_F(ServicesSampleOutputFilter, patterns) {
+  std::vector<std::string> patterns;
+  patterns.push_back("z");
+  std::vector<std::string> selected = selected_names(patterns);
+  ASSERT_EQ(2U, selected.size());
+  EXPECT_EQ("z.1", selected[0]);
+  EXPECT_EQ("z.2", selected[1]);
+
+  patterns[0] = "y[2]";
+  selected = selected_names(patterns);
+  ASSERT_EQ(1U, selected.size());
+  EXPECT_EQ("y.2", selected[0]);
+
+  patterns[0] = "*.1";
+  selected = selected_names(patterns);
+  ASSERT_EQ(2U, selected.size());
+  EXPECT_EQ("y.1", selected[0]);
+  EXPECT_EQ("z.1", selected[1]);
+
+  // Names are written in the model's order, once each
+  patterns[0] = "xgq";
+  patterns.push_back("y");
+  patterns.push_back("y.1");
+  selected = selected_names(patterns);
+  ASSERT_EQ(3U, selected.size());
+  EXPECT_EQ("y.1", selected[0]);
+  EXPECT_EQ("y.2", selected[1]);
+  EXPECT_EQ("xgq", selected[2]);
+}
+
+TEST_F(ServicesSampleOutputFilter, blocks) {
+  std::vector<std::string> patterns(1, "y");
+  stan::services::sample::output_filter params(patterns, *model);
+  EXPECT_FALSE(params.include_tparams());
+  EXPECT_FALSE(params.include_gqs());
+
+  patterns[0] = "z.2";
+  stan::services::sample::output_filter tparams(patterns, *model);
+  EXPECT_TRUE(tparams.include_tparams());
+  EXPECT_FALSE(tparams.include_gqs());
+
+  patterns[0] = "xgq";
+  stan::services::sample::output_filter gqs(patterns, *model);
+  EXPECT_TRUE(gqs.include_tparams());
+  EXPECT_TRUE(gqs.include_gqs());
+}
+
+TEST_F(ServicesSampleOutputFilter, values) {
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(2);
+  Eigen::VectorXd all_values;
+  model->write_array(rng, q, all_values, true, true, 0);
+
+  std::vector<std::string> patterns(1, "z.2");
+  stan::services::sample::output_filter filter(patterns, *model);
+  Eigen::VectorXd values;
+  model->write_array(rng, q, values, filter.include_tparams(),
+                     filter.include_gqs(), 0);
+
+  std::vector<double> selected(1, -1.0);
+  filter.append(values, selected);
+  ASSERT_EQ(2U, selected.size());
+  EXPECT_FLOAT_EQ(-1, selected[0]);
+  EXPECT_FLOAT_EQ(all_values(3), selected[1]);
+}
+
+TEST_F(ServicesSampleOutputFilter, no_match) {
+  std::vector<std::string> patterns;
+  patterns.push_back("y");
+  patterns.push_back("theta");
+  EXPECT_THROW(stan::services::sample::output_filter(patterns, *model),
+               std::invalid_argument);
+}
+
+TEST_F(ServicesSampleOutputFilter, mcmc_writer) {
+  std::stringstream sample_output;
+  std::stringstream message_output;
+  writer_t sample_writer(sample_output);
+  writer_t message_writer(message_output);
+  stan::services::sample::mcmc_writer<stan_model, writer_t, writer_t,
+                                      writer_t>
+    writer(sample_writer, message_writer, message_writer);
+
+  std::vector<std::string> patterns;
+  patterns.push_back("xgq");
+  patterns.push_back("y[1]");
+  writer.set_output_filter(stan::services::sample::output_filter(patterns,
+                                                                 *model));
+
+  no_params_sampler sampler;
+  stan::mcmc::sample s(Eigen::VectorXd::Zero(2), -1.5, 0.25);
+  writer.write_sample_names(s, &sampler, *model);
+  writer.write_sample_params(rng, s, sampler, *model);
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(2);
+  Eigen::VectorXd values;
+  model->write_array(rng, q, values, true, true, 0);
+  std::stringstream expected;
+  expected << "lp__,accept_stat__,y.1,xgq\n"
+           << -1.5 << "," << 0.25 << "," << values(0) << ","
+           << values(4) << "\n";
+  EXPECT_EQ(expected.str(), sample_output.str());
+  EXPECT_EQ("", message_output.str());
+}
@@ -0,0 +1,33 @@
+#include <stan/services/sample/pool_stepsize.hpp>
+#include <stan/mcmc/hmc/nuts/diag_e_nuts.hpp>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+typedef stan::mcmc::diag_e_nuts<stan_model, rng_t> sampler_t;
+
+TEST(ServicesSample, pool_stepsize) {
+  std::stringstream output;
+  std::fstream empty_data_stream(std::string("").c_str());
+  stan::io::dump empty_data_context(empty_data_stream);
+  empty_data_stream.close();
+  stan_model model(empty_data_context, &output);
+
+  rng_t rng(0);
+  sampler_t sampler_1(model, rng);
+  sampler_t sampler_2(model, rng);
+  sampler_1.set_nominal_stepsize(0.1);
+  sampler_2.set_nominal_stepsize(0.4);
+
+  std::vector<stan::mcmc::base_mcmc*> chains;
+  chains.push_back(&sampler_1);
+  chains.push_back(&sampler_2);
+  stan::services::sample::pool_stepsize<sampler_t>(chains);
+
+  EXPECT_FLOAT_EQ(0.2, sampler_1.get_nominal_stepsize());
+  EXPECT_FLOAT_EQ(0.2, sampler_2.get_nominal_stepsize());
+}